@@ -0,0 +1,120 @@
+#ifndef AFINA_BENCH_UTILS_H
+#define AFINA_BENCH_UTILS_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Afina {
+namespace Bench {
+
+/**
+ * Cheap per-thread pseudo random generator, avoids touching any shared state on the hot path
+ */
+class XorShift {
+public:
+    XorShift(uint64_t seed) : _state(seed * 0x9E3779B97F4A7C15ull + 1) {}
+
+    uint64_t next() {
+        _state ^= _state << 13;
+        _state ^= _state >> 7;
+        _state ^= _state << 17;
+        return _state;
+    }
+
+private:
+    uint64_t _state;
+};
+
+/**
+ * Zipf distributed numbers in range [0, n), 0 is the most popular one. Uses precomputed CDF, so
+ * sampling costs one binary search
+ */
+class Zipf {
+public:
+    Zipf(size_t n, double skew) : _cdf(n) {
+        double sum = 0;
+        for (size_t i = 0; i < n; i++) {
+            sum += 1.0 / std::pow(double(i + 1), skew);
+            _cdf[i] = sum;
+        }
+        for (auto &c : _cdf) {
+            c /= sum;
+        }
+    }
+
+    size_t next(XorShift &rnd) const {
+        double u = double(rnd.next() >> 11) / double(1ull << 53);
+        size_t result = std::lower_bound(_cdf.begin(), _cdf.end(), u) - _cdf.begin();
+        return std::min(result, _cdf.size() - 1);
+    }
+
+private:
+    std::vector<double> _cdf;
+};
+
+/**
+ * Builds key of a fixed length for the given number
+ */
+inline std::string make_key(uint64_t n, size_t length = 16) {
+    std::string result = "key:" + std::to_string(n);
+    result.resize(length, '_');
+    return result;
+}
+
+/**
+ * Runs given function in n_threads threads, each gets its own thread index. All threads start at the
+ * same moment. Returns number of seconds between start and the moment when the last thread finished
+ */
+inline double run_threads(size_t n_threads, std::function<void(size_t)> func) {
+    std::atomic<size_t> ready(0);
+    std::atomic<bool> go(false);
+
+    std::vector<std::thread> threads;
+    threads.reserve(n_threads);
+    for (size_t i = 0; i < n_threads; i++) {
+        threads.emplace_back([&, i]() {
+            ready++;
+            while (!go.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            func(i);
+        });
+    }
+
+    while (ready.load() != n_threads) {
+        std::this_thread::yield();
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    go.store(true, std::memory_order_release);
+    for (auto &t : threads) {
+        t.join();
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+/**
+ * Thread counts to run scaling benchmark on: 1, 2, 4, ... up to max_threads
+ */
+inline std::vector<size_t> thread_steps(size_t max_threads) {
+    std::vector<size_t> result;
+    for (size_t n = 1; n < max_threads; n *= 2) {
+        result.push_back(n);
+    }
+    result.push_back(max_threads);
+    return result;
+}
+
+} // namespace Bench
+} // namespace Afina
+
+#endif // AFINA_BENCH_UTILS_H
@@ -0,0 +1,89 @@
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <afina/Storage.h>
+#include <afina/ValueView.h>
+#include <afina/execute/Get.h>
+
+#include "storage/SimpleLRU.h"
+
+#include "BenchUtils.h"
+
+using namespace Afina;
+using namespace Afina::Bench;
+
+/**
+ * Forwards reads to the wrapped storage, but hides precomputed response lines, so that Get formats
+ * them on every hit as it did before items carried them
+ */
+class NoHeaders : public Storage {
+public:
+    NoHeaders(Storage &storage) : _storage(storage) {}
+
+    bool Put(const std::string &key, const std::string &value) override { return _storage.Put(key, value); }
+    bool PutIfAbsent(const std::string &key, const std::string &value) override {
+        return _storage.PutIfAbsent(key, value);
+    }
+    bool Set(const std::string &key, const std::string &value) override { return _storage.Set(key, value); }
+    bool Delete(const std::string &key) override { return _storage.Delete(key); }
+    bool Get(const std::string &key, std::string &value) override { return _storage.Get(key, value); }
+
+    void MultiGetWithInfo(const std::vector<std::string> &keys, std::vector<ValueView> &values,
+                          std::vector<ValueInfo> &infos) override {
+        _storage.MultiGetWithInfo(keys, values, infos);
+        for (auto &info : infos) {
+            info.header = nullptr;
+        }
+    }
+
+private:
+    Storage &_storage;
+};
+
+/**
+ * # Small value get benchmark
+ * Serves single key get commands for small values the way network layer does, through
+ * Get::ExecuteVectored, with response lines formatted on every hit and taken from the items.
+ *
+ * Usage: benchGetResponse [value_size] [requests]
+ */
+int main(int argc, char **argv) {
+    size_t value_size = 8;
+    if (argc > 1) {
+        value_size = std::strtoul(argv[1], nullptr, 10);
+    }
+    size_t requests = 5000000;
+    if (argc > 2) {
+        requests = std::strtoul(argv[2], nullptr, 10);
+    }
+
+    const size_t n_keys = 10000;
+    const size_t key_size = 16;
+    Backend::SimpleLRU storage(2 * n_keys * (key_size + value_size));
+    for (size_t i = 0; i < n_keys; i++) {
+        storage.PutWithTTL(make_key(i, key_size), std::string(value_size, 'v'), 0, uint32_t(i));
+    }
+    NoHeaders formatted(storage);
+
+    std::vector<Execute::Get> commands;
+    for (size_t i = 0; i < n_keys; i++) {
+        commands.emplace_back(std::vector<std::string>{make_key(i, key_size)});
+    }
+
+    std::printf("%-12s %14s\n", "header", "Mreq/sec");
+    for (bool cached : {false, true}) {
+        Storage &target = cached ? static_cast<Storage &>(storage) : formatted;
+        double seconds = run_threads(1, [&](size_t) {
+            XorShift rnd(1);
+            std::vector<ValueView> response;
+            for (size_t r = 0; r < requests; r++) {
+                response.clear();
+                commands[rnd.next() % n_keys].ExecuteVectored(target, "", response);
+            }
+        });
+        std::printf("%-12s %14.3f\n", cached ? "cached" : "formatted", requests / seconds / 1e6);
+    }
+    return 0;
+}
@@ -0,0 +1,75 @@
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <afina/Storage.h>
+
+#include "storage/ClockLRU.h"
+#include "storage/SimpleLRU.h"
+
+#include "BenchUtils.h"
+
+using namespace Afina;
+using namespace Afina::Bench;
+
+/**
+ * # Hit ratio benchmark
+ * Replays synthetic zipf distributed workload over single threaded storages: each request is Get, on
+ * miss the key is Put into the cache. Reports hit ratio for a few cache sizes
+ *
+ * Usage: benchHitRatio [n_requests] [skew]
+ */
+int main(int argc, char **argv) {
+    size_t n_requests = 2000000;
+    if (argc > 1) {
+        n_requests = std::strtoul(argv[1], nullptr, 10);
+    }
+    double skew = 0.99;
+    if (argc > 2) {
+        skew = std::strtod(argv[2], nullptr);
+    }
+
+    const size_t n_keys = 1000000;
+    const size_t key_size = 16, value_size = 48;
+    const std::string value(value_size, 'v');
+
+    // Same trace for every storage and cache size
+    std::vector<uint32_t> trace(n_requests);
+    {
+        Zipf zipf(n_keys, skew);
+        XorShift rnd(42);
+        for (auto &t : trace) {
+            t = zipf.next(rnd);
+        }
+    }
+
+    std::vector<std::pair<std::string, std::function<std::shared_ptr<Storage>(size_t)>>> storages = {
+        {"st_lru", [](size_t size) { return std::make_shared<Backend::SimpleLRU>(size); }},
+        {"st_clock", [](size_t size) { return std::make_shared<Backend::ClockLRU>(size); }},
+    };
+
+    std::printf("%-16s %12s %10s\n", "storage", "cache keys", "hit ratio");
+    for (double fraction : {0.001, 0.01, 0.1}) {
+        size_t cache_keys = n_keys * fraction;
+        for (auto &s : storages) {
+            std::shared_ptr<Storage> storage = s.second(cache_keys * (key_size + value_size));
+
+            size_t hits = 0;
+            std::string out;
+            for (uint32_t k : trace) {
+                std::string key = make_key(k, key_size);
+                if (storage->Get(key, out)) {
+                    hits++;
+                } else {
+                    storage->Put(key, value);
+                }
+            }
+            std::printf("%-16s %12zu %10.4f\n", s.first.c_str(), cache_keys, double(hits) / trace.size());
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,95 @@
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <afina/Storage.h>
+
+#include "storage/CompactLRU.h"
+#include "storage/SimpleLRU.h"
+#include "storage/SlabLRU.h"
+
+#include "BenchUtils.h"
+
+using namespace Afina;
+using namespace Afina::Bench;
+
+// Resident memory of the process in bytes
+static size_t resident() {
+    size_t size = 0, pages = 0;
+    FILE *f = std::fopen("/proc/self/statm", "r");
+    if (f != nullptr) {
+        if (std::fscanf(f, "%zu %zu", &size, &pages) != 2) {
+            pages = 0;
+        }
+        std::fclose(f);
+    }
+    return pages * size_t(sysconf(_SC_PAGESIZE));
+}
+
+/**
+ * # Per item memory benchmark
+ * Fills every storage with small values, 16 bytes keys and values of 8 to 64 bytes, and reports how
+ * much resident memory every item takes on average along with the number of such items a gigabyte
+ * holds. Every storage is measured in its own process, so that heap left by the previous one doesn't
+ * count.
+ *
+ * Usage: benchItemOverhead [items]
+ */
+int main(int argc, char **argv) {
+    size_t n_items = 1000000;
+    if (argc > 1) {
+        n_items = std::strtoul(argv[1], nullptr, 10);
+    }
+
+    // Budget fits every item without evictions
+    const size_t key_size = 16;
+    const size_t budget = n_items * 256 + (64 << 20);
+    std::vector<std::pair<std::string, std::function<Storage *()>>> storages = {
+        {"st_lru", [&]() { return new Backend::SimpleLRU(budget); }},
+        {"st_slab", [&]() { return new Backend::SlabLRU(budget); }},
+        {"st_compact", [&]() { return new Backend::CompactLRU(budget); }},
+    };
+
+    std::printf("%-12s %10s %14s %14s %14s\n", "storage", "items", "payload/item", "bytes/item", "items/GB");
+    std::fflush(stdout);
+    for (auto &s : storages) {
+        pid_t pid = fork();
+        if (pid != 0) {
+            int status;
+            waitpid(pid, &status, 0);
+            continue;
+        }
+
+        std::unique_ptr<Storage> storage(s.second());
+        XorShift rnd(1);
+        size_t payload = 0;
+        size_t before = resident();
+        for (size_t i = 0; i < n_items; i++) {
+            std::string value(8 + rnd.next() % 57, 'v');
+            payload += key_size + value.size();
+            storage->Put(make_key(i, key_size), value);
+        }
+        size_t used = resident() - before;
+
+        std::map<std::string, std::string> stats;
+        storage->Stats(stats);
+        size_t items = std::strtoul(stats["curr_items"].c_str(), nullptr, 10);
+        if (items == 0) {
+            items = n_items;
+        }
+        double per_item = double(used) / items;
+        std::printf("%-12s %10zu %14.1f %14.1f %14.0f\n", s.first.c_str(), items, double(payload) / n_items,
+                    per_item, double(1 << 30) / per_item);
+        std::fflush(stdout);
+        _exit(0);
+    }
+    return 0;
+}
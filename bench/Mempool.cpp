@@ -0,0 +1,170 @@
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <afina/allocator/Arena.h>
+#include <afina/allocator/Mempool.h>
+#include <afina/allocator/SlabCache.h>
+
+#include "BenchUtils.h"
+
+using namespace Afina;
+using namespace Afina::Allocator;
+using namespace Afina::Bench;
+
+// Object sizes every thread allocates
+static const size_t kSizes[] = {32, 64, 256};
+static const size_t kClasses = sizeof(kSizes) / sizeof(kSizes[0]);
+
+/**
+ * Allocator of a benchmark thread backed by glibc malloc
+ */
+class MallocThread {
+public:
+    MallocThread(Arena &) {}
+
+    void *alloc(size_t cls) { return std::malloc(kSizes[cls]); }
+    void free(size_t, void *p) { std::free(p); }
+};
+
+/**
+ * Allocator of a benchmark thread backed by own slab cache and pools
+ */
+class MempoolThread {
+public:
+    MempoolThread(Arena &arena) : _cache(arena) {
+        for (size_t cls = 0; cls < kClasses; cls++) {
+            _pools.emplace_back(new Mempool(_cache, kSizes[cls]));
+        }
+    }
+
+    ~MempoolThread() {
+        // Other threads could still return objects of the pools
+        for (auto &pool : _pools) {
+            while (pool->used() > 0) {
+                pool->collect();
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void *alloc(size_t cls) { return _pools[cls]->alloc(); }
+    void free(size_t cls, void *p) { _pools[cls]->free(p); }
+
+private:
+    SlabCache _cache;
+    std::vector<std::unique_ptr<Mempool>> _pools;
+};
+
+/**
+ * Every thread allocates a batch of objects of random sizes and frees them, all frees are local
+ */
+template <typename T> double local_batches(Arena &arena, size_t n_threads, size_t ops) {
+    return run_threads(n_threads, [&](size_t t) {
+        T allocator(arena);
+        XorShift rnd(t);
+        const size_t batch = 64;
+        void *objects[batch];
+        size_t classes[batch];
+        for (size_t done = 0; done < ops; done += batch) {
+            for (size_t i = 0; i < batch; i++) {
+                classes[i] = rnd.next() % kClasses;
+                objects[i] = allocator.alloc(classes[i]);
+                *static_cast<char *>(objects[i]) = char(i);
+            }
+            for (size_t i = batch; i > 0; i--) {
+                allocator.free(classes[i - 1], objects[i - 1]);
+            }
+        }
+    });
+}
+
+/**
+ * Every thread publishes allocated objects and frees objects published by its neighbour, so that most
+ * of the frees happen on a thread that doesn't own the object
+ */
+template <typename T> double handoff(Arena &arena, size_t n_threads, size_t ops) {
+    std::vector<std::atomic<void *>> mailbox(n_threads);
+    for (auto &m : mailbox) {
+        m = nullptr;
+    }
+    std::vector<std::atomic<bool>> finished(n_threads);
+    for (auto &f : finished) {
+        f = false;
+    }
+
+    return run_threads(n_threads, [&](size_t t) {
+        T allocator(arena);
+        XorShift rnd(t);
+        size_t next = (t + 1) % n_threads;
+
+        // Size class is kept in the first byte of the object
+        auto release = [&](void *p) {
+            if (p != nullptr) {
+                allocator.free(*static_cast<unsigned char *>(p), p);
+            }
+        };
+        for (size_t done = 0; done < ops; done++) {
+            size_t cls = rnd.next() % kClasses;
+            void *p = allocator.alloc(cls);
+            *static_cast<unsigned char *>(p) = static_cast<unsigned char>(cls);
+            release(mailbox[t].exchange(p));
+            if (n_threads > 1) {
+                release(mailbox[next].exchange(nullptr));
+            }
+        }
+        release(mailbox[t].exchange(nullptr));
+
+        // Neighbour objects are freed by this thread, so it must wait until neighbour stops publishing
+        finished[t] = true;
+        while (n_threads > 1 && !finished[next].load()) {
+            std::this_thread::yield();
+        }
+        release(mailbox[next].exchange(nullptr));
+    });
+}
+
+/**
+ * # Multithreaded allocator benchmark
+ * Compares Arena -> SlabCache -> Mempool allocator with glibc malloc on small objects of a few sizes,
+ * with thread local and cross thread frees.
+ *
+ * Usage: benchMempool [max_threads] [ops_per_thread]
+ */
+int main(int argc, char **argv) {
+    size_t max_threads = std::thread::hardware_concurrency();
+    if (argc > 1) {
+        max_threads = std::strtoul(argv[1], nullptr, 10);
+    }
+    size_t ops_per_thread = 10000000;
+    if (argc > 2) {
+        ops_per_thread = std::strtoul(argv[2], nullptr, 10);
+    }
+    if (max_threads == 0) {
+        max_threads = 1;
+    }
+
+    // Threads keep at most a few slabs of every class, 1 MB per thread is plenty
+    const size_t area_size = (max_threads + 1) << 20;
+    std::unique_ptr<char[]> area(new char[area_size]);
+    Arena arena(area.get(), area_size);
+
+    auto report = [&](const char *workload, const char *alloc, size_t n_threads, double seconds) {
+        std::printf("%-10s %-8s %8zu %14.3f\n", workload, alloc, n_threads, n_threads * ops_per_thread / seconds / 1e6);
+    };
+
+    std::printf("%-10s %-8s %8s %14s\n", "workload", "alloc", "threads", "Mops/sec");
+    for (size_t n_threads : thread_steps(max_threads)) {
+        report("local", "malloc", n_threads, local_batches<MallocThread>(arena, n_threads, ops_per_thread));
+        report("local", "mempool", n_threads, local_batches<MempoolThread>(arena, n_threads, ops_per_thread));
+    }
+    for (size_t n_threads : thread_steps(max_threads)) {
+        report("handoff", "malloc", n_threads, handoff<MallocThread>(arena, n_threads, ops_per_thread));
+        report("handoff", "mempool", n_threads, handoff<MempoolThread>(arena, n_threads, ops_per_thread));
+    }
+    return 0;
+}
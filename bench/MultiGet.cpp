@@ -0,0 +1,87 @@
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <afina/Storage.h>
+
+#include "storage/StripedLRU.h"
+#include "storage/ThreadSafeClockLRU.h"
+#include "storage/ThreadSafeSimpleLRU.h"
+
+#include "BenchUtils.h"
+
+using namespace Afina;
+using namespace Afina::Bench;
+
+/**
+ * # Multi-key get benchmark
+ * Compares batch of GetView calls against single MultiGet over the same keys for thread safe storages.
+ * Key set is much larger than CPU caches, so lookups are bound by memory latency.
+ *
+ * Usage: benchMultiGet [threads] [batch_size] [batches_per_thread]
+ */
+int main(int argc, char **argv) {
+    size_t n_threads = std::thread::hardware_concurrency();
+    if (argc > 1) {
+        n_threads = std::strtoul(argv[1], nullptr, 10);
+    }
+    size_t batch_size = 100;
+    if (argc > 2) {
+        batch_size = std::strtoul(argv[2], nullptr, 10);
+    }
+    size_t batches = 20000;
+    if (argc > 3) {
+        batches = std::strtoul(argv[3], nullptr, 10);
+    }
+    if (n_threads == 0) {
+        n_threads = 1;
+    }
+
+    const size_t n_keys = 1000000;
+    const size_t key_size = 16, value_size = 32;
+    const size_t cache_size = 2 * n_keys * (key_size + value_size);
+    const std::string value(value_size, 'v');
+
+    std::vector<std::pair<std::string, std::function<std::shared_ptr<Storage>()>>> storages = {
+        {"mt_lru", [&]() { return std::make_shared<Backend::ThreadSafeSimplLRU>(cache_size); }},
+        {"mt_sharded_lru", [&]() { return std::make_shared<Backend::StripedLRU>(cache_size, 64); }},
+        {"mt_clock", [&]() { return std::make_shared<Backend::ThreadSafeClockLRU>(cache_size); }},
+    };
+
+    std::printf("%-16s %-10s %14s\n", "storage", "mode", "Mkeys/sec");
+    for (auto &s : storages) {
+        std::shared_ptr<Storage> storage = s.second();
+        for (size_t i = 0; i < n_keys; i++) {
+            storage->Put(make_key(i, key_size), value);
+        }
+
+        for (bool batched : {false, true}) {
+            double seconds = run_threads(n_threads, [&](size_t id) {
+                XorShift rnd(id + 1);
+                std::vector<std::string> keys(batch_size);
+                std::vector<ValueView> values(batch_size);
+                for (size_t b = 0; b < batches; b++) {
+                    for (auto &key : keys) {
+                        key = make_key(rnd.next() % n_keys, key_size);
+                    }
+                    if (batched) {
+                        storage->MultiGet(keys, values);
+                    } else {
+                        for (size_t i = 0; i < keys.size(); i++) {
+                            storage->GetView(keys[i], values[i]);
+                        }
+                    }
+                }
+            });
+
+            double mkeys = (n_threads * batches * batch_size) / seconds / 1e6;
+            std::printf("%-16s %-10s %14.3f\n", s.first.c_str(), batched ? "multiget" : "single", mkeys);
+        }
+    }
+    return 0;
+}
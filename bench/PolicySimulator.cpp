@@ -0,0 +1,138 @@
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <afina/Storage.h>
+
+#include "storage/ClockLRU.h"
+#include "storage/SimpleLRU.h"
+#include "storage/TinyLFU.h"
+
+#include "BenchUtils.h"
+
+using namespace Afina;
+using namespace Afina::Bench;
+
+namespace {
+
+// Single request of a trace
+struct Request {
+    std::string key;
+    size_t size;
+};
+
+/**
+ * Reads trace file, each line is "<key>" or "<key> <value size>"
+ */
+bool read_trace(const std::string &path, size_t default_size, std::vector<Request> &trace) {
+    std::ifstream in(path);
+    if (!in) {
+        return false;
+    }
+
+    std::string line;
+    while (std::getline(in, line)) {
+        std::istringstream fields(line);
+        Request request;
+        request.size = default_size;
+        if (fields >> request.key) {
+            fields >> request.size;
+            trace.push_back(request);
+        }
+    }
+    return true;
+}
+
+/**
+ * Synthetic trace for the case when no recorded one provided: zipf distributed hot set interleaved
+ * with long scans over keys that are never requested again
+ */
+void synthetic_trace(size_t default_size, std::vector<Request> &trace) {
+    const size_t n_keys = 100000, n_requests = 2000000;
+    Zipf zipf(n_keys, 0.9);
+    XorShift rnd(7);
+    size_t scan_key = n_keys;
+    for (size_t i = 0; i < n_requests; i++) {
+        if ((i / 50000) % 4 == 3) {
+            trace.push_back({make_key(scan_key++), default_size});
+        } else {
+            trace.push_back({make_key(zipf.next(rnd)), default_size});
+        }
+    }
+}
+
+} // namespace
+
+/**
+ * # Trace driven eviction policy simulator
+ * Replays key traces against every eviction policy: each request is Get, on miss the key is Put with
+ * a value of the requested size. Reports hit ratio per policy so that policy could be chosen for the
+ * particular deployment.
+ *
+ * Usage: benchPolicySimulator <cache bytes> [trace file...]
+ * If no trace given synthetic one is used
+ */
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <cache bytes> [trace file...]" << std::endl;
+        return 1;
+    }
+    size_t cache_size = std::strtoul(argv[1], nullptr, 10);
+    const size_t default_size = 64;
+
+    std::vector<std::pair<std::string, std::vector<Request>>> traces;
+    for (int i = 2; i < argc; i++) {
+        traces.emplace_back(argv[i], std::vector<Request>());
+        if (!read_trace(argv[i], default_size, traces.back().second)) {
+            std::cerr << "Failed to read trace " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+    if (traces.empty()) {
+        traces.emplace_back("synthetic", std::vector<Request>());
+        synthetic_trace(default_size, traces.back().second);
+    }
+
+    std::vector<std::pair<std::string, std::function<std::shared_ptr<Storage>()>>> policies = {
+        {"lru", [&]() { return std::make_shared<Backend::SimpleLRU>(cache_size); }},
+        {"slru", [&]() { return std::make_shared<Backend::SimpleSLRU>(cache_size); }},
+        {"arc", [&]() { return std::make_shared<Backend::SimpleARC>(cache_size); }},
+        {"lfu", [&]() { return std::make_shared<Backend::SimpleLFU>(cache_size); }},
+        {"clock", [&]() { return std::make_shared<Backend::ClockLRU>(cache_size); }},
+        {"w-tinylfu",
+         [&]() {
+             // 1% LRU window in front of SLRU main cache, sketch sized for default sized items
+             size_t window = cache_size / 100;
+             return std::make_shared<Backend::TinyLFU>(std::make_shared<Backend::SimpleSLRU>(cache_size - window),
+                                                       window, cache_size / default_size);
+         }},
+    };
+
+    std::printf("%-24s %-10s %12s %10s\n", "trace", "policy", "requests", "hit ratio");
+    for (auto &trace : traces) {
+        for (auto &policy : policies) {
+            std::shared_ptr<Storage> storage = policy.second();
+
+            size_t hits = 0;
+            std::string out, value;
+            for (auto &request : trace.second) {
+                if (storage->Get(request.key, out)) {
+                    hits++;
+                } else {
+                    value.assign(request.size, 'v');
+                    storage->Put(request.key, value);
+                }
+            }
+            std::printf("%-24s %-10s %12zu %10.4f\n", trace.first.c_str(), policy.first.c_str(), trace.second.size(),
+                        trace.second.empty() ? 0.0 : double(hits) / trace.second.size());
+        }
+    }
+    return 0;
+}
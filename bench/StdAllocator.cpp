@@ -0,0 +1,92 @@
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include <afina/allocator/Simple.h>
+#include <afina/allocator/StdAllocator.h>
+
+#include "BenchUtils.h"
+
+using namespace Afina;
+using namespace Afina::Allocator;
+using namespace Afina::Bench;
+
+/**
+ * Builds short vectors the way parser collects keys of a command: a handful of elements pushed one by
+ * one, then the whole vector is dropped
+ */
+template <typename A> double short_vectors(const A &alloc, size_t rounds) {
+    return run_threads(1, [&](size_t) {
+        XorShift rnd(1);
+        size_t sum = 0;
+        for (size_t r = 0; r < rounds; r++) {
+            std::vector<uint64_t, A> keys(alloc);
+            size_t n = 1 + rnd.next() % 16;
+            for (size_t i = 0; i < n; i++) {
+                keys.push_back(i);
+            }
+            sum += keys.size();
+        }
+        if (sum == 0) {
+            std::printf("unreachable\n");
+        }
+    });
+}
+
+/**
+ * Keeps map of a fixed size and replaces random entries in it, as storage index does under churn
+ */
+template <typename A> double map_churn(const A &alloc, size_t n_keys, size_t rounds) {
+    using Map = std::map<uint64_t, uint64_t, std::less<uint64_t>, A>;
+    Map m{std::less<uint64_t>(), alloc};
+    for (size_t i = 0; i < n_keys; i++) {
+        m[i] = i;
+    }
+    return run_threads(1, [&](size_t) {
+        XorShift rnd(2);
+        for (size_t r = 0; r < rounds; r++) {
+            m.erase(rnd.next() % n_keys);
+            m[rnd.next() % n_keys] = r;
+        }
+    });
+}
+
+/**
+ * # Standard containers allocator benchmark
+ * Runs vector and map workloads with the default allocator and with StdAllocator over Simple arena
+ * of the given size.
+ *
+ * Usage: benchStdAllocator [arena_mb] [rounds]
+ */
+int main(int argc, char **argv) {
+    size_t arena_mb = 64;
+    if (argc > 1) {
+        arena_mb = std::strtoul(argv[1], nullptr, 10);
+    }
+    size_t rounds = 1000000;
+    if (argc > 2) {
+        rounds = std::strtoul(argv[2], nullptr, 10);
+    }
+
+    std::unique_ptr<char[]> area(new char[arena_mb << 20]);
+    Simple arena(area.get(), arena_mb << 20);
+
+    std::printf("%-16s %-10s %14s\n", "workload", "allocator", "Mops/sec");
+    std::printf("%-16s %-10s %14.3f\n", "short vectors", "default",
+                rounds / short_vectors(std::allocator<uint64_t>(), rounds) / 1e6);
+    std::printf("%-16s %-10s %14.3f\n", "short vectors", "simple",
+                rounds / short_vectors(StdAllocator<uint64_t>(arena), rounds) / 1e6);
+
+    using Entry = std::pair<const uint64_t, uint64_t>;
+    for (size_t n_keys : {1000, 100000}) {
+        char name[32];
+        std::snprintf(name, sizeof(name), "map %zu", n_keys);
+        std::printf("%-16s %-10s %14.3f\n", name, "default",
+                    rounds / map_churn(std::allocator<Entry>(), n_keys, rounds) / 1e6);
+        std::printf("%-16s %-10s %14.3f\n", name, "simple",
+                    rounds / map_churn(StdAllocator<Entry>(arena), n_keys, rounds) / 1e6);
+    }
+    return 0;
+}
@@ -0,0 +1,86 @@
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <afina/Storage.h>
+
+#include "storage/CuckooClock.h"
+#include "storage/StripedLRU.h"
+#include "storage/ThreadSafeClockLRU.h"
+#include "storage/ThreadSafeSimpleLRU.h"
+
+#include "BenchUtils.h"
+
+using namespace Afina;
+using namespace Afina::Bench;
+
+/**
+ * # Storage scaling benchmark
+ * Runs mixed Get/Put workload over thread safe storages with growing number of threads and reports
+ * total throughput. Workload is uniform over a key set that fits into cache, by default 90% of operations
+ * are Get.
+ *
+ * Usage: benchStorageScaling [max_threads] [ops_per_thread] [get_percent]
+ */
+int main(int argc, char **argv) {
+    size_t max_threads = std::thread::hardware_concurrency();
+    if (argc > 1) {
+        max_threads = std::strtoul(argv[1], nullptr, 10);
+    }
+    size_t ops_per_thread = 1000000;
+    if (argc > 2) {
+        ops_per_thread = std::strtoul(argv[2], nullptr, 10);
+    }
+    size_t get_percent = 90;
+    if (argc > 3) {
+        get_percent = std::strtoul(argv[3], nullptr, 10);
+    }
+    if (max_threads == 0) {
+        max_threads = 1;
+    }
+
+    const size_t n_keys = 100000;
+    const size_t key_size = 16, value_size = 32;
+    const size_t cache_size = 2 * n_keys * (key_size + value_size);
+    const std::string value(value_size, 'v');
+
+    std::vector<std::pair<std::string, std::function<std::shared_ptr<Storage>()>>> storages = {
+        {"mt_lru", [&]() { return std::make_shared<Backend::ThreadSafeSimplLRU>(cache_size); }},
+        {"mt_sharded_lru", [&]() { return std::make_shared<Backend::StripedLRU>(cache_size, 64); }},
+        {"mt_clock", [&]() { return std::make_shared<Backend::ThreadSafeClockLRU>(cache_size); }},
+        {"mt_cuckoo", [&]() { return std::make_shared<Backend::CuckooClock>(64 << 20); }},
+    };
+
+    std::printf("%-16s %8s %14s\n", "storage", "threads", "Mops/sec");
+    for (auto &s : storages) {
+        std::shared_ptr<Storage> storage = s.second();
+        for (size_t i = 0; i < n_keys; i++) {
+            storage->Put(make_key(i, key_size), value);
+        }
+
+        for (size_t n_threads : thread_steps(max_threads)) {
+            double seconds = run_threads(n_threads, [&](size_t id) {
+                XorShift rnd(id + 1);
+                std::string out;
+                for (size_t op = 0; op < ops_per_thread; op++) {
+                    uint64_t r = rnd.next();
+                    std::string key = make_key((r >> 8) % n_keys, key_size);
+                    if ((r & 0xff) % 100 >= get_percent) {
+                        storage->Put(key, value);
+                    } else {
+                        storage->Get(key, out);
+                    }
+                }
+            });
+
+            double mops = (n_threads * ops_per_thread) / seconds / 1e6;
+            std::printf("%-16s %8zu %14.3f\n", s.first.c_str(), n_threads, mops);
+        }
+    }
+    return 0;
+}
@@ -1,10 +1,80 @@
 #ifndef AFINA_STORAGE_H
 #define AFINA_STORAGE_H
 
+#include <cstdint>
+#include <map>
 #include <string>
+#include <utility>
+#include <vector>
+
+#include <afina/ValueView.h>
 
 namespace Afina {
 
+/**
+ * Metadata stored along with the value
+ */
+struct ValueInfo {
+    // Version of the association, changes on every write of the key. Storage that doesn't track
+    // versions reports 0, see Storage::CompareAndSwap
+    uint64_t cas;
+
+    // Opaque client flags given on write, see Storage::PutWithTTL
+    uint32_t flags;
+
+    // Precomputed tail of the memcached response line: " <flags> <bytes>\r\n". Points into memory
+    // held by the value view returned along with it, so stays valid as long as that view. nullptr if
+    // storage has none for the value
+    const char *header;
+    uint32_t header_size;
+};
+
+/**
+ * Outcome of Storage::CompareAndSwap
+ */
+enum class CasResult {
+    // Value is stored
+    Stored,
+    // Value can't be stored, e.g it is too large
+    NotStored,
+    // Key was modified since the version was taken
+    Exists,
+    // There is no such key
+    NotFound
+};
+
+/**
+ * Outcome of Storage::Increment and Storage::Decrement
+ */
+enum class DeltaResult {
+    // Counter is updated
+    Stored,
+    // Counter doesn't fit into storage
+    NotStored,
+    // Value isn't a decimal representation of unsigned 64-bit integer
+    NonNumeric,
+    // There is no such key
+    NotFound
+};
+
+/**
+ * Parses value of a counter: decimal representation of unsigned 64-bit integer, returns false if
+ * value is anything else
+ */
+inline bool ParseCounter(const char *data, size_t size, uint64_t &number) {
+    if (size == 0 || size > 20) {
+        return false;
+    }
+    number = 0;
+    for (size_t i = 0; i < size; i++) {
+        if (data[i] < '0' || data[i] > '9' || number > (UINT64_MAX - (data[i] - '0')) / 10) {
+            return false;
+        }
+        number = number * 10 + (data[i] - '0');
+    }
+    return true;
+}
+
 /**
  *
  */
@@ -84,6 +154,210 @@ public:
      * @param value output parameter to copy value to
      */
     virtual bool Get(const std::string &key, std::string &value) = 0;
+
+    /**
+     * Same as Get, but instead of copying value gives out a view of it. View keeps value memory
+     * alive and unchanged while it exists, regardless of what happens to the key, see ValueView.
+     *
+     * Default implementation copies value into memory owned by the view
+     *
+     * @param key to retrive value for
+     * @param value output parameter to place view to
+     */
+    virtual bool GetView(const std::string &key, ValueView &value) {
+        std::string copy;
+        if (!Get(key, copy)) {
+            return false;
+        }
+        value = ValueView::Copy(std::move(copy));
+        return true;
+    }
+
+    /**
+     * Retrieves values for a batch of keys at once: values[i] gets view of the value for keys[i] or
+     * stays empty (data() is nullptr) if there is no such key. Storage could group keys and overlap
+     * lookups, so batch is cheaper than a sequence of GetView calls, however it is not atomic.
+     *
+     * @param keys to retrive values for
+     * @param values output parameter, resized to number of keys
+     */
+    virtual void MultiGet(const std::vector<std::string> &keys, std::vector<ValueView> &values) {
+        values.clear();
+        values.resize(keys.size());
+        for (size_t i = 0; i < keys.size(); i++) {
+            GetView(keys[i], values[i]);
+        }
+    }
+
+    /**
+     * Same as MultiGet, but also reports metadata of every found value: infos[i] describes values[i],
+     * infos of missing keys are undefined
+     *
+     * Default implementation reports zero metadata
+     *
+     * @param keys to retrive values for
+     * @param values output parameter, resized to number of keys
+     * @param infos output parameter, resized to number of keys
+     */
+    virtual void MultiGetWithInfo(const std::vector<std::string> &keys, std::vector<ValueView> &values,
+                                  std::vector<ValueInfo> &infos) {
+        MultiGet(keys, values);
+        infos.assign(keys.size(), ValueInfo{0, 0, nullptr, 0});
+    }
+
+    /**
+     * Stores a batch of associations keys[i] -> values[i] as Put does, not atomic. Returns true if
+     * every pair is stored
+     *
+     * @param keys to be associated with values
+     * @param values to be assigned for the keys, same number as keys
+     */
+    virtual bool MultiPut(const std::vector<std::string> &keys, const std::vector<std::string> &values) {
+        bool stored = true;
+        for (size_t i = 0; i < keys.size(); i++) {
+            stored = Put(keys[i], values[i]) && stored;
+        }
+        return stored;
+    }
+
+    /**
+     * Same as Put, but association expires given number of seconds later: once it is passed any
+     * subsequent access to storage must indicate that key is absent. Put without TTL, same as ttl
+     * of 0, creates association that never expires.
+     *
+     * Flags are stored along with the value and reported back by MultiGetWithInfo, Put without TTL
+     * stores 0. Storage that doesn't support expiration or flags ignores them
+     *
+     * @param key to be associated with value
+     * @param value to be assigned for the key
+     * @param ttl number of seconds association lives, 0 means forever
+     * @param flags opaque client flags
+     */
+    virtual bool PutWithTTL(const std::string &key, const std::string &value, uint32_t ttl, uint32_t flags) {
+        return Put(key, value);
+    }
+
+    /**
+     * Same as PutIfAbsent, but association expires given number of seconds later, see PutWithTTL
+     */
+    virtual bool PutIfAbsentWithTTL(const std::string &key, const std::string &value, uint32_t ttl,
+                                    uint32_t flags) {
+        return PutIfAbsent(key, value);
+    }
+
+    /**
+     * Same as Set, but association expires given number of seconds later, see PutWithTTL
+     */
+    virtual bool SetWithTTL(const std::string &key, const std::string &value, uint32_t ttl, uint32_t flags) {
+        return Set(key, value);
+    }
+
+    /**
+     * Updates existing association, as SetWithTTL does, but only if it is still of the given version,
+     * i.e nobody has written the key since its version was obtained from MultiGetWithInfo.
+     *
+     * Default implementation doesn't track versions, so nothing is ever stored
+     *
+     * @param key to be associated with value
+     * @param value to be assigned for the key
+     * @param ttl number of seconds association lives, 0 means forever
+     * @param flags opaque client flags
+     * @param cas version of the association expected
+     */
+    virtual CasResult CompareAndSwap(const std::string &key, const std::string &value, uint32_t ttl, uint32_t flags,
+                                     uint64_t cas) {
+        std::string current;
+        return Get(key, current) ? CasResult::Exists : CasResult::NotFound;
+    }
+
+    /**
+     * Adds data to the end of value for the existing key. If requested key doesn't present in storage
+     * method returns false and doesn't change anything. Deadline and flags of the association stay the
+     * same.
+     *
+     * Storage looks key up once and extends value in place whenever item has room for it. Value that
+     * keeps growing may be stored in pieces, so that only the last one is touched, views of such value
+     * are chained, see ValueView. Default implementation is Get followed by Set, so it isn't atomic
+     *
+     * @param key to extend value of
+     * @param data to be added after existing value
+     */
+    virtual bool Append(const std::string &key, const std::string &data) {
+        std::string value;
+        return Get(key, value) && Set(key, value + data);
+    }
+
+    /**
+     * Same as Append, but data is added before existing value
+     */
+    virtual bool Prepend(const std::string &key, const std::string &data) {
+        std::string value;
+        return Get(key, value) && Set(key, data + value);
+    }
+
+    /**
+     * Adds delta to the counter stored under the given key. Value of the key must be a decimal
+     * representation of unsigned 64-bit integer, sum wraps around 2^64. Deadline of the association
+     * stays the same.
+     *
+     * Storage may keep counter in binary form and update it in place, readers still see decimal
+     * text. Default implementation is Get followed by Set, so it isn't atomic
+     *
+     * @param key of the counter
+     * @param delta to add
+     * @param result output parameter, new value of the counter
+     */
+    virtual DeltaResult Increment(const std::string &key, uint64_t delta, uint64_t &result) {
+        std::string value;
+        uint64_t number;
+        if (!Get(key, value)) {
+            return DeltaResult::NotFound;
+        }
+        if (!ParseCounter(value.data(), value.size(), number)) {
+            return DeltaResult::NonNumeric;
+        }
+        result = number + delta;
+        return Set(key, std::to_string(result)) ? DeltaResult::Stored : DeltaResult::NotStored;
+    }
+
+    /**
+     * Same as Increment, but delta is subtracted from the counter, which never goes below 0
+     */
+    virtual DeltaResult Decrement(const std::string &key, uint64_t delta, uint64_t &result) {
+        std::string value;
+        uint64_t number;
+        if (!Get(key, value)) {
+            return DeltaResult::NotFound;
+        }
+        if (!ParseCounter(value.data(), value.size(), number)) {
+            return DeltaResult::NonNumeric;
+        }
+        result = (number > delta) ? number - delta : 0;
+        return Set(key, std::to_string(result)) ? DeltaResult::Stored : DeltaResult::NotStored;
+    }
+
+    /**
+     * Reports key that would be evicted first if the given pair was put into storage.
+     *
+     * If pair fits without eviction, or storage can't predict eviction, then method returns false
+     * and doesn't change output parameter. Otherwise method copies victim key into output parameter
+     * and returns true. Storage state doesn't change in any way.
+     *
+     * @param key the key of the pair to be stored
+     * @param value the value of the pair to be stored
+     * @param victim output parameter to copy victim key to
+     */
+    virtual bool EvictionCandidate(const std::string &key, const std::string &value, std::string &victim) {
+        return false;
+    }
+
+    /**
+     * Adds storage statistics, name -> value, to the given map. Storage that has nothing to report
+     * leaves map untouched
+     *
+     * @param stats output parameter to add statistics to
+     */
+    virtual void Stats(std::map<std::string, std::string> &stats) {}
 };
 
 } // namespace Afina
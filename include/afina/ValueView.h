@@ -0,0 +1,149 @@
+#ifndef AFINA_VALUE_VIEW_H
+#define AFINA_VALUE_VIEW_H
+
+#include <cstddef>
+#include <string>
+#include <utility>
+
+namespace Afina {
+
+/**
+ * # Immutable view of stored bytes
+ * Points to memory owned by someone else (usually storage item) and holds one reference to it. Memory
+ * stays valid and unchanged until view is destroyed, even if key gets overwritten, deleted or evicted
+ * meanwhile.
+ *
+ * View is move only, so that holding it costs no allocations nor atomic operations besides the single
+ * release in destructor.
+ *
+ * Value stored in pieces is seen through a chain of views: each one covers a single piece and owns
+ * the view of the next one. data() and size() describe the first piece only, see next()
+ */
+class ValueView {
+public:
+    // Drops reference to the owner
+    using Release = void (*)(void *owner);
+
+    ValueView() : _data(nullptr), _size(0), _owner(nullptr), _release(nullptr), _next(nullptr) {}
+
+    /**
+     * Takes over a reference to the owner, release is called once view is gone. Release could be
+     * nullptr for memory that lives forever, e.g string literals
+     */
+    ValueView(const char *data, size_t size, void *owner, Release release)
+        : _data(data), _size(size), _owner(owner), _release(release), _next(nullptr) {}
+
+    ValueView(ValueView &&other)
+        : _data(other._data), _size(other._size), _owner(other._owner), _release(other._release),
+          _next(other._next) {
+        other._data = nullptr;
+        other._size = 0;
+        other._owner = nullptr;
+        other._release = nullptr;
+        other._next = nullptr;
+    }
+
+    ValueView &operator=(ValueView &&other) {
+        if (this != &other) {
+            reset();
+            std::swap(_data, other._data);
+            std::swap(_size, other._size);
+            std::swap(_owner, other._owner);
+            std::swap(_release, other._release);
+            std::swap(_next, other._next);
+        }
+        return *this;
+    }
+
+    ValueView(const ValueView &) = delete;
+    ValueView &operator=(const ValueView &) = delete;
+
+    ~ValueView() { reset(); }
+
+    /**
+     * View over its own copy of the given bytes, for data that has no reference counted owner
+     */
+    static ValueView Copy(std::string data) {
+        std::string *owned = new std::string(std::move(data));
+        return ValueView(owned->data(), owned->size(), owned,
+                         [](void *owner) { delete static_cast<std::string *>(owner); });
+    }
+
+    // nullptr if view doesn't point anywhere, view of an empty value still has data
+    const char *data() const { return _data; }
+    size_t size() const { return _size; }
+
+    // View of the next piece of the value, nullptr if this one is the last
+    const ValueView *next() const { return _next; }
+
+    // Number of bytes in the whole chain
+    size_t total_size() const {
+        size_t result = 0;
+        for (const ValueView *view = this; view != nullptr; view = view->_next) {
+            result += view->_size;
+        }
+        return result;
+    }
+
+    // Copy of the whole chain
+    std::string str() const {
+        std::string result;
+        result.reserve(total_size());
+        for (const ValueView *view = this; view != nullptr; view = view->_next) {
+            result.append(view->_data, view->_size);
+        }
+        return result;
+    }
+
+    /**
+     * Links view of the next piece after this one, which must be the last in chain. Returns linked
+     * view, so that chain is built in a single pass
+     */
+    ValueView &chain(ValueView &&next) {
+        _next = new ValueView(std::move(next));
+        return *_next;
+    }
+
+    // Detaches the rest of the chain, this view becomes the last one
+    ValueView unchain() {
+        ValueView rest;
+        if (_next != nullptr) {
+            rest = std::move(*_next);
+            delete _next;
+            _next = nullptr;
+        }
+        return rest;
+    }
+
+    // Drops reference, view becomes empty. Chained views are dropped one by one, not recursively, as
+    // chains could be long
+    void reset() {
+        if (_release != nullptr) {
+            _release(_owner);
+        }
+        _data = nullptr;
+        _size = 0;
+        _owner = nullptr;
+        _release = nullptr;
+
+        ValueView *next = _next;
+        _next = nullptr;
+        while (next != nullptr) {
+            ValueView *after = next->_next;
+            next->_next = nullptr;
+            delete next;
+            next = after;
+        }
+    }
+
+private:
+    const char *_data;
+    size_t _size;
+    void *_owner;
+    Release _release;
+    ValueView *_next;
+};
+
+} // namespace Afina
+
+#endif // AFINA_VALUE_VIEW_H
@@ -0,0 +1,83 @@
+#ifndef AFINA_ALLOCATOR_ARENA_H
+#define AFINA_ALLOCATOR_ARENA_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace Afina {
+namespace Allocator {
+
+/**
+ * # Slab arena
+ * The first tier of the Arena -> SlabCache -> Mempool allocator. Wraps given memory area and hands out
+ * slabs of kSlabSize bytes aligned to their size, so that object finds its slab by address alone.
+ *
+ * Arena is shared between threads and lock free: untouched slabs are cut from the area by moving an
+ * atomic counter, returned ones are kept in a stack with ABA tag packed next to the head index. Free
+ * slabs are linked through a separate array rather than through their memory, so that a thread reading
+ * a stale link never races with the new owner writing into the slab.
+ *
+ * Arena instance doesn't take ownership of wrapped memory and do not delete it on destruction.
+ */
+class Arena {
+public:
+    // Number of bytes in each slab, alignment of slabs
+    static constexpr size_t kSlabSize = 1 << 16;
+
+    /**
+     * @param base start of memory area
+     * @param size number of bytes in the area
+     */
+    Arena(void *base, size_t size);
+    ~Arena() {}
+
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+
+    /**
+     * Takes free slab, nullptr if there is none. Could be called from any thread
+     */
+    void *take();
+
+    /**
+     * Returns slab taken from this arena. Could be called from any thread
+     */
+    void put(void *slab);
+
+    /**
+     * Start of the slab given address belongs to
+     */
+    static void *slab_of(const void *p) {
+        return reinterpret_cast<void *>(reinterpret_cast<uintptr_t>(p) & ~uintptr_t(kSlabSize - 1));
+    }
+
+    /**
+     * Number of slabs in the area and number of them taken right now
+     */
+    size_t slabs() const { return _slabs; }
+    size_t used() const { return _used.load(std::memory_order_relaxed); }
+
+private:
+    // Head of the free stack: ABA tag in the upper half, index of the slab plus one in the lower one
+    static uint64_t pack(uint64_t tag, uint32_t index) { return (tag << 32) | (index + 1); }
+
+    // First aligned slab and number of slabs in the area
+    char *_base;
+    uint32_t _slabs;
+
+    // Slabs starting from this one were never taken
+    std::atomic<uint32_t> _carved;
+
+    // Stack of returned slabs, _next[i] is the packed index of the slab after i
+    std::atomic<uint64_t> _free;
+    std::unique_ptr<std::atomic<uint32_t>[]> _next;
+
+    std::atomic<size_t> _used;
+};
+
+} // namespace Allocator
+} // namespace Afina
+
+#endif // AFINA_ALLOCATOR_ARENA_H
@@ -0,0 +1,104 @@
+#ifndef AFINA_ALLOCATOR_MEMPOOL_H
+#define AFINA_ALLOCATOR_MEMPOOL_H
+
+#include <atomic>
+#include <cstddef>
+
+namespace Afina {
+namespace Allocator {
+
+// Forward declaration. Do not include real class definition
+// to avoid expensive macros calculations and increase compile speed
+class SlabCache;
+
+/**
+ * # Per-thread object pool
+ * The last tier of the Arena -> SlabCache -> Mempool allocator: hands out objects of a single size cut
+ * from slabs of the thread slab cache. Every thread has its own pools, so allocation and free of the
+ * thread own objects touch no shared state at all, shared arena is only visited once the slab cache
+ * runs out of empty slabs.
+ *
+ * Object could be freed through any pool of the same arena. Objects of another pool are pushed to the
+ * lock free queue of their owner, owner takes the whole queue at once and frees its content when it
+ * runs out of objects.
+ *
+ * Every method but free of a foreign object must be called from the owner thread. Pool must outlive
+ * its objects, slabs still holding objects are not returned to the cache on destruction.
+ */
+class Mempool {
+public:
+    /**
+     * @param cache slab cache of the owner thread
+     * @param object_size number of bytes in every object, throws AllocError of NoMemory type if slab
+     * can't fit a single object
+     */
+    Mempool(SlabCache &cache, size_t object_size);
+    ~Mempool();
+
+    Mempool(const Mempool &) = delete;
+    Mempool &operator=(const Mempool &) = delete;
+
+    /**
+     * Allocates object, throws AllocError of NoMemory type if arena has no slabs left
+     */
+    void *alloc();
+
+    /**
+     * Same as alloc, but returns nullptr instead of throwing
+     */
+    void *try_alloc();
+
+    /**
+     * Frees object allocated by any pool over the same arena
+     */
+    void free(void *p);
+
+    /**
+     * Frees objects other threads have returned right away, rather than once pool runs out of objects
+     */
+    void collect();
+
+    /**
+     * Number of bytes in every object
+     */
+    size_t object_size() const { return _object_size; }
+
+    /**
+     * Number of objects given out and not freed yet. Objects freed by other threads are counted until
+     * the pool takes them back
+     */
+    size_t used() const { return _used; }
+
+    /**
+     * Number of slabs held by the pool
+     */
+    size_t slabs() const { return _slabs; }
+
+private:
+    struct SlabHeader;
+
+    // Slab list helpers, lists are doubly linked through SlabHeader::prev/next
+    static void push(SlabHeader *&head, SlabHeader *slab);
+    static void unlink(SlabHeader *&head, SlabHeader *slab);
+
+    // Puts object of this pool back to its slab
+    void release(SlabHeader *slab, void *p);
+
+    SlabCache &_cache;
+    const size_t _object_size;
+    size_t _per_slab;
+
+    // Slabs having free objects
+    SlabHeader *_partial;
+    size_t _slabs;
+    size_t _used;
+
+    // Objects freed by other threads, linked through themselves. Kept away from the fields owner
+    // touches on every call
+    alignas(64) std::atomic<void *> _remote;
+};
+
+} // namespace Allocator
+} // namespace Afina
+
+#endif // AFINA_ALLOCATOR_MEMPOOL_H
@@ -1,12 +1,41 @@
 #ifndef AFINA_ALLOCATOR_POINTER_H
 #define AFINA_ALLOCATOR_POINTER_H
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
 namespace Afina {
 namespace Allocator {
 // Forward declaration. Do not include real class definition
 // to avoid expensive macros calculations and increase compile speed
 class Simple;
 
+/**
+ * Entry of the Simple handle table
+ */
+struct HandleSlot {
+    // Current block address, next unused slot while slot is unused
+    std::atomic<void *> address;
+
+    // Bumped every time block is freed
+    std::atomic<uint32_t> generation;
+
+    // Odd while block is being moved
+    std::atomic<uint32_t> moves;
+};
+
+/**
+ * Handle of the block allocated by Simple: 32-bit index in the allocator handle table along with the
+ * generation of the table slot it was issued for. Allocator moves blocks during defragmentation and
+ * updates only the slot, so get() must be called again after any allocator call. Slot generation
+ * changes once block is freed, so stale copies of the handle see nullptr rather than some other block.
+ *
+ * get() and read() could run concurrently with allocator calls made by another thread: slot is read
+ * atomically. Memory returned by get() is only stable until the next allocator call though, so
+ * readers racing with defragmentation should use read(), which copies block content consistently
+ * even if the block is being moved.
+ */
 class Pointer {
 public:
     Pointer();
@@ -17,7 +46,31 @@ public:
     Pointer &operator=(const Pointer &);
     Pointer &operator=(Pointer &&);
 
-    void *get() const { return 0; }
+    void *get() const {
+        if (_slots == nullptr) {
+            return nullptr;
+        }
+        const HandleSlot &slot = _slots[-std::ptrdiff_t(_index)];
+        void *address = slot.address.load(std::memory_order_acquire);
+        return (slot.generation.load(std::memory_order_acquire) == _generation) ? address : nullptr;
+    }
+
+    /**
+     * Copies first size bytes of the block into out, retries if block was moved meanwhile. Returns
+     * false if handle is empty or stale
+     */
+    bool read(void *out, size_t size) const;
+
+private:
+    friend class Simple;
+
+    Pointer(const HandleSlot *slots, uint32_t index, uint32_t generation)
+        : _slots(slots), _index(index), _generation(generation) {}
+
+    // Slot 0 of the table, table grows down so slot i is at _slots - i. nullptr if handle is empty
+    const HandleSlot *_slots;
+    uint32_t _index;
+    uint32_t _generation;
 };
 
 } // namespace Allocator
@@ -0,0 +1,70 @@
+#ifndef AFINA_ALLOCATOR_REGION_H
+#define AFINA_ALLOCATOR_REGION_H
+
+#include <chrono>
+#include <cstddef>
+
+namespace Afina {
+namespace Allocator {
+
+/**
+ * Kind of pages memory region is backed by
+ */
+enum class HugePages {
+    // Regular pages
+    None,
+    // Regular mapping kernel is asked to back by transparent huge pages
+    Transparent,
+    // Pages from the reserved huge page pool, see /proc/sys/vm/nr_hugepages
+    Explicit,
+};
+
+/**
+ * # Anonymous memory region
+ * Single mmap-ed region allocators could carve. Region could ask for huge pages to cut TLB misses over
+ * large heaps: explicit huge pages fall back to transparent ones if the pool is empty, and those fall
+ * back to regular pages if the kernel has them disabled. Kind of pages actually used is reported by
+ * huge_pages().
+ *
+ * Kernel maps pages lazily on the first write, so a fresh region makes first minutes of work slower.
+ * prefault() maps all of them upfront.
+ */
+class Region {
+public:
+    // Size and alignment of the huge page
+    static constexpr size_t kHugePageSize = 2 << 20;
+
+    /**
+     * Maps size bytes, rounded up to the page size. Throws AllocError of NoMemory type if there is
+     * no memory even for regular pages
+     */
+    Region(size_t size, HugePages huge_pages = HugePages::None);
+    ~Region();
+
+    Region(const Region &) = delete;
+    Region &operator=(const Region &) = delete;
+
+    void *data() const { return _data; }
+    size_t size() const { return _size; }
+
+    /**
+     * Kind of pages region has got
+     */
+    HugePages huge_pages() const { return _huge_pages; }
+
+    /**
+     * Maps every page of the region, keeping its content. Work is split between n_threads threads.
+     * Returns time it took. Region must not be written by anybody else meanwhile
+     */
+    std::chrono::milliseconds prefault(size_t n_threads);
+
+private:
+    void *_data;
+    size_t _size;
+    HugePages _huge_pages;
+};
+
+} // namespace Allocator
+} // namespace Afina
+
+#endif // AFINA_ALLOCATOR_REGION_H
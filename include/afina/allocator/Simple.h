@@ -1,8 +1,9 @@
 #ifndef AFINA_ALLOCATOR_SIMPLE_H
 #define AFINA_ALLOCATOR_SIMPLE_H
 
-#include <string>
+#include <chrono>
 #include <cstddef>
+#include <string>
 
 namespace Afina {
 namespace Allocator {
@@ -10,52 +11,111 @@ namespace Allocator {
 // Forward declaration. Do not include real class definition
 // to avoid expensive macros calculations and increase compile speed
 class Pointer;
+struct HandleSlot;
 
 /**
  * Wraps given memory area and provides defagmentation allocator interface on
  * the top of it.
  *
+ * Blocks are placed from the beginning of the area one after another, every block starts with a small
+ * header. Handle table grows from the end of the area towards blocks, Pointer is an index in it, so
+ * allocator could move block and only update its handle slot. Slot keeps generation that changes once
+ * block is freed, so that stale pointers are detected. Freed block stays a hole until either allocation
+ * reuses it or defragmentation slides blocks above it down.
+ *
+ * Defragmentation is incremental: every call moves limited amount of memory and continues where the
+ * previous one stopped, so it could be driven from idle time without long pauses. Compaction also
+ * keeps allocation cheap: everything below the first hole is known to be used.
+ *
  * Allocator instance doesn't take ownership of wrapped memmory and do not delete it
  * on destruction. So caller must take care of resource cleaup after allocator stop
  * being needs
+ *
+ * StdAllocator adapts it to the standard allocator interface, so that containers could live in the area.
  */
-// TODO: Implements interface to allow usage as C++ allocators
 class Simple {
 public:
     Simple(void *base, const size_t size);
 
     /**
-     * TODO: semantics
+     * Allocates block of at least N bytes, the first hole that fits is taken. Throws AllocError of
+     * NoMemory type if there is no room for it
      * @param N size_t
      */
     Pointer alloc(size_t N);
 
     /**
-     * TODO: semantics
+     * Changes size of the block to N bytes keeping its content, block grows in place if memory right
+     * after it is free, otherwise it is moved. Empty pointer gets new block. Throws AllocError of
+     * NoMemory type if there is no room, block is left untouched in that case
      * @param p Pointer
      * @param N size_t
      */
     void realloc(Pointer &p, size_t N);
 
     /**
-     * TODO: semantics
+     * Releases block and empties pointer, copies of the pointer must not be used after that. Throws
+     * AllocError of InvalidFree type if pointer doesn't belong to the allocator
      * @param p Pointer
      */
     void free(Pointer &p);
 
     /**
-     * TODO: semantics
+     * Handle of the block which data starts at given address. Throws AllocError of InvalidFree type if
+     * there is no such block
+     * @param address const void*
+     */
+    Pointer handle_of(const void *address) const;
+
+    /**
+     * Compacts memory completely: all blocks are moved to the beginning of the area, all free memory
+     * is left in one piece after them
      */
     void defrag();
 
     /**
-     * TODO: semantics
+     * Does next step of compaction: moves blocks until either max_bytes of them are moved or
+     * max_time passes, at least one block is moved anyway. Returns true once memory is compact
+     * @param max_bytes size_t
+     * @param max_time std::chrono::microseconds
+     */
+    bool defrag(size_t max_bytes, std::chrono::microseconds max_time);
+
+    /**
+     * Human readable list of blocks
      */
     std::string dump() const;
 
 private:
+    struct Block;
+
+    // Handle slot of the new block, throws if there is no room for it
+    HandleSlot *take_slot();
+    // First hole of at least size bytes, nullptr if there is none. Adjacent holes are merged on the way
+    Block *find_hole(size_t size);
+    // New block of size bytes at the end of used memory, nullptr if there is no room
+    Block *extend(size_t size);
+    // Cuts the tail of the block off into a hole, if it is large enough
+    void split(Block *block, size_t size);
+    // Turns block into a hole
+    void release(Block *block);
+    // Block given pointer refers to, throws if pointer doesn't belong to the allocator
+    Block *block_of(const Pointer &p) const;
+
     void *_base;
     const size_t _base_len;
+
+    // Blocks are in [_begin, _top), handle slots are in [_table, _table_end), slot 0 is the last one
+    char *_begin;
+    char *_top;
+    HandleSlot *_table;
+    HandleSlot *_table_end;
+
+    // Chain of unused slots linked through their addresses
+    HandleSlot *_free_slots;
+
+    // Every block below it is in use, compaction continues from there
+    char *_first_hole;
 };
 
 } // namespace Allocator
@@ -0,0 +1,161 @@
+#ifndef AFINA_ALLOCATOR_SLAB_H
+#define AFINA_ALLOCATOR_SLAB_H
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Afina {
+namespace Allocator {
+
+/**
+ * # Slab allocator
+ * Wraps given memory area and hands out fixed size chunks of it. Area is cut into pages of kPageSize
+ * bytes, every page serves chunks of a single size class. Chunk sizes grow geometrically from the
+ * smallest class to the whole page, so any request wastes at most (factor - 1) of its size inside the
+ * chunk, and memory is never fragmented below page granularity: page is assigned to a class when the
+ * class runs out of chunks and goes back to the pool of free pages once all its chunks are freed.
+ *
+ * Pages are aligned to kPageSize, so chunk finds its page, and the allocator, by address alone. Up to a
+ * page of the area could be lost for alignment.
+ *
+ * Allocator instance doesn't take ownership of wrapped memory and do not delete it on destruction.
+ * All methods are thread safe.
+ */
+class Slab {
+public:
+    // Number of bytes in each page, alignment of pages
+    static constexpr size_t kPageSize = 1 << 20;
+
+    // Number of bytes in the smallest chunk
+    static constexpr size_t kMinChunk = 64;
+
+    /**
+     * @param base start of memory area
+     * @param size number of bytes in the area
+     * @param factor ratio of chunk sizes of the adjacent classes, greater than 1
+     */
+    Slab(void *base, size_t size, double factor = 1.25);
+    ~Slab() {}
+
+    Slab(const Slab &) = delete;
+    Slab &operator=(const Slab &) = delete;
+
+    /**
+     * Allocates chunk of the smallest class that has room for size bytes. Throws AllocError of
+     * NoMemory type if size is greater than the largest chunk, or if the class has no free chunks
+     * and there are no free pages left
+     */
+    void *alloc(size_t size);
+
+    /**
+     * Same as alloc, but returns nullptr instead of throwing
+     */
+    void *try_alloc(size_t size);
+
+    /**
+     * Assigns a free page to the given class ahead of its allocations, so that no other class could take it.
+     * Page goes back to the pool the usual way, once all its chunks are freed. Returns false if there are no
+     * free pages
+     */
+    bool assign(size_t cls);
+
+    /**
+     * Returns chunk to the allocator it came from, could be called from any thread
+     */
+    static void free(void *p);
+
+    /**
+     * Start of the page chunk belongs to, chunks of the same page free it together
+     */
+    static const void *page_of(const void *p) {
+        return reinterpret_cast<const void *>(reinterpret_cast<uintptr_t>(p) & ~uintptr_t(kPageSize - 1));
+    }
+
+    /**
+     * Number of size classes
+     */
+    size_t classes() const { return _classes.size(); }
+
+    /**
+     * Class of chunks serving requests of the given size, classes() if size doesn't fit into any chunk
+     */
+    size_t class_of(size_t size) const;
+
+    /**
+     * Number of bytes in chunks of the given class
+     */
+    size_t chunk_size(size_t cls) const { return _classes[cls].size; }
+
+    /**
+     * True if chunk for size bytes could be allocated right now
+     */
+    bool available(size_t size) const;
+
+    /**
+     * Number of pages in the area and number of them not assigned to any class
+     */
+    size_t pages() const { return _pages; }
+    size_t free_pages() const;
+
+    /**
+     * Number of pages assigned to the given class and number of chunks allocated from it
+     */
+    size_t class_pages(size_t cls) const;
+    size_t class_used(size_t cls) const;
+
+    /**
+     * Human readable state of every class that has pages
+     */
+    std::string dump() const;
+
+private:
+    struct Page;
+
+    struct Class {
+        // Number of bytes in each chunk
+        size_t size;
+        // Number of chunks fitting into page
+        size_t per_page;
+        // Pages having free chunks
+        Page *partial;
+        // Number of pages and chunks taken by the class
+        size_t pages;
+        size_t used;
+    };
+
+    // Memory of the given page
+    Page *page(size_t index) const;
+
+    // Page list helpers, lists are doubly linked through Page::prev/next
+    static void push(Page *&head, Page *page);
+    static void unlink(Page *&head, Page *page);
+
+    // Moves free page to the class, nullptr if there are no free pages. Lock must be held
+    Page *assign_page(size_t cls);
+
+    // Takes chunk from the class, nullptr if there is no room. Lock must be held
+    void *take(size_t cls);
+
+    // Puts chunk back to its page. Lock must be held
+    void release(Page *page, void *p);
+
+    mutable std::mutex _lock;
+
+    // First aligned page and number of pages in the area
+    char *_base;
+    size_t _pages;
+
+    // Pages not assigned to any class
+    Page *_free;
+    size_t _free_count;
+
+    std::vector<Class> _classes;
+};
+
+} // namespace Allocator
+} // namespace Afina
+
+#endif // AFINA_ALLOCATOR_SLAB_H
@@ -0,0 +1,61 @@
+#ifndef AFINA_ALLOCATOR_SLAB_CACHE_H
+#define AFINA_ALLOCATOR_SLAB_CACHE_H
+
+#include <cstddef>
+#include <vector>
+
+namespace Afina {
+namespace Allocator {
+
+// Forward declaration. Do not include real class definition
+// to avoid expensive macros calculations and increase compile speed
+class Arena;
+
+/**
+ * # Per-thread slab cache
+ * The second tier of the Arena -> SlabCache -> Mempool allocator. Keeps a few empty slabs of the
+ * thread, so that pools of the thread growing and shrinking around slab boundary don't go to the
+ * shared arena every time. Slabs above the limit are returned to the arena right away.
+ *
+ * Cache belongs to a single thread and does no synchronization at all. Cached slabs are returned to
+ * the arena on destruction.
+ */
+class SlabCache {
+public:
+    /**
+     * @param arena arena to take slabs from
+     * @param limit maximum number of empty slabs kept
+     */
+    SlabCache(Arena &arena, size_t limit = 4);
+    ~SlabCache();
+
+    SlabCache(const SlabCache &) = delete;
+    SlabCache &operator=(const SlabCache &) = delete;
+
+    /**
+     * Empty slab, either cached or taken from the arena. nullptr if arena has no slabs left
+     */
+    void *take();
+
+    /**
+     * Keeps empty slab for later or returns it to the arena
+     */
+    void put(void *slab);
+
+    /**
+     * Number of empty slabs kept right now
+     */
+    size_t cached() const { return _slabs.size(); }
+
+    Arena &arena() const { return _arena; }
+
+private:
+    Arena &_arena;
+    const size_t _limit;
+    std::vector<void *> _slabs;
+};
+
+} // namespace Allocator
+} // namespace Afina
+
+#endif // AFINA_ALLOCATOR_SLAB_CACHE_H
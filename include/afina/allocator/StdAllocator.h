@@ -0,0 +1,91 @@
+#ifndef AFINA_ALLOCATOR_STD_ALLOCATOR_H
+#define AFINA_ALLOCATOR_STD_ALLOCATOR_H
+
+#include <cstddef>
+#include <limits>
+#include <new>
+#include <type_traits>
+
+#include <afina/allocator/Error.h>
+#include <afina/allocator/Pointer.h>
+#include <afina/allocator/Simple.h>
+
+namespace Afina {
+namespace Allocator {
+
+/**
+ * Standard allocator on the top of Simple, lets containers keep their memory in the bounded area
+ * wrapped by the allocator:
+ *
+ *   Simple arena(buffer, size);
+ *   std::vector<int, StdAllocator<int>> v{StdAllocator<int>(arena)};
+ *
+ * Adapter is stateful: it refers to the arena, copies and rebound copies refer to the same one and
+ * compare equal, adapters over different arenas are not interchangeable. Adapter goes along with
+ * container contents on copy, move and swap, so memory is always returned to the arena it came from.
+ *
+ * Containers keep plain addresses, so blocks handed out through the adapter must stay in place: arena
+ * must not be defragmented while any container allocated from it is alive. Arena doesn't lock, so
+ * all containers over it must be used from one thread at a time.
+ *
+ * Failures are reported with std::bad_alloc, as containers expect.
+ */
+template <typename T> class StdAllocator {
+    static_assert(alignof(T) <= 16, "Simple blocks are only 16 bytes aligned");
+
+public:
+    using value_type = T;
+    using pointer = T *;
+    using const_pointer = const T *;
+    using reference = T &;
+    using const_reference = const T &;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+    using is_always_equal = std::false_type;
+
+    template <typename U> struct rebind { using other = StdAllocator<U>; };
+
+    explicit StdAllocator(Simple &arena) : _arena(&arena) {}
+
+    template <typename U> StdAllocator(const StdAllocator<U> &other) : _arena(other.arena()) {}
+
+    T *allocate(std::size_t n) {
+        if (n > max_size()) {
+            throw std::bad_alloc();
+        }
+        try {
+            return static_cast<T *>(_arena->alloc(n * sizeof(T)).get());
+        } catch (AllocError &) {
+            throw std::bad_alloc();
+        }
+    }
+
+    void deallocate(T *p, std::size_t) {
+        Pointer handle = _arena->handle_of(p);
+        _arena->free(handle);
+    }
+
+    std::size_t max_size() const { return std::numeric_limits<std::size_t>::max() / sizeof(T); }
+
+    Simple *arena() const { return _arena; }
+
+private:
+    Simple *_arena;
+};
+
+template <typename T, typename U> bool operator==(const StdAllocator<T> &a, const StdAllocator<U> &b) {
+    return a.arena() == b.arena();
+}
+
+template <typename T, typename U> bool operator!=(const StdAllocator<T> &a, const StdAllocator<U> &b) {
+    return a.arena() != b.arena();
+}
+
+} // namespace Allocator
+} // namespace Afina
+
+#endif // AFINA_ALLOCATOR_STD_ALLOCATOR_H
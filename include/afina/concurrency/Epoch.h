@@ -0,0 +1,128 @@
+#ifndef AFINA_CONCURRENCY_EPOCH_H
+#define AFINA_CONCURRENCY_EPOCH_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace Afina {
+namespace Concurrency {
+
+// State of the domain shared with the threads using it, see Epoch.cpp
+struct EpochState;
+
+/**
+ * # Epoch based memory reclamation
+ * Lets lock free readers dereference shared objects while writers unlink and free them. Reader pins the
+ * domain for the time it holds pointers to shared objects, see EpochGuard. Writer unlinks object so that
+ * new readers can't reach it and retires it instead of freeing. Object is freed once every reader that
+ * could have seen it is gone.
+ *
+ * Domain has a global epoch. Pinned thread publishes the epoch it has seen, and epoch only moves forward
+ * once every pinned thread has seen the current one. Retired objects are collected in per-thread bags,
+ * full bag is stamped with the current epoch and handed over to the domain, so that any thread could free
+ * it, even if the one that filled it never calls the domain again. Bag is freed once epoch is two steps
+ * ahead of its stamp: by then every thread pinned when its objects were retired has unpinned.
+ *
+ * Pin and unpin only touch the thread own slot: a store and a fence, nested pins are just a counter.
+ *
+ * Thread pinned for long holds the epoch, so garbage piles up. To keep it bounded, thread that retires
+ * while not pinned and finds more than max_garbage objects in handed over bags waits until enough of
+ * them is freed. Thread retiring while pinned never waits, since it could wait for itself.
+ *
+ * Domain must outlive its guards and nobody may be pinned when it is destroyed, whatever is still
+ * retired is freed by destructor. Every method is thread safe.
+ */
+class EpochDomain {
+public:
+    // Frees retired object
+    using Deleter = void (*)(void *object);
+
+    // Number of objects in bag, bag is handed over to domain once it is full
+    static constexpr size_t kBagSize = 64;
+
+    /**
+     * @param max_threads number of threads that could use domain at once, pin from one more thread
+     * throws std::runtime_error
+     * @param max_garbage number of retired objects in handed over bags unpinned retire waits on
+     */
+    EpochDomain(size_t max_threads = 256, size_t max_garbage = 1 << 16);
+    ~EpochDomain();
+
+    EpochDomain(const EpochDomain &) = delete;
+    EpochDomain &operator=(const EpochDomain &) = delete;
+
+    /**
+     * Pins calling thread: objects it reads from now on aren't freed until it unpins. Pins nest
+     */
+    void pin();
+
+    /**
+     * Drops one pin of the calling thread
+     */
+    void unpin();
+
+    /**
+     * True if calling thread is pinned
+     */
+    bool pinned();
+
+    /**
+     * Defers deleter(object) until no thread could hold object. Object must be unreachable for the
+     * threads pinning domain from now on
+     */
+    void retire(void *object, Deleter deleter);
+
+    /**
+     * Defers delete of the object, see above
+     */
+    template <typename T> void retire(T *object) {
+        retire(object, [](void *p) { delete static_cast<T *>(p); });
+    }
+
+    /**
+     * Hands over objects retired by the calling thread, so that they could be freed without waiting for
+     * its bag to fill up
+     */
+    void flush();
+
+    /**
+     * Moves epoch forward if every pinned thread has seen the current one and frees bags that are old
+     * enough. Returns number of objects freed
+     */
+    size_t collect();
+
+    /**
+     * Current epoch
+     */
+    uint64_t epoch() const;
+
+    /**
+     * Number of objects retired and not freed yet
+     */
+    size_t pending() const;
+
+private:
+    std::shared_ptr<EpochState> _state;
+};
+
+/**
+ * Scoped pin of the epoch domain
+ */
+class EpochGuard {
+public:
+    explicit EpochGuard(EpochDomain &domain) : _domain(domain) { _domain.pin(); }
+    ~EpochGuard() { _domain.unpin(); }
+
+    EpochGuard(const EpochGuard &) = delete;
+    EpochGuard &operator=(const EpochGuard &) = delete;
+
+private:
+    EpochDomain &_domain;
+};
+
+} // namespace Concurrency
+} // namespace Afina
+
+#endif // AFINA_CONCURRENCY_EPOCH_H
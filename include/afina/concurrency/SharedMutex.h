@@ -0,0 +1,58 @@
+#ifndef AFINA_CONCURRENCY_SHARED_MUTEX_H
+#define AFINA_CONCURRENCY_SHARED_MUTEX_H
+
+#include <pthread.h>
+#include <stdexcept>
+
+namespace Afina {
+namespace Concurrency {
+
+/**
+ * # Readers-writer lock
+ * Thin wrapper over pthread rwlock, there is no std::shared_mutex in C++11. Satisfies Lockable
+ * so that exclusive side could be used with std::lock_guard/std::unique_lock, shared side goes
+ * through SharedLock below
+ */
+class SharedMutex {
+public:
+    SharedMutex() {
+        if (pthread_rwlock_init(&_lock, nullptr) != 0) {
+            throw std::runtime_error("Failed to create rwlock");
+        }
+    }
+    ~SharedMutex() { pthread_rwlock_destroy(&_lock); }
+
+    void lock() { pthread_rwlock_wrlock(&_lock); }
+    bool try_lock() { return pthread_rwlock_trywrlock(&_lock) == 0; }
+    void unlock() { pthread_rwlock_unlock(&_lock); }
+
+    void lock_shared() { pthread_rwlock_rdlock(&_lock); }
+    bool try_lock_shared() { return pthread_rwlock_tryrdlock(&_lock) == 0; }
+    void unlock_shared() { pthread_rwlock_unlock(&_lock); }
+
+private:
+    SharedMutex(const SharedMutex &);            // = delete;
+    SharedMutex &operator=(const SharedMutex &); // = delete;
+
+    pthread_rwlock_t _lock;
+};
+
+/**
+ * Scoped shared ownership of SharedMutex
+ */
+class SharedLock {
+public:
+    explicit SharedLock(SharedMutex &mutex) : _mutex(mutex) { _mutex.lock_shared(); }
+    ~SharedLock() { _mutex.unlock_shared(); }
+
+private:
+    SharedLock(const SharedLock &);            // = delete;
+    SharedLock &operator=(const SharedLock &); // = delete;
+
+    SharedMutex &_mutex;
+};
+
+} // namespace Concurrency
+} // namespace Afina
+
+#endif // AFINA_CONCURRENCY_SHARED_MUTEX_H
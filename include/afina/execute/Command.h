@@ -2,6 +2,9 @@
 #define AFINA_EXECUTE_COMMAND_H
 
 #include <string>
+#include <vector>
+
+#include <afina/ValueView.h>
 
 namespace Afina {
 
@@ -19,6 +22,13 @@ public:
     virtual ~Command() {}
 
     virtual void Execute(Storage &storage, const std::string &args, std::string &out) = 0;
+
+    /**
+     * Same as Execute, but response is produced as a sequence of buffers that should be sent in order,
+     * so that network layer could pass stored values to writev without copying them. Default one
+     * wraps response of Execute
+     */
+    virtual void ExecuteVectored(Storage &storage, const std::string &args, std::vector<ValueView> &out);
 };
 
 } // namespace Execute
@@ -0,0 +1,45 @@
+#ifndef AFINA_EXECUTE_COUNTER_COMMAND_H
+#define AFINA_EXECUTE_COUNTER_COMMAND_H
+
+#include <cstdint>
+#include <string>
+
+#include <afina/Storage.h>
+
+#include "Command.h"
+
+namespace Afina {
+namespace Execute {
+
+/**
+ * # Basic class for counter commands
+ * Value of the key must be a decimal representation of unsigned 64-bit integer
+ *
+ * Command must write result to the output, which could be:
+ * - new value of the counter, to indicate success
+ * - "NOT_FOUND" to indicate that the item with this key was not found
+ * - "CLIENT_ERROR ..." if value isn't a number
+ * - "SERVER_ERROR ..." if counter doesn't fit into storage
+ */
+class CounterCommand : public Command {
+public:
+    CounterCommand(const std::string &key, uint64_t delta) : _key(key), _delta(delta) {}
+    ~CounterCommand() {}
+
+    inline const std::string &key() const { return _key; }
+    inline uint64_t delta() const { return _delta; }
+
+protected:
+    /**
+     * Renders outcome of the counter update
+     */
+    void response(DeltaResult result, uint64_t value, std::string &out) const;
+
+    const std::string _key;
+    const uint64_t _delta;
+};
+
+} // namespace Execute
+} // namespace Afina
+
+#endif // AFINA_EXECUTE_COUNTER_COMMAND_H
@@ -0,0 +1,28 @@
+#ifndef AFINA_EXECUTE_DECR_H
+#define AFINA_EXECUTE_DECR_H
+
+#include <cstdint>
+#include <string>
+
+#include "CounterCommand.h"
+
+namespace Afina {
+namespace Execute {
+
+/**
+ * # Decrement counter
+ * Subtracts given amount from the counter stored under the key, counter never goes below 0.
+ * See CounterCommand for possible results
+ */
+class Decr : public CounterCommand {
+public:
+    Decr(const std::string &key, uint64_t delta) : CounterCommand(key, delta) {}
+    ~Decr() {}
+
+    void Execute(Storage &storage, const std::string &args, std::string &out) override;
+};
+
+} // namespace Execute
+} // namespace Afina
+
+#endif // AFINA_EXECUTE_DECR_H
@@ -4,6 +4,8 @@
 #include <string>
 #include <vector>
 
+#include <afina/Storage.h>
+
 #include "Command.h"
 
 namespace Afina {
@@ -18,13 +20,15 @@ namespace Execute {
  * the items have been transmitted, the server sends the string
  *
  * Each item sent by the server looks like this:
- * VALUE <key> <bytes>\r\n
+ * VALUE <key> <flags> <bytes> [<cas unique>]\r\n
  * <data>\r\n
  * VALUE ....
  * END
  *
- * Where <key> is the key for the value, <bytes> is the number of bytes in the
- * value and <data> is the value text
+ * Where <key> is the key for the value, <flags> is the number client set along
+ * with the value, <bytes> is the number of bytes in the value and <data> is the
+ * value text. <cas unique> is the version of the value
+ * to pass to "cas" command, it is sent for "gets" only
  *
  * If some of the keys appearing in a retrieval request are not sent back
  * by the server in the item list this means that the server does not
@@ -34,15 +38,25 @@ namespace Execute {
  */
 class Get : public Command {
 public:
-    Get(const std::vector<std::string> &keys) : _keys(keys) {}
+    Get(const std::vector<std::string> &keys, bool cas = false) : _keys(keys), _cas(cas) {}
     ~Get() {}
 
     inline const std::vector<std::string> &keys() const { return _keys; }
+    inline bool cas() const { return _cas; }
 
     void Execute(Storage &storage, const std::string &args, std::string &out) override;
 
+    // Values are passed as views of the storage memory, see Storage::GetView
+    void ExecuteVectored(Storage &storage, const std::string &args, std::vector<ValueView> &out) override;
+
 private:
+    // Appends text line that preceeds value of the i-th key
+    void header(std::string &out, size_t i, const ValueView &value, const ValueInfo &info) const;
+
     std::vector<std::string> _keys;
+
+    // Versions of values are requested, i.e it is "gets"
+    bool _cas;
 };
 
 } // namespace Execute
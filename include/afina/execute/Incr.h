@@ -0,0 +1,28 @@
+#ifndef AFINA_EXECUTE_INCR_H
+#define AFINA_EXECUTE_INCR_H
+
+#include <cstdint>
+#include <string>
+
+#include "CounterCommand.h"
+
+namespace Afina {
+namespace Execute {
+
+/**
+ * # Increment counter
+ * Adds given amount to the counter stored under the key, the sum wraps around 2^64.
+ * See CounterCommand for possible results
+ */
+class Incr : public CounterCommand {
+public:
+    Incr(const std::string &key, uint64_t delta) : CounterCommand(key, delta) {}
+    ~Incr() {}
+
+    void Execute(Storage &storage, const std::string &args, std::string &out) override;
+};
+
+} // namespace Execute
+} // namespace Afina
+
+#endif // AFINA_EXECUTE_INCR_H
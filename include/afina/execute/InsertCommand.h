@@ -23,6 +23,14 @@ public:
     inline const int32_t expire() const { return _expire; }
 
 protected:
+    /**
+     * Converts memcached <exptime> into number of seconds item lives: up to 30 days it is relative
+     * time, otherwise it is absolute unix time. 0 means item never expires.
+     *
+     * Returns false if item is expired already: <exptime> is negative or absolute time is passed
+     */
+    bool ttl(uint32_t &seconds) const;
+
     const std::string _key;
     const uint32_t _flags;
     const int32_t _expire;
@@ -0,0 +1,53 @@
+#include <afina/allocator/Arena.h>
+
+#include <algorithm>
+
+namespace Afina {
+namespace Allocator {
+
+constexpr size_t Arena::kSlabSize;
+
+Arena::Arena(void *base, size_t size) : _carved(0), _free(0), _used(0) {
+    uintptr_t start = reinterpret_cast<uintptr_t>(base);
+    uintptr_t aligned = (start + kSlabSize - 1) & ~uintptr_t(kSlabSize - 1);
+    size_t slabs = (aligned - start < size) ? (size - (aligned - start)) / kSlabSize : 0;
+
+    _base = reinterpret_cast<char *>(aligned);
+    _slabs = uint32_t(std::min<size_t>(slabs, UINT32_MAX - 1));
+    _next.reset(new std::atomic<uint32_t>[_slabs]);
+}
+
+void *Arena::take() {
+    uint64_t head = _free.load(std::memory_order_acquire);
+    while (uint32_t(head) != 0) {
+        // Tag changes on every pop, so that head popped and pushed back meanwhile fails the exchange
+        uint32_t index = uint32_t(head) - 1;
+        uint64_t next = ((head >> 32) + 1) << 32 | _next[index].load(std::memory_order_relaxed);
+        if (_free.compare_exchange_weak(head, next, std::memory_order_acquire, std::memory_order_acquire)) {
+            _used.fetch_add(1, std::memory_order_relaxed);
+            return _base + size_t(index) * kSlabSize;
+        }
+    }
+
+    uint32_t carved = _carved.load(std::memory_order_relaxed);
+    while (carved < _slabs) {
+        if (_carved.compare_exchange_weak(carved, carved + 1, std::memory_order_relaxed)) {
+            _used.fetch_add(1, std::memory_order_relaxed);
+            return _base + size_t(carved) * kSlabSize;
+        }
+    }
+    return nullptr;
+}
+
+void Arena::put(void *slab) {
+    uint32_t index = uint32_t((static_cast<char *>(slab) - _base) / kSlabSize);
+    uint64_t head = _free.load(std::memory_order_relaxed);
+    do {
+        _next[index].store(uint32_t(head), std::memory_order_relaxed);
+    } while (!_free.compare_exchange_weak(head, pack(head >> 32, index), std::memory_order_release,
+                                          std::memory_order_relaxed));
+    _used.fetch_sub(1, std::memory_order_relaxed);
+}
+
+} // namespace Allocator
+} // namespace Afina
@@ -0,0 +1,166 @@
+#include <afina/allocator/Mempool.h>
+
+#include <string>
+
+#include <afina/allocator/Arena.h>
+#include <afina/allocator/Error.h>
+#include <afina/allocator/SlabCache.h>
+
+namespace Afina {
+namespace Allocator {
+
+/**
+ * Header in the beginning of every slab, objects follow it
+ */
+struct Mempool::SlabHeader {
+    Mempool *owner;
+
+    // Links in the list of partial slabs
+    SlabHeader *prev;
+    SlabHeader *next;
+
+    // Objects freed since slab was taken
+    void *free_list;
+
+    // Number of objects given out and number of objects ever cut from the slab memory
+    size_t used;
+    size_t carved;
+
+    char *objects() { return reinterpret_cast<char *>(this) + kHeaderSize; }
+
+    // Header takes a multiple of the object alignment
+    static constexpr size_t kHeaderSize = 64;
+};
+
+constexpr size_t Mempool::SlabHeader::kHeaderSize;
+
+Mempool::Mempool(SlabCache &cache, size_t object_size)
+    : _cache(cache), _object_size((object_size + 15) & ~size_t(15)), _partial(nullptr), _slabs(0), _used(0),
+      _remote(nullptr) {
+    static_assert(sizeof(SlabHeader) <= SlabHeader::kHeaderSize, "Slab header doesn't fit");
+    if (_object_size == 0 || _object_size > Arena::kSlabSize - SlabHeader::kHeaderSize) {
+        throw AllocError(AllocErrorType::NoMemory, "Object of " + std::to_string(object_size) +
+                                                       " bytes doesn't fit into slab");
+    }
+    _per_slab = (Arena::kSlabSize - SlabHeader::kHeaderSize) / _object_size;
+}
+
+Mempool::~Mempool() {
+    // Slab goes back to the cache as soon as it is empty, see release(), so slabs left after the queue is
+    // drained hold live objects and must not be handed out again
+    collect();
+}
+
+void Mempool::push(SlabHeader *&head, SlabHeader *slab) {
+    slab->prev = nullptr;
+    slab->next = head;
+    if (head != nullptr) {
+        head->prev = slab;
+    }
+    head = slab;
+}
+
+void Mempool::unlink(SlabHeader *&head, SlabHeader *slab) {
+    if (slab->prev != nullptr) {
+        slab->prev->next = slab->next;
+    } else {
+        head = slab->next;
+    }
+    if (slab->next != nullptr) {
+        slab->next->prev = slab->prev;
+    }
+}
+
+void *Mempool::alloc() {
+    void *p = try_alloc();
+    if (p == nullptr) {
+        throw AllocError(AllocErrorType::NoMemory, "No free slab for " + std::to_string(_object_size) + " bytes");
+    }
+    return p;
+}
+
+void *Mempool::try_alloc() {
+    if (_partial == nullptr) {
+        collect();
+    }
+
+    SlabHeader *slab = _partial;
+    if (slab == nullptr) {
+        slab = static_cast<SlabHeader *>(_cache.take());
+        if (slab == nullptr) {
+            return nullptr;
+        }
+        slab->owner = this;
+        slab->free_list = nullptr;
+        slab->used = 0;
+        slab->carved = 0;
+        push(_partial, slab);
+        _slabs++;
+    }
+
+    void *p;
+    if (slab->free_list != nullptr) {
+        p = slab->free_list;
+        slab->free_list = *static_cast<void **>(p);
+    } else {
+        p = slab->objects() + slab->carved * _object_size;
+        slab->carved++;
+    }
+    slab->used++;
+    _used++;
+    if (slab->used == _per_slab) {
+        unlink(_partial, slab);
+    }
+    return p;
+}
+
+void Mempool::free(void *p) {
+    if (p == nullptr) {
+        return;
+    }
+    SlabHeader *slab = static_cast<SlabHeader *>(Arena::slab_of(p));
+    Mempool *owner = slab->owner;
+    if (owner == this) {
+        release(slab, p);
+        return;
+    }
+
+    // Foreign object goes to the queue of its owner, any number of threads could push concurrently
+    void *head = owner->_remote.load(std::memory_order_relaxed);
+    do {
+        *static_cast<void **>(p) = head;
+    } while (!owner->_remote.compare_exchange_weak(head, p, std::memory_order_release, std::memory_order_relaxed));
+}
+
+void Mempool::release(SlabHeader *slab, void *p) {
+    bool was_full = (slab->used == _per_slab);
+    *static_cast<void **>(p) = slab->free_list;
+    slab->free_list = p;
+    slab->used--;
+    _used--;
+
+    if (slab->used == 0) {
+        if (!was_full) {
+            unlink(_partial, slab);
+        }
+        _slabs--;
+        _cache.put(slab);
+    } else if (was_full) {
+        push(_partial, slab);
+    }
+}
+
+void Mempool::collect() {
+    if (_remote.load(std::memory_order_relaxed) == nullptr) {
+        return;
+    }
+    void *p = _remote.exchange(nullptr, std::memory_order_acquire);
+    while (p != nullptr) {
+        void *next = *static_cast<void **>(p);
+        release(static_cast<SlabHeader *>(Arena::slab_of(p)), p);
+        p = next;
+    }
+}
+
+} // namespace Allocator
+} // namespace Afina
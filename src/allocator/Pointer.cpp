@@ -1,14 +1,59 @@
 #include <afina/allocator/Pointer.h>
 
+#include <cstring>
+
 namespace Afina {
 namespace Allocator {
 
-Pointer::Pointer() {}
-Pointer::Pointer(const Pointer &) {}
-Pointer::Pointer(Pointer &&) {}
+Pointer::Pointer() : _slots(nullptr), _index(0), _generation(0) {}
+Pointer::Pointer(const Pointer &other) : _slots(other._slots), _index(other._index), _generation(other._generation) {}
+Pointer::Pointer(Pointer &&other) : _slots(other._slots), _index(other._index), _generation(other._generation) {
+    other._slots = nullptr;
+}
+
+Pointer &Pointer::operator=(const Pointer &other) {
+    _slots = other._slots;
+    _index = other._index;
+    _generation = other._generation;
+    return *this;
+}
+
+Pointer &Pointer::operator=(Pointer &&other) {
+    if (this != &other) {
+        *this = static_cast<const Pointer &>(other);
+        other._slots = nullptr;
+    }
+    return *this;
+}
+
+bool Pointer::read(void *out, size_t size) const {
+    if (_slots == nullptr) {
+        return false;
+    }
+
+    // Sequence lock: copy is valid only if no move started or finished while it was made
+    const HandleSlot &slot = _slots[-std::ptrdiff_t(_index)];
+    while (true) {
+        uint32_t moves = slot.moves.load(std::memory_order_acquire);
+        if (moves % 2 != 0) {
+            continue;
+        }
+        void *address = slot.address.load(std::memory_order_acquire);
+        if (slot.generation.load(std::memory_order_acquire) != _generation) {
+            return false;
+        }
+        std::memcpy(out, address, size);
+        std::atomic_thread_fence(std::memory_order_acquire);
 
-Pointer &Pointer::operator=(const Pointer &) { return *this; }
-Pointer &Pointer::operator=(Pointer &&) { return *this; }
+        // Block could be freed, and even reallocated, while it was copied
+        if (slot.generation.load(std::memory_order_relaxed) != _generation) {
+            return false;
+        }
+        if (slot.moves.load(std::memory_order_relaxed) == moves) {
+            return true;
+        }
+    }
+}
 
 } // namespace Allocator
 } // namespace Afina
@@ -0,0 +1,103 @@
+#include <afina/allocator/Region.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <afina/allocator/Error.h>
+
+#ifndef MADV_POPULATE_WRITE
+#define MADV_POPULATE_WRITE 23
+#endif
+
+namespace Afina {
+namespace Allocator {
+
+constexpr size_t Region::kHugePageSize;
+
+static size_t round_up(size_t size, size_t align) { return (size + align - 1) / align * align; }
+
+Region::Region(size_t size, HugePages huge_pages) : _data(MAP_FAILED), _size(0), _huge_pages(huge_pages) {
+    size = std::max<size_t>(size, 1);
+    const int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+    if (_huge_pages == HugePages::Explicit) {
+        _size = round_up(size, kHugePageSize);
+        _data = mmap(nullptr, _size, PROT_READ | PROT_WRITE, flags | MAP_HUGETLB, -1, 0);
+        if (_data == MAP_FAILED) {
+            // Pool is empty or not configured at all
+            _huge_pages = HugePages::Transparent;
+        }
+    }
+
+    if (_huge_pages == HugePages::Transparent) {
+        // Kernel only uses huge pages for aligned parts of the mapping, so map more and trim the edges
+        _size = round_up(size, kHugePageSize);
+        void *raw = mmap(nullptr, _size + kHugePageSize, PROT_READ | PROT_WRITE, flags, -1, 0);
+        if (raw != MAP_FAILED) {
+            uintptr_t start = reinterpret_cast<uintptr_t>(raw);
+            uintptr_t aligned = round_up(start, kHugePageSize);
+            if (aligned > start) {
+                munmap(raw, aligned - start);
+            }
+            if (start + kHugePageSize > aligned) {
+                munmap(reinterpret_cast<void *>(aligned + _size), start + kHugePageSize - aligned);
+            }
+            _data = reinterpret_cast<void *>(aligned);
+            if (madvise(_data, _size, MADV_HUGEPAGE) != 0) {
+                _huge_pages = HugePages::None;
+            }
+        } else {
+            _huge_pages = HugePages::None;
+        }
+    }
+
+    if (_data == MAP_FAILED) {
+        _size = round_up(size, size_t(sysconf(_SC_PAGESIZE)));
+        _data = mmap(nullptr, _size, PROT_READ | PROT_WRITE, flags, -1, 0);
+        if (_data == MAP_FAILED) {
+            throw AllocError(AllocErrorType::NoMemory, "Failed to map " + std::to_string(size) +
+                                                           " bytes: " + std::strerror(errno));
+        }
+    }
+}
+
+Region::~Region() { munmap(_data, _size); }
+
+std::chrono::milliseconds Region::prefault(size_t n_threads) {
+    auto start = std::chrono::steady_clock::now();
+
+    // Threads get whole huge pages, so that none of them is split between two threads
+    const size_t page = size_t(sysconf(_SC_PAGESIZE));
+    const size_t chunk = round_up(_size / (n_threads > 0 ? n_threads : 1), kHugePageSize);
+    std::vector<std::thread> threads;
+    for (size_t offset = 0; offset < _size; offset += chunk) {
+        threads.emplace_back([this, offset, chunk, page]() {
+            char *begin = static_cast<char *>(_data) + offset;
+            size_t length = std::min(chunk, _size - offset);
+            if (madvise(begin, length, MADV_POPULATE_WRITE) == 0) {
+                return;
+            }
+
+            // Kernel older than 5.14: write every page with the value it already has
+            for (size_t i = 0; i < length; i += page) {
+                volatile char *p = begin + i;
+                *p = *p;
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+}
+
+} // namespace Allocator
+} // namespace Afina
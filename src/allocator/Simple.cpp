@@ -1,40 +1,319 @@
 #include <afina/allocator/Simple.h>
 
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <sstream>
+
+#include <afina/allocator/Error.h>
 #include <afina/allocator/Pointer.h>
 
 namespace Afina {
 namespace Allocator {
 
-Simple::Simple(void *base, size_t size) : _base(base), _base_len(size) {}
-
 /**
- * TODO: semantics
- * @param N size_t
+ * Header in front of every block, hole included
  */
-Pointer Simple::alloc(size_t N) { return Pointer(); }
+struct Simple::Block {
+    // Number of bytes after the header
+    size_t size;
 
-/**
- * TODO: semantics
- * @param p Pointer
- * @param N size_t
- */
-void Simple::realloc(Pointer &p, size_t N) {}
+    // Handle slot of the block, nullptr for a hole
+    HandleSlot *slot;
 
-/**
- * TODO: semantics
- * @param p Pointer
- */
-void Simple::free(Pointer &p) {}
+    char *data() { return reinterpret_cast<char *>(this + 1); }
+    Block *next() { return reinterpret_cast<Block *>(data() + size); }
+};
 
-/**
- * TODO: semantics
- */
-void Simple::defrag() {}
+// Blocks sizes and addresses are multiples of it
+static const size_t kAlign = 16;
 
-/**
- * TODO: semantics
- */
-std::string Simple::dump() const { return ""; }
+static size_t round_up(size_t size) { return (size + kAlign - 1) & ~(kAlign - 1); }
+
+// Readers copying block through Pointer::read retry if block moves meanwhile, see Pointer.cpp
+static void begin_move(HandleSlot *slot) {
+    slot->moves.store(slot->moves.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+static void end_move(HandleSlot *slot, void *address) {
+    slot->address.store(address, std::memory_order_release);
+    slot->moves.store(slot->moves.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+Simple::Simple(void *base, size_t size) : _base(base), _base_len(size), _free_slots(nullptr) {
+    static_assert(sizeof(Block) % kAlign == 0, "Block header breaks alignment");
+
+    uintptr_t start = reinterpret_cast<uintptr_t>(base);
+    uintptr_t end = start + size;
+    uintptr_t begin = (start + kAlign - 1) & ~uintptr_t(kAlign - 1);
+    uintptr_t table_end = end & ~uintptr_t(alignof(HandleSlot) - 1);
+    if (begin > table_end) {
+        begin = table_end;
+    }
+
+    _begin = reinterpret_cast<char *>(begin);
+    _top = _begin;
+    _first_hole = _begin;
+    _table_end = reinterpret_cast<HandleSlot *>(table_end);
+    _table = _table_end;
+}
+
+HandleSlot *Simple::take_slot() {
+    if (_free_slots != nullptr) {
+        HandleSlot *slot = _free_slots;
+        _free_slots = static_cast<HandleSlot *>(slot->address.load(std::memory_order_relaxed));
+        return slot;
+    }
+    if (size_t(reinterpret_cast<char *>(_table) - _top) < sizeof(HandleSlot) || _table_end - _table > UINT32_MAX) {
+        throw AllocError(AllocErrorType::NoMemory, "No room for handle slot");
+    }
+    HandleSlot *slot = new (--_table) HandleSlot;
+    slot->generation.store(0, std::memory_order_relaxed);
+    slot->moves.store(0, std::memory_order_relaxed);
+    return slot;
+}
+
+Simple::Block *Simple::find_hole(size_t size) {
+    Block *first = nullptr;
+    for (Block *block = reinterpret_cast<Block *>(_first_hole); reinterpret_cast<char *>(block) < _top;
+         block = block->next()) {
+        if (block->slot != nullptr) {
+            continue;
+        }
+        while (reinterpret_cast<char *>(block->next()) < _top && block->next()->slot == nullptr) {
+            block->size += sizeof(Block) + block->next()->size;
+        }
+        if (reinterpret_cast<char *>(block->next()) == _top) {
+            // Hole at the very end is just unused memory
+            _top = reinterpret_cast<char *>(block);
+            break;
+        }
+        if (first == nullptr) {
+            first = block;
+        }
+        if (block->size >= size) {
+            split(block, size);
+            if (first == block) {
+                _first_hole = reinterpret_cast<char *>(block->next());
+            }
+            return block;
+        }
+    }
+    _first_hole = (first != nullptr) ? reinterpret_cast<char *>(first) : _top;
+    return nullptr;
+}
+
+Simple::Block *Simple::extend(size_t size) {
+    if (size_t(reinterpret_cast<char *>(_table) - _top) < sizeof(Block) + size) {
+        return nullptr;
+    }
+    Block *block = reinterpret_cast<Block *>(_top);
+    block->size = size;
+    _top = reinterpret_cast<char *>(block->next());
+    if (_first_hole == reinterpret_cast<char *>(block)) {
+        _first_hole = _top;
+    }
+    return block;
+}
+
+void Simple::split(Block *block, size_t size) {
+    if (block->size < size + sizeof(Block) + kAlign) {
+        return;
+    }
+    size_t rest = block->size - size - sizeof(Block);
+    block->size = size;
+    Block *hole = block->next();
+    hole->size = rest;
+    hole->slot = nullptr;
+    if (reinterpret_cast<char *>(hole) < _first_hole) {
+        _first_hole = reinterpret_cast<char *>(hole);
+    }
+}
+
+void Simple::release(Block *block) {
+    block->slot = nullptr;
+    if (reinterpret_cast<char *>(block->next()) == _top) {
+        _top = reinterpret_cast<char *>(block);
+    }
+    if (reinterpret_cast<char *>(block) < _first_hole) {
+        _first_hole = reinterpret_cast<char *>(block);
+    }
+}
+
+Simple::Block *Simple::block_of(const Pointer &p) const {
+    if (p._slots != _table_end - 1 || p._index >= size_t(_table_end - _table)) {
+        throw AllocError(AllocErrorType::InvalidFree, "Pointer doesn't belong to allocator");
+    }
+    const HandleSlot &slot = p._slots[-std::ptrdiff_t(p._index)];
+    if (slot.generation.load(std::memory_order_relaxed) != p._generation) {
+        throw AllocError(AllocErrorType::InvalidFree, "Pointer was freed already");
+    }
+    return static_cast<Block *>(slot.address.load(std::memory_order_relaxed)) - 1;
+}
+
+// See Simple.h
+Pointer Simple::alloc(size_t N) {
+    size_t size = round_up(N > 0 ? N : 1);
+    HandleSlot *slot = take_slot();
+
+    Block *block = find_hole(size);
+    if (block == nullptr) {
+        block = extend(size);
+    }
+    if (block == nullptr) {
+        slot->address.store(_free_slots, std::memory_order_relaxed);
+        _free_slots = slot;
+        throw AllocError(AllocErrorType::NoMemory, "No room for " + std::to_string(N) + " bytes");
+    }
+    block->slot = slot;
+    slot->address.store(block->data(), std::memory_order_release);
+    return Pointer(_table_end - 1, uint32_t(_table_end - 1 - slot), slot->generation.load(std::memory_order_relaxed));
+}
+
+// See Simple.h
+void Simple::realloc(Pointer &p, size_t N) {
+    if (p._slots == nullptr) {
+        p = alloc(N);
+        return;
+    }
+    Block *block = block_of(p);
+    size_t size = round_up(N > 0 ? N : 1);
+    if (size <= block->size) {
+        split(block, size);
+        return;
+    }
+
+    // Grow in place over holes right after the block, or over unused memory if block is the last one
+    while (reinterpret_cast<char *>(block->next()) < _top && block->next()->slot == nullptr) {
+        block->size += sizeof(Block) + block->next()->size;
+    }
+    if (reinterpret_cast<char *>(block->next()) == _top &&
+        size_t(reinterpret_cast<char *>(_table) - block->data()) >= size) {
+        block->size = size;
+        _top = reinterpret_cast<char *>(block->next());
+    }
+    if (_first_hole > reinterpret_cast<char *>(block) && _first_hole < reinterpret_cast<char *>(block->next())) {
+        // First hole was swallowed, the next one is somewhere after the block
+        _first_hole = reinterpret_cast<char *>(block->next());
+    }
+    if (block->size >= size) {
+        split(block, size);
+        return;
+    }
+
+    Block *fresh = find_hole(size);
+    if (fresh == nullptr) {
+        fresh = extend(size);
+    }
+    if (fresh == nullptr) {
+        throw AllocError(AllocErrorType::NoMemory, "No room for " + std::to_string(N) + " bytes");
+    }
+    fresh->slot = block->slot;
+    begin_move(fresh->slot);
+    std::memcpy(fresh->data(), block->data(), block->size);
+    end_move(fresh->slot, fresh->data());
+    release(block);
+}
+
+// See Simple.h
+void Simple::free(Pointer &p) {
+    if (p._slots == nullptr) {
+        return;
+    }
+    Block *block = block_of(p);
+    HandleSlot *slot = block->slot;
+
+    // Generation changes before block memory is touched, so that read() copying it meanwhile notices, and
+    // before the chain link, so that reader seeing the link sees new generation as well
+    slot->generation.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    release(block);
+    slot->address.store(_free_slots, std::memory_order_release);
+    _free_slots = slot;
+    p = Pointer();
+}
+
+// See Simple.h
+Pointer Simple::handle_of(const void *address) const {
+    const char *data = static_cast<const char *>(address);
+    if (data < _begin + sizeof(Block) || data >= _top || reinterpret_cast<uintptr_t>(data) % kAlign != 0) {
+        throw AllocError(AllocErrorType::InvalidFree, "Address doesn't belong to allocator");
+    }
+    const HandleSlot *slot = (reinterpret_cast<const Block *>(data) - 1)->slot;
+    if (slot == nullptr || slot < _table || slot >= _table_end ||
+        slot->address.load(std::memory_order_relaxed) != address) {
+        throw AllocError(AllocErrorType::InvalidFree, "Address is not a block start");
+    }
+    return Pointer(_table_end - 1, uint32_t(_table_end - 1 - slot), slot->generation.load(std::memory_order_relaxed));
+}
+
+// See Simple.h
+void Simple::defrag() {
+    while (!defrag(SIZE_MAX, std::chrono::microseconds::max())) {
+    }
+}
+
+// See Simple.h
+bool Simple::defrag(size_t max_bytes, std::chrono::microseconds max_time) {
+    auto start = std::chrono::steady_clock::now();
+    size_t moved = 0;
+
+    Block *hole = reinterpret_cast<Block *>(_first_hole);
+    while (reinterpret_cast<char *>(hole) < _top) {
+        if (hole->slot != nullptr) {
+            hole = hole->next();
+            _first_hole = reinterpret_cast<char *>(hole);
+            continue;
+        }
+        while (reinterpret_cast<char *>(hole->next()) < _top && hole->next()->slot == nullptr) {
+            hole->size += sizeof(Block) + hole->next()->size;
+        }
+        Block *block = hole->next();
+        if (reinterpret_cast<char *>(block) == _top) {
+            _top = reinterpret_cast<char *>(hole);
+            break;
+        }
+
+        // Budget is checked before the move, so that every call makes progress
+        if (moved > 0) {
+            auto elapsed = std::chrono::steady_clock::now() - start;
+            if (moved + block->size > max_bytes ||
+                std::chrono::duration_cast<std::chrono::microseconds>(elapsed) >= max_time) {
+                return false;
+            }
+        }
+
+        // Block slides down over the hole, hole moves up right after it
+        size_t hole_size = hole->size;
+        size_t block_size = block->size;
+        HandleSlot *slot = block->slot;
+        begin_move(slot);
+        std::memmove(hole, block, sizeof(Block) + block_size);
+        end_move(slot, hole->data());
+        moved += block_size;
+
+        hole = hole->next();
+        hole->size = hole_size;
+        hole->slot = nullptr;
+        _first_hole = reinterpret_cast<char *>(hole);
+    }
+    _first_hole = _top;
+    return true;
+}
+
+// See Simple.h
+std::string Simple::dump() const {
+    std::stringstream out;
+    out << "used " << (_top - _begin) << ", descriptors " << (_table_end - _table) << ", free "
+        << (reinterpret_cast<char *>(_table) - _top) << std::endl;
+    for (Block *block = reinterpret_cast<Block *>(_begin); reinterpret_cast<char *>(block) < _top;
+         block = block->next()) {
+        out << (block->slot != nullptr ? "block " : "hole ") << static_cast<void *>(block->data()) << " "
+            << block->size << std::endl;
+    }
+    return out.str();
+}
 
 } // namespace Allocator
 } // namespace Afina
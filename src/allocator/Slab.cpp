@@ -0,0 +1,229 @@
+#include <afina/allocator/Slab.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <sstream>
+
+#include <afina/allocator/Error.h>
+
+namespace Afina {
+namespace Allocator {
+
+/**
+ * Header in the beginning of every page, chunks follow it
+ */
+struct Slab::Page {
+    Slab *owner;
+
+    // Links in the list of partial pages of the class or in the list of free pages
+    Page *prev;
+    Page *next;
+
+    // Chunks freed since page was assigned to its class
+    void *free_list;
+
+    // Size class of the page, meaningless while page is free
+    size_t cls;
+
+    // Number of chunks given out and number of chunks ever cut from the page memory
+    size_t used;
+    size_t carved;
+
+    char *chunks() { return reinterpret_cast<char *>(this) + kHeaderSize; }
+
+    // Header takes a multiple of the chunk alignment
+    static constexpr size_t kHeaderSize = 64;
+};
+
+constexpr size_t Slab::kPageSize;
+constexpr size_t Slab::kMinChunk;
+
+Slab::Slab(void *base, size_t size, double factor) : _free(nullptr), _free_count(0) {
+    static_assert(sizeof(Page) <= Page::kHeaderSize, "Page header doesn't fit");
+
+    uintptr_t start = reinterpret_cast<uintptr_t>(base);
+    uintptr_t aligned = (start + kPageSize - 1) & ~uintptr_t(kPageSize - 1);
+    _base = reinterpret_cast<char *>(aligned);
+    _pages = (aligned - start < size) ? (size - (aligned - start)) / kPageSize : 0;
+
+    // Chunks are 16 bytes aligned, the last class takes the whole page
+    const size_t max_chunk = kPageSize - Page::kHeaderSize;
+    size_t chunk = kMinChunk;
+    while (chunk < max_chunk) {
+        _classes.push_back(Class{chunk, max_chunk / chunk, nullptr, 0, 0});
+        chunk = std::max(size_t(chunk * factor), chunk + 16);
+        chunk = (chunk + 15) & ~size_t(15);
+    }
+    _classes.push_back(Class{max_chunk, 1, nullptr, 0, 0});
+
+    // Free pages are linked in reverse, so that the first page is taken first
+    for (size_t i = _pages; i > 0; i--) {
+        Page *p = page(i - 1);
+        p->owner = this;
+        push(_free, p);
+    }
+    _free_count = _pages;
+}
+
+Slab::Page *Slab::page(size_t index) const { return reinterpret_cast<Page *>(_base + index * kPageSize); }
+
+void Slab::push(Page *&head, Page *page) {
+    page->prev = nullptr;
+    page->next = head;
+    if (head != nullptr) {
+        head->prev = page;
+    }
+    head = page;
+}
+
+void Slab::unlink(Page *&head, Page *page) {
+    if (page->prev != nullptr) {
+        page->prev->next = page->next;
+    } else {
+        head = page->next;
+    }
+    if (page->next != nullptr) {
+        page->next->prev = page->prev;
+    }
+}
+
+size_t Slab::class_of(size_t size) const {
+    auto it = std::lower_bound(_classes.begin(), _classes.end(), size,
+                               [](const Class &c, size_t size) { return c.size < size; });
+    return it - _classes.begin();
+}
+
+void *Slab::alloc(size_t size) {
+    void *p = try_alloc(size);
+    if (p == nullptr) {
+        throw AllocError(AllocErrorType::NoMemory, "No free chunk of " + std::to_string(size) + " bytes");
+    }
+    return p;
+}
+
+void *Slab::try_alloc(size_t size) {
+    size_t cls = class_of(size);
+    if (cls == _classes.size()) {
+        return nullptr;
+    }
+    std::lock_guard<std::mutex> lock(_lock);
+    return take(cls);
+}
+
+bool Slab::assign(size_t cls) {
+    std::lock_guard<std::mutex> lock(_lock);
+    return assign_page(cls) != nullptr;
+}
+
+Slab::Page *Slab::assign_page(size_t cls) {
+    if (_free == nullptr) {
+        return nullptr;
+    }
+    Page *p = _free;
+    unlink(_free, p);
+    _free_count--;
+
+    Class &c = _classes[cls];
+    p->cls = cls;
+    p->used = 0;
+    p->carved = 0;
+    p->free_list = nullptr;
+    push(c.partial, p);
+    c.pages++;
+    return p;
+}
+
+void *Slab::take(size_t cls) {
+    Class &c = _classes[cls];
+    Page *p = c.partial;
+    if (p == nullptr && (p = assign_page(cls)) == nullptr) {
+        return nullptr;
+    }
+
+    void *chunk;
+    if (p->free_list != nullptr) {
+        chunk = p->free_list;
+        p->free_list = __atomic_load_n(static_cast<void **>(chunk), __ATOMIC_RELAXED);
+    } else {
+        chunk = p->chunks() + p->carved * c.size;
+        p->carved++;
+    }
+    p->used++;
+    c.used++;
+    if (p->used == c.per_page) {
+        unlink(c.partial, p);
+    }
+    return chunk;
+}
+
+void Slab::free(void *p) {
+    if (p == nullptr) {
+        return;
+    }
+    Page *page = const_cast<Page *>(static_cast<const Page *>(page_of(p)));
+    std::lock_guard<std::mutex> lock(page->owner->_lock);
+    page->owner->release(page, p);
+}
+
+void Slab::release(Page *page, void *p) {
+    Class &c = _classes[page->cls];
+    bool was_full = (page->used == c.per_page);
+    // Optimistic readers of the storages could still look at the chunk, so link is written atomically
+    __atomic_store_n(static_cast<void **>(p), page->free_list, __ATOMIC_RELAXED);
+    page->free_list = p;
+    page->used--;
+    c.used--;
+
+    if (page->used == 0) {
+        // Page is empty, any class could take it now
+        if (!was_full) {
+            unlink(c.partial, page);
+        }
+        c.pages--;
+        push(_free, page);
+        _free_count++;
+    } else if (was_full) {
+        push(c.partial, page);
+    }
+}
+
+bool Slab::available(size_t size) const {
+    size_t cls = class_of(size);
+    if (cls == _classes.size()) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(_lock);
+    return _classes[cls].partial != nullptr || _free != nullptr;
+}
+
+size_t Slab::free_pages() const {
+    std::lock_guard<std::mutex> lock(_lock);
+    return _free_count;
+}
+
+size_t Slab::class_pages(size_t cls) const {
+    std::lock_guard<std::mutex> lock(_lock);
+    return _classes[cls].pages;
+}
+
+size_t Slab::class_used(size_t cls) const {
+    std::lock_guard<std::mutex> lock(_lock);
+    return _classes[cls].used;
+}
+
+std::string Slab::dump() const {
+    std::lock_guard<std::mutex> lock(_lock);
+    std::stringstream out;
+    out << "pages " << _pages << ", free " << _free_count << std::endl;
+    for (size_t i = 0; i < _classes.size(); i++) {
+        const Class &c = _classes[i];
+        if (c.pages > 0) {
+            out << "class " << i << ": chunk " << c.size << ", pages " << c.pages << ", used " << c.used << "/"
+                << c.pages * c.per_page << std::endl;
+        }
+    }
+    return out.str();
+}
+
+} // namespace Allocator
+} // namespace Afina
@@ -0,0 +1,34 @@
+#include <afina/allocator/SlabCache.h>
+
+#include <afina/allocator/Arena.h>
+
+namespace Afina {
+namespace Allocator {
+
+SlabCache::SlabCache(Arena &arena, size_t limit) : _arena(arena), _limit(limit) { _slabs.reserve(limit); }
+
+SlabCache::~SlabCache() {
+    for (void *slab : _slabs) {
+        _arena.put(slab);
+    }
+}
+
+void *SlabCache::take() {
+    if (_slabs.empty()) {
+        return _arena.take();
+    }
+    void *slab = _slabs.back();
+    _slabs.pop_back();
+    return slab;
+}
+
+void SlabCache::put(void *slab) {
+    if (_slabs.size() < _limit) {
+        _slabs.push_back(slab);
+    } else {
+        _arena.put(slab);
+    }
+}
+
+} // namespace Allocator
+} // namespace Afina
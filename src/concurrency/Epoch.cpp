@@ -0,0 +1,302 @@
+#include <afina/concurrency/Epoch.h>
+
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace Afina {
+namespace Concurrency {
+
+namespace {
+
+struct Retired {
+    void *object;
+    EpochDomain::Deleter deleter;
+};
+
+// Objects retired by one thread, stamped with the epoch they were handed over in
+struct Bag {
+    uint64_t epoch;
+    std::vector<Retired> objects;
+};
+
+// Slot of a thread in the domain
+struct Participant {
+    // Epoch thread has seen shifted left by one, lowest bit is set while thread is pinned. Written by the
+    // owner only, read by threads moving epoch forward
+    std::atomic<uint64_t> state;
+
+    // Slot is taken by some thread
+    std::atomic<bool> used;
+
+    // Fields below belong to the owner
+    size_t pins;
+    std::vector<Retired> bag;
+
+    // Keeps state of the next slot off the cache line the owner writes
+    char padding[64];
+};
+
+constexpr uint64_t kPinned = 1;
+
+void free_objects(const std::vector<Retired> &objects) {
+    for (auto &retired : objects) {
+        retired.deleter(retired.object);
+    }
+}
+
+} // namespace
+
+constexpr size_t EpochDomain::kBagSize;
+
+struct EpochState {
+    EpochState(size_t max_threads, size_t max_garbage)
+        : id(next_id()), max_threads(max_threads), max_garbage(max_garbage),
+          participants(new Participant[max_threads]), epoch(0), pending(0), handed(0), closed(false) {
+        for (size_t i = 0; i < max_threads; i++) {
+            participants[i].state.store(0, std::memory_order_relaxed);
+            participants[i].used.store(false, std::memory_order_relaxed);
+            participants[i].pins = 0;
+        }
+    }
+
+    // Unique across all domains of the process, unlike address of the domain
+    static uint64_t next_id() {
+        static std::atomic<uint64_t> last(0);
+        return last.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+    // Stamps objects with the current epoch, moves them to the new bag
+    Bag seal(std::vector<Retired> &objects) {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        Bag bag{epoch.load(std::memory_order_relaxed), std::move(objects)};
+        objects.clear();
+        return bag;
+    }
+
+    // Puts bag to the handed over ones, lock must be held
+    void push(Bag bag) {
+        handed.fetch_add(bag.objects.size(), std::memory_order_relaxed);
+        bags.push_back(std::move(bag));
+    }
+
+    // Hands objects over to the domain
+    void hand_over(std::vector<Retired> &objects) {
+        Bag bag = seal(objects);
+        std::lock_guard<std::mutex> guard(lock);
+        push(std::move(bag));
+    }
+
+    const uint64_t id;
+    const size_t max_threads;
+    const size_t max_garbage;
+    std::unique_ptr<Participant[]> participants;
+
+    std::atomic<uint64_t> epoch;
+
+    // Objects retired and not freed yet, part of them that is handed over
+    std::atomic<size_t> pending;
+    std::atomic<size_t> handed;
+
+    // Guards fields below
+    std::mutex lock;
+    std::vector<Bag> bags;
+
+    // Domain is destroyed, its slots must not be touched anymore
+    bool closed;
+};
+
+namespace {
+
+struct Registration {
+    // Keeps state alive until the thread gives its slot back, even if the domain is gone by then
+    std::shared_ptr<EpochState> state;
+    Participant *participant;
+};
+
+// Slots taken by the thread, given back once it exits
+struct Registry {
+    ~Registry() {
+        for (auto &r : entries) {
+            std::lock_guard<std::mutex> guard(r.state->lock);
+            if (r.state->closed) {
+                continue;
+            }
+
+            Participant *p = r.participant;
+            if (!p->bag.empty()) {
+                r.state->push(r.state->seal(p->bag));
+            }
+            p->pins = 0;
+            p->state.store(0, std::memory_order_release);
+            p->used.store(false, std::memory_order_release);
+        }
+    }
+
+    std::vector<Registration> entries;
+};
+
+thread_local Registry registry;
+
+// The last domain thread used, so that the common case of a single domain takes no search
+thread_local uint64_t cached_id = 0;
+thread_local Participant *cached = nullptr;
+
+// Slot of the calling thread, nullptr if there is none and claim is false
+Participant *participant(const std::shared_ptr<EpochState> &state, bool claim) {
+    if (cached_id == state->id) {
+        return cached;
+    }
+
+    Participant *result = nullptr;
+    auto &entries = registry.entries;
+    for (size_t i = 0; i < entries.size();) {
+        if (entries[i].state->id == state->id) {
+            result = entries[i].participant;
+            i++;
+        } else if (entries[i].state.use_count() == 1) {
+            // Domain is gone, nobody else could give the slot back
+            entries.erase(entries.begin() + i);
+        } else {
+            i++;
+        }
+    }
+
+    for (size_t i = 0; result == nullptr && claim && i < state->max_threads; i++) {
+        bool expected = false;
+        Participant &p = state->participants[i];
+        if (!p.used.load(std::memory_order_relaxed) &&
+            p.used.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+            entries.push_back(Registration{state, &p});
+            result = &p;
+        }
+    }
+    if (result == nullptr && claim) {
+        throw std::runtime_error("Too many threads in epoch domain");
+    }
+
+    if (result != nullptr) {
+        cached_id = state->id;
+        cached = result;
+    }
+    return result;
+}
+
+} // namespace
+
+EpochDomain::EpochDomain(size_t max_threads, size_t max_garbage)
+    : _state(std::make_shared<EpochState>(max_threads, max_garbage)) {}
+
+EpochDomain::~EpochDomain() {
+    std::vector<Retired> objects;
+    {
+        std::lock_guard<std::mutex> guard(_state->lock);
+        _state->closed = true;
+        for (auto &bag : _state->bags) {
+            objects.insert(objects.end(), bag.objects.begin(), bag.objects.end());
+        }
+        _state->bags.clear();
+        for (size_t i = 0; i < _state->max_threads; i++) {
+            auto &bag = _state->participants[i].bag;
+            objects.insert(objects.end(), bag.begin(), bag.end());
+            bag.clear();
+        }
+    }
+    if (cached_id == _state->id) {
+        cached_id = 0;
+    }
+    free_objects(objects);
+}
+
+void EpochDomain::pin() {
+    Participant *p = participant(_state, true);
+    if (p->pins++ > 0) {
+        return;
+    }
+
+    // Epoch could move on meanwhile, then the stale one is published. That only holds reclamation back.
+    // Exchange is a full barrier as well as fence is, but it is cheaper on x86 and visible to ThreadSanitizer
+    uint64_t epoch = _state->epoch.load(std::memory_order_relaxed);
+    p->state.exchange((epoch << 1) | kPinned, std::memory_order_seq_cst);
+}
+
+void EpochDomain::unpin() {
+    Participant *p = participant(_state, false);
+    if (--p->pins == 0) {
+        p->state.store(0, std::memory_order_release);
+    }
+}
+
+bool EpochDomain::pinned() {
+    Participant *p = participant(_state, false);
+    return p != nullptr && p->pins > 0;
+}
+
+void EpochDomain::retire(void *object, Deleter deleter) {
+    Participant *p = participant(_state, true);
+    p->bag.push_back(Retired{object, deleter});
+    _state->pending.fetch_add(1, std::memory_order_relaxed);
+    if (p->bag.size() < kBagSize) {
+        return;
+    }
+
+    _state->hand_over(p->bag);
+    collect();
+    while (p->pins == 0 && _state->handed.load(std::memory_order_relaxed) > _state->max_garbage) {
+        std::this_thread::yield();
+        collect();
+    }
+}
+
+void EpochDomain::flush() {
+    Participant *p = participant(_state, false);
+    if (p != nullptr && !p->bag.empty()) {
+        _state->hand_over(p->bag);
+    }
+}
+
+size_t EpochDomain::collect() {
+    EpochState &state = *_state;
+
+    // Epoch moves on only if every pinned thread has seen the current one
+    uint64_t epoch = state.epoch.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    bool advance = true;
+    for (size_t i = 0; i < state.max_threads && advance; i++) {
+        uint64_t s = state.participants[i].state.load(std::memory_order_acquire);
+        advance = !(s & kPinned) || (s >> 1) == epoch;
+    }
+    if (advance && state.epoch.compare_exchange_strong(epoch, epoch + 1, std::memory_order_acq_rel,
+                                                       std::memory_order_acquire)) {
+        epoch++;
+    }
+
+    // Threads pinned when bag was handed over have seen at most its epoch, so they are gone two epochs later
+    std::vector<Retired> objects;
+    {
+        std::lock_guard<std::mutex> guard(state.lock);
+        for (size_t i = 0; i < state.bags.size();) {
+            if (state.bags[i].epoch + 2 > epoch) {
+                i++;
+                continue;
+            }
+            objects.insert(objects.end(), state.bags[i].objects.begin(), state.bags[i].objects.end());
+            std::swap(state.bags[i], state.bags.back());
+            state.bags.pop_back();
+        }
+        state.handed.fetch_sub(objects.size(), std::memory_order_relaxed);
+    }
+
+    free_objects(objects);
+    state.pending.fetch_sub(objects.size(), std::memory_order_relaxed);
+    return objects.size();
+}
+
+uint64_t EpochDomain::epoch() const { return _state->epoch.load(std::memory_order_relaxed); }
+
+size_t EpochDomain::pending() const { return _state->pending.load(std::memory_order_relaxed); }
+
+} // namespace Concurrency
+} // namespace Afina
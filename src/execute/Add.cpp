@@ -10,7 +10,14 @@ namespace Execute {
 // hold data for this key".
 void Add::Execute(Storage &storage, const std::string &args, std::string &out) {
     std::cout << "Add(" << _key << ")" << args << std::endl;
-    out = storage.PutIfAbsent(_key, args) ? "STORED" : "NOT_STORED";
+    uint32_t seconds;
+    if (!ttl(seconds)) {
+        // Stored and expired right away, if stored at all
+        std::string value;
+        out = storage.Get(_key, value) ? "NOT_STORED" : "STORED";
+        return;
+    }
+    out = storage.PutIfAbsentWithTTL(_key, args, seconds, _flags) ? "STORED" : "NOT_STORED";
 }
 
 } // namespace Execute
@@ -0,0 +1,36 @@
+#include <afina/Storage.h>
+#include <afina/execute/Cas.h>
+
+#include <iostream>
+
+namespace Afina {
+namespace Execute {
+
+// memcached protocol: "cas" is a check and set operation which means "store this data but
+// only if no one else has updated since I last fetched it."
+void Cas::Execute(Storage &storage, const std::string &args, std::string &out) {
+    std::cout << "Cas(" << _key << ", " << _cas << "): " << args << std::endl;
+    uint32_t seconds;
+    bool expired = !ttl(seconds);
+    switch (storage.CompareAndSwap(_key, args, expired ? 0 : seconds, _flags, _cas)) {
+    case CasResult::Stored:
+        if (expired) {
+            // Stored and expired right away
+            storage.Delete(_key);
+        }
+        out = "STORED";
+        break;
+    case CasResult::NotStored:
+        out = "NOT_STORED";
+        break;
+    case CasResult::Exists:
+        out = "EXISTS";
+        break;
+    case CasResult::NotFound:
+        out = "NOT_FOUND";
+        break;
+    }
+}
+
+} // namespace Execute
+} // namespace Afina
@@ -1 +1,16 @@
 #include <afina/execute/Command.h>
+
+#include <utility>
+
+namespace Afina {
+namespace Execute {
+
+// See Command.h
+void Command::ExecuteVectored(Storage &storage, const std::string &args, std::vector<ValueView> &out) {
+    std::string result;
+    Execute(storage, args, result);
+    out.push_back(ValueView::Copy(std::move(result)));
+}
+
+} // namespace Execute
+} // namespace Afina
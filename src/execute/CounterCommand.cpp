@@ -0,0 +1,25 @@
+#include <afina/execute/CounterCommand.h>
+
+namespace Afina {
+namespace Execute {
+
+// See CounterCommand.h
+void CounterCommand::response(DeltaResult result, uint64_t value, std::string &out) const {
+    switch (result) {
+    case DeltaResult::Stored:
+        out = std::to_string(value);
+        break;
+    case DeltaResult::NotStored:
+        out = "SERVER_ERROR out of memory";
+        break;
+    case DeltaResult::NonNumeric:
+        out = "CLIENT_ERROR cannot increment or decrement non-numeric value";
+        break;
+    case DeltaResult::NotFound:
+        out = "NOT_FOUND";
+        break;
+    }
+}
+
+} // namespace Execute
+} // namespace Afina
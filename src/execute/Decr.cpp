@@ -0,0 +1,19 @@
+#include <afina/Storage.h>
+#include <afina/execute/Decr.h>
+
+#include <iostream>
+
+namespace Afina {
+namespace Execute {
+
+// memcached protocol: "decr" is used to change data for some item in-place, decrementing it. If
+// decremented value would go below 0, the new value will be 0.
+void Decr::Execute(Storage &storage, const std::string &args, std::string &out) {
+    std::cout << "Decr(" << _key << ", " << _delta << ")" << std::endl;
+    uint64_t value;
+    DeltaResult result = storage.Decrement(_key, _delta, value);
+    response(result, value, out);
+}
+
+} // namespace Execute
+} // namespace Afina
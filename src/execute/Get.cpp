@@ -4,6 +4,7 @@
 #include <iostream>
 #include <iterator>
 #include <sstream>
+#include <utility>
 
 namespace Afina {
 namespace Execute {
@@ -12,7 +13,7 @@ namespace Execute {
 
 Each item sent by the server looks like this:
 
-VALUE <key> <flags> <bytes>\r\n
+VALUE <key> <flags> <bytes> [<cas unique>]\r\n
 <data block>\r\n
 
 After all the items have been transmitted, the server sends the string
@@ -21,23 +22,65 @@ to indicate the end of response.
 
 */
 
+void Get::header(std::string &out, size_t i, const ValueView &value, const ValueInfo &info) const {
+    out.append("VALUE ").append(_keys[i]);
+    if (info.header != nullptr) {
+        // Storage has the rest of the line ready, only version is added for gets
+        out.append(info.header, info.header_size - 2);
+    } else {
+        out.append(" ").append(std::to_string(info.flags));
+        out.append(" ").append(std::to_string(value.total_size()));
+    }
+    if (_cas) {
+        out.append(" ").append(std::to_string(info.cas));
+    }
+    out.append("\r\n");
+}
+
 void Get::Execute(Storage &storage, const std::string &args, std::string &out) {
     std::stringstream keyStream;
     copy(_keys.begin(), _keys.end(), std::ostream_iterator<std::string>(keyStream, " "));
     std::cout << "Get(" << keyStream.str() << ")" << std::endl;
 
-    std::stringstream outStream;
-
-    std::string value;
-    for (auto &key : _keys) {
-        if (!storage.Get(key, value))
+    out.clear();
+    std::vector<ValueView> values;
+    std::vector<ValueInfo> infos;
+    storage.MultiGetWithInfo(_keys, values, infos);
+    for (size_t i = 0; i < _keys.size(); i++) {
+        if (values[i].data() == nullptr)
             continue;
-        outStream << "VALUE " << key << " 0 " << value.size() << "\r\n";
-        outStream << value << "\r\n";
+        header(out, i, values[i], infos[i]);
+        for (const ValueView *piece = &values[i]; piece != nullptr; piece = piece->next()) {
+            out.append(piece->data(), piece->size());
+        }
+        out.append("\r\n");
     }
-    outStream << "END"; // networking layer should add the last \r\n
+    out.append("END"); // networking layer should add the last \r\n
+}
+
+void Get::ExecuteVectored(Storage &storage, const std::string &args, std::vector<ValueView> &out) {
+    // Text between values is accumulated, so there is one owned buffer per value
+    std::string text;
+    std::vector<ValueView> values;
+    std::vector<ValueInfo> infos;
+    storage.MultiGetWithInfo(_keys, values, infos);
+    for (size_t i = 0; i < _keys.size(); i++) {
+        if (values[i].data() == nullptr)
+            continue;
+        header(text, i, values[i], infos[i]);
+        out.push_back(ValueView::Copy(std::move(text)));
 
-    out = outStream.str();
+        // Value stored in pieces is sent piece by piece
+        ValueView piece = std::move(values[i]);
+        while (piece.data() != nullptr) {
+            ValueView rest = piece.unchain();
+            out.push_back(std::move(piece));
+            piece = std::move(rest);
+        }
+        text.assign("\r\n");
+    }
+    text.append("END"); // networking layer should add the last \r\n
+    out.push_back(ValueView::Copy(std::move(text)));
 }
 
 } // namespace Execute
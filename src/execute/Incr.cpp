@@ -0,0 +1,19 @@
+#include <afina/Storage.h>
+#include <afina/execute/Incr.h>
+
+#include <iostream>
+
+namespace Afina {
+namespace Execute {
+
+// memcached protocol: "incr" is used to change data for some item in-place, incrementing it. The
+// data for the item is treated as decimal representation of a 64-bit unsigned integer.
+void Incr::Execute(Storage &storage, const std::string &args, std::string &out) {
+    std::cout << "Incr(" << _key << ", " << _delta << ")" << std::endl;
+    uint64_t value;
+    DeltaResult result = storage.Increment(_key, _delta, value);
+    response(result, value, out);
+}
+
+} // namespace Execute
+} // namespace Afina
@@ -0,0 +1,30 @@
+#include <afina/execute/InsertCommand.h>
+
+#include <ctime>
+
+namespace Afina {
+namespace Execute {
+
+// Largest <exptime> that is treated as relative, as memcached does
+static const int32_t kMaxRelativeExpire = 60 * 60 * 24 * 30;
+
+// See InsertCommand.h
+bool InsertCommand::ttl(uint32_t &seconds) const {
+    if (_expire < 0) {
+        return false;
+    }
+    if (_expire <= kMaxRelativeExpire) {
+        seconds = _expire;
+        return true;
+    }
+
+    std::time_t now = std::time(nullptr);
+    if (_expire <= now) {
+        return false;
+    }
+    seconds = _expire - now;
+    return true;
+}
+
+} // namespace Execute
+} // namespace Afina
@@ -11,13 +11,13 @@ namespace Execute {
 
 void Replace::Execute(Storage &storage, const std::string &args, std::string &out) {
     std::cout << "Replace(" << _key << "): " << args << std::endl;
-    std::string value;
-    if (storage.Get(_key, value)) {
-        storage.Set(_key, args);
-        out = "STORED";
-    } else {
-        out = "NOT_STORED";
+    uint32_t seconds;
+    if (!ttl(seconds)) {
+        // Replaced and expired right away
+        out = storage.Delete(_key) ? "STORED" : "NOT_STORED";
+        return;
     }
+    out = storage.SetWithTTL(_key, args, seconds, _flags) ? "STORED" : "NOT_STORED";
 }
 
 } // namespace Execute
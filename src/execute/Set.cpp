@@ -9,7 +9,14 @@ namespace Execute {
 // memcached protocol: "set" means "store this data".
 void Set::Execute(Storage &storage, const std::string &args, std::string &out) {
     std::cout << "Set(" << _key << "): " << args << std::endl;
-    storage.Put(_key, args);
+    uint32_t seconds;
+    if (!ttl(seconds)) {
+        // Stored and expired right away
+        storage.Delete(_key);
+        out = "STORED";
+        return;
+    }
+    storage.PutWithTTL(_key, args, seconds, _flags);
     out = "STORED";
 }
 
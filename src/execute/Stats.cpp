@@ -3,12 +3,23 @@
 
 #include <iostream>
 #include <iterator>
+#include <map>
 #include <sstream>
 
 namespace Afina {
 namespace Execute {
 
-void Stats::Execute(Storage &storage, const std::string &args, std::string &out) { out.assign("END"); }
+void Stats::Execute(Storage &storage, const std::string &args, std::string &out) {
+    std::map<std::string, std::string> stats;
+    storage.Stats(stats);
+
+    std::stringstream outStream;
+    for (auto &stat : stats) {
+        outStream << "STAT " << stat.first << " " << stat.second << "\r\n";
+    }
+    outStream << "END";
+    out = outStream.str();
+}
 
 } // namespace Execute
 } // namespace Afina
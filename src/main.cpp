@@ -1,5 +1,7 @@
+#include <algorithm>
 #include <chrono>
 #include <iostream>
+#include <map>
 #include <memory>
 
 #include <atomic>
@@ -11,6 +13,7 @@
 
 #include <afina/Storage.h>
 #include <afina/Version.h>
+#include <afina/allocator/Region.h>
 #include <afina/logging/Service.h>
 #include <afina/network/Server.h>
 
@@ -20,8 +23,16 @@
 #include "network/st_blocking/ServerImpl.h"
 #include "network/st_nonblocking/ServerImpl.h"
 
+#include "storage/ClockLRU.h"
+#include "storage/CompactLRU.h"
+#include "storage/CuckooClock.h"
 #include "storage/SimpleLRU.h"
+#include "storage/SlabLRU.h"
+#include "storage/StripedLRU.h"
+#include "storage/ThreadSafeClockLRU.h"
 #include "storage/ThreadSafeSimpleLRU.h"
+#include "storage/ThreadSafeSlabLRU.h"
+#include "storage/TinyLFU.h"
 
 using namespace Afina;
 
@@ -50,14 +61,73 @@ public:
             storage_type = options["storage"].as<std::string>();
         }
 
+        Afina::Allocator::HugePages huge_pages = Afina::Allocator::HugePages::None;
+        if (options.count("huge-pages") > 0) {
+            std::string pages = options["huge-pages"].as<std::string>();
+            if (pages == "transparent") {
+                huge_pages = Afina::Allocator::HugePages::Transparent;
+            } else if (pages == "explicit") {
+                huge_pages = Afina::Allocator::HugePages::Explicit;
+            } else if (pages != "none") {
+                throw std::runtime_error("Unknown huge pages type");
+            }
+        }
+
         if (storage_type == "st_lru") {
             storage = std::make_shared<Afina::Backend::SimpleLRU>();
         } else if (storage_type == "mt_lru") {
             storage = std::make_shared<Afina::Backend::ThreadSafeSimplLRU>();
+        } else if (storage_type == "mt_sharded_lru") {
+            storage = std::make_shared<Afina::Backend::StripedLRU>();
+        } else if (storage_type == "st_slru") {
+            storage = std::make_shared<Afina::Backend::SimpleSLRU>();
+        } else if (storage_type == "mt_slru") {
+            storage = std::make_shared<Afina::Backend::ThreadSafeSimpleSLRU>();
+        } else if (storage_type == "st_arc") {
+            storage = std::make_shared<Afina::Backend::SimpleARC>();
+        } else if (storage_type == "mt_arc") {
+            storage = std::make_shared<Afina::Backend::ThreadSafeSimpleARC>();
+        } else if (storage_type == "st_lfu") {
+            storage = std::make_shared<Afina::Backend::SimpleLFU>();
+        } else if (storage_type == "mt_lfu") {
+            storage = std::make_shared<Afina::Backend::ThreadSafeSimpleLFU>();
+        } else if (storage_type == "st_clock") {
+            storage = std::make_shared<Afina::Backend::ClockLRU>();
+        } else if (storage_type == "mt_clock") {
+            storage = std::make_shared<Afina::Backend::ThreadSafeClockLRU>();
+        } else if (storage_type == "st_slab") {
+            storage = std::make_shared<Afina::Backend::SlabLRU>(64 << 20, 1.25, Afina::Backend::steady_seconds,
+                                                                huge_pages);
+        } else if (storage_type == "mt_slab") {
+            storage = std::make_shared<Afina::Backend::ThreadSafeSlabLRU>(
+                64 << 20, 1.25, Afina::Backend::steady_seconds, std::chrono::seconds(1), huge_pages);
+        } else if (storage_type == "st_compact") {
+            storage = std::make_shared<Afina::Backend::CompactLRU>(64 << 20, 1.25, Afina::Backend::steady_seconds,
+                                                                   huge_pages);
+        } else if (storage_type == "mt_cuckoo") {
+            storage = std::make_shared<Afina::Backend::CuckooClock>(64 << 20, 1.25, Afina::Backend::steady_seconds,
+                                                                    huge_pages);
         } else {
             throw std::runtime_error("Unknown storage type");
         }
 
+        std::string admission_type = "none";
+        if (options.count("admission") > 0) {
+            admission_type = options["admission"].as<std::string>();
+        }
+
+        if (admission_type == "tinylfu") {
+            // Window takes about 1% of the main cache budget, sketch counts as many keys as the smallest items
+            // filling the whole budget
+            std::map<std::string, std::string> stats;
+            storage->Stats(stats);
+            size_t max_size = std::stoull(stats["limit_maxbytes"]);
+            storage = std::make_shared<Afina::Backend::TinyLFU>(storage, std::max<size_t>(max_size / 100, 128),
+                                                                std::max<size_t>(max_size / 64, 1024));
+        } else if (admission_type != "none") {
+            throw std::runtime_error("Unknown admission type");
+        }
+
         // Step 2: Configure network
         std::string network_type = "st_block";
         if (options.count("network") > 0) {
@@ -86,6 +156,12 @@ public:
         log->warn("Start storage");
         storage->Start();
 
+        std::map<std::string, std::string> stats;
+        storage->Stats(stats);
+        if (stats.count("prefault_ms") > 0) {
+            log->warn("Storage memory prefaulted in {} ms, huge pages: {}", stats["prefault_ms"], stats["huge_pages"]);
+        }
+
         // TODO: configure network service
         const uint16_t port = 8080;
         log->warn("Start network on {}", port);
@@ -128,6 +204,8 @@ int main(int argc, char **argv) {
         // TODO: use custom cxxopts::value to print options possible values in help message
         // and simplify validation below
         options.add_options()("s,storage", "Type of storage service to use", cxxopts::value<std::string>());
+        options.add_options()("a,admission", "Admission filter in front of storage", cxxopts::value<std::string>());
+        options.add_options()("huge-pages", "Pages backing slab storages memory", cxxopts::value<std::string>());
         options.add_options()("n,network", "Type of network service to use", cxxopts::value<std::string>());
         options.add_options()("h,help", "Print usage info");
         options.parse(argc, argv);
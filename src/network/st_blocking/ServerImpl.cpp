@@ -1,10 +1,13 @@
 #include "ServerImpl.h"
 
+#include <algorithm>
 #include <cassert>
+#include <climits>
 #include <cstring>
 #include <iostream>
 #include <memory>
 #include <stdexcept>
+#include <vector>
 
 #include <arpa/inet.h>
 #include <netdb.h>
@@ -13,6 +16,7 @@
 #include <signal.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 #include <spdlog/logger.h>
@@ -27,6 +31,36 @@ namespace Afina {
 namespace Network {
 namespace STblocking {
 
+/**
+ * Sends all buffers to the socket in order, with as few writev calls as possible
+ */
+static void send_vectored(int socket, const std::vector<ValueView> &buffers) {
+    std::vector<struct iovec> iov(buffers.size());
+    for (size_t i = 0; i < buffers.size(); i++) {
+        iov[i].iov_base = const_cast<char *>(buffers[i].data());
+        iov[i].iov_len = buffers[i].size();
+    }
+
+    size_t first = 0;
+    while (first < iov.size()) {
+        int count = std::min(iov.size() - first, size_t(IOV_MAX));
+        ssize_t sent = writev(socket, &iov[first], count);
+        if (sent <= 0) {
+            throw std::runtime_error("Failed to send response");
+        }
+
+        // Skip fully sent buffers, the partially sent one continues from where send stopped
+        while (first < iov.size() && size_t(sent) >= iov[first].iov_len) {
+            sent -= iov[first].iov_len;
+            first++;
+        }
+        if (sent > 0) {
+            iov[first].iov_base = static_cast<char *>(iov[first].iov_base) + sent;
+            iov[first].iov_len -= sent;
+        }
+    }
+}
+
 // See Server.h
 ServerImpl::ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl) : Server(ps, pl) {}
 
@@ -216,14 +250,19 @@ void ServerImpl::OnRun() {
                     if (command_to_execute && arg_remains == 0) {
                         _logger->debug("Start command execution");
 
-                        std::string result;
-                        command_to_execute->Execute(*pStorage, argument_for_command, result);
+                        // Argument is followed by "\r\n", which isn't a part of it
+                        if (argument_for_command.size() >= 2) {
+                            argument_for_command.resize(argument_for_command.size() - 2);
+                        }
+
+                        // Values in the result are views of the storage memory, they are sent right
+                        // from there and released once send completes
+                        std::vector<ValueView> result;
+                        command_to_execute->ExecuteVectored(*pStorage, argument_for_command, result);
 
                         // Send response
-                        result += "\r\n";
-                        if (send(client_socket, result.data(), result.size(), 0) <= 0) {
-                            throw std::runtime_error("Failed to send response");
-                        }
+                        result.emplace_back("\r\n", 2, nullptr, nullptr);
+                        send_vectored(client_socket, result);
 
                         // Prepare for the next command
                         command_to_execute.reset();
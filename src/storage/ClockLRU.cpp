@@ -0,0 +1,422 @@
+#include "ClockLRU.h"
+
+namespace Afina {
+namespace Backend {
+
+// Number of keys MultiGet looks ahead when prefetching
+static const size_t kPrefetchDistance = 4;
+
+ClockLRU::~ClockLRU() {
+    _index.clear();
+    while (_hand != nullptr) {
+        Item *item = _hand;
+        unlink(item);
+        Item::release(item);
+    }
+}
+
+void ClockLRU::link(Item *item) {
+    if (_hand == nullptr) {
+        item->prev = item;
+        item->next = item;
+        _hand = item;
+        return;
+    }
+    item->next = _hand;
+    item->prev = _hand->prev;
+    _hand->prev->next = item;
+    _hand->prev = item;
+}
+
+void ClockLRU::unlink(Item *item) {
+    if (item->next == item) {
+        _hand = nullptr;
+        return;
+    }
+    if (_hand == item) {
+        _hand = item->next;
+    }
+    item->prev->next = item->next;
+    item->next->prev = item->prev;
+}
+
+uint32_t ClockLRU::tick() {
+    uint32_t now = _clock();
+    _wheel.Advance(now, [this](Item *item) { delete_item(item); });
+    return now;
+}
+
+Item *ClockLRU::find(uint64_t hash, const std::string &key, uint32_t now) {
+    Item *item = _index.find(hash, key);
+    if (item != nullptr && item->expire != 0 && item->expire <= now) {
+        delete_item(item);
+        return nullptr;
+    }
+    return item;
+}
+
+void ClockLRU::set_expire(Item *item, uint32_t expire) {
+    if (item->timer_pprev != nullptr) {
+        _wheel.Cancel(item);
+    }
+    item->expire = expire;
+    if (expire != 0) {
+        _wheel.Schedule(item);
+    }
+}
+
+void ClockLRU::delete_item(Item *item) {
+    current_size -= item->size();
+    _index.erase(item->hash, item);
+    unlink(item);
+    if (item->timer_pprev != nullptr) {
+        _wheel.Cancel(item);
+    }
+    Item::release(item);
+}
+
+void ClockLRU::evict(size_t size, const Item *keep) {
+    while (size + current_size > _max_size) {
+        Item *victim = _hand;
+        if (victim == keep || victim->referenced.exchange(false, std::memory_order_relaxed)) {
+            _hand = victim->next;
+            continue;
+        }
+        delete_item(victim);
+    }
+}
+
+void ClockLRU::insert(uint64_t hash, const std::string &key, const std::string &value, uint32_t expire,
+                      uint32_t flags) {
+    evict(key.size() + value.size());
+    Item *item = Item::create(hash, key, value, flags);
+    link(item);
+    _index.insert(hash, item);
+    set_expire(item, expire);
+    current_size += item->size();
+}
+
+void ClockLRU::update(Item *item, const std::string &key, const std::string &value, uint32_t expire,
+                      uint32_t flags) {
+    // Sweep skips the item itself: new value fits into cache by itself, so
+    // loop finishes before everything else is gone
+    current_size -= item->value_size;
+    evict(value.size(), item);
+    current_size += value.size();
+
+    if (item->reusable(value.size())) {
+        std::memcpy(item->value(), value.data(), value.size());
+        item->value_size = value.size();
+        item->numeric = false;
+        item->flags = flags;
+        item->cas = Item::next_cas();
+        item->render_header();
+        item->referenced.store(true, std::memory_order_relaxed);
+        set_expire(item, expire);
+        return;
+    }
+
+    Item *fresh = Item::create(item->hash, key, value, flags);
+    replace(item, fresh);
+    set_expire(fresh, expire);
+}
+
+void ClockLRU::replace(Item *item, Item *fresh) {
+    fresh->referenced.store(true, std::memory_order_relaxed);
+    _index.replace(item->hash, item, fresh);
+    if (item->next == item) {
+        fresh->prev = fresh;
+        fresh->next = fresh;
+    } else {
+        fresh->prev = item->prev;
+        fresh->next = item->next;
+        item->prev->next = fresh;
+        item->next->prev = fresh;
+    }
+    if (_hand == item) {
+        _hand = fresh;
+    }
+    if (item->timer_pprev != nullptr) {
+        _wheel.Cancel(item);
+    }
+    set_expire(fresh, item->expire);
+    Item::release(item);
+}
+
+bool ClockLRU::concat(const std::string &key, const std::string &data, bool append) {
+    Item *item = find(hash_key(key), key, tick());
+    if (item == nullptr) {
+        return false;
+    }
+    if (item->numeric) {
+        // Counter turns back into text
+        std::string number = std::to_string(item->number());
+        std::string value = append ? number + data : data + number;
+        if (key.size() + value.size() > _max_size) {
+            return false;
+        }
+        update(item, key, value, item->expire, item->flags);
+        return true;
+    }
+    if (item->size() + data.size() > _max_size) {
+        return false;
+    }
+    item->referenced.store(true, std::memory_order_relaxed);
+    evict(data.size(), item);
+    current_size += data.size();
+
+    size_t size = item->size() + data.size();
+    if (!item->chunked && size - item->key_size > Chunk::capacity()) {
+        // Value outgrew a chunk, see SimpleCache::concat
+        Item *fresh = Item::create_chunked(item, data.data(), data.size(), append);
+        fresh->flags = item->flags;
+        replace(item, fresh);
+        return true;
+    }
+    if (!item->chunked && (!item->exclusive() || size > item->capacity)) {
+        // Key that grows once tends to grow again, see SimpleCache::concat
+        Item *fresh = Item::create(item->hash, item->key(), item->key_size, item->value(), item->value_size,
+                                   data.size() + size / 2);
+        fresh->flags = item->flags;
+        replace(item, fresh);
+        item = fresh;
+    }
+    item->concat(data.data(), data.size(), append);
+    return true;
+}
+
+// See ClockLRU.h
+bool ClockLRU::Put(const std::string &key, const std::string &value) { return ClockLRU::PutWithTTL(key, value, 0, 0); }
+
+// See ClockLRU.h
+bool ClockLRU::PutIfAbsent(const std::string &key, const std::string &value) {
+    return ClockLRU::PutIfAbsentWithTTL(key, value, 0, 0);
+}
+
+// See ClockLRU.h
+bool ClockLRU::Set(const std::string &key, const std::string &value) { return ClockLRU::SetWithTTL(key, value, 0, 0); }
+
+// See ClockLRU.h
+bool ClockLRU::Delete(const std::string &key) {
+    Item *item = find(hash_key(key), key, tick());
+    if (item == nullptr) {
+        return false;
+    }
+    delete_item(item);
+    return true;
+}
+
+// See ClockLRU.h
+bool ClockLRU::Get(const std::string &key, std::string &value) {
+    // Readers may run concurrently, so expired item is only skipped here and gets freed by writers
+    Item *item = _index.find(hash_key(key), key);
+    if (item == nullptr || (item->expire != 0 && item->expire <= _clock())) {
+        return false;
+    }
+    item->read(value);
+    item->referenced.store(true, std::memory_order_relaxed);
+    return true;
+}
+
+// See ClockLRU.h
+bool ClockLRU::GetView(const std::string &key, ValueView &value) {
+    Item *item = _index.find(hash_key(key), key);
+    if (item == nullptr || (item->expire != 0 && item->expire <= _clock())) {
+        return false;
+    }
+    value = Item::view(item);
+    item->referenced.store(true, std::memory_order_relaxed);
+    return true;
+}
+
+DeltaResult ClockLRU::delta(const std::string &key, uint64_t delta, bool increment, uint64_t &result) {
+    Item *item = find(hash_key(key), key, tick());
+    if (item == nullptr) {
+        return DeltaResult::NotFound;
+    }
+    uint64_t number;
+    if (!item->counter(number)) {
+        return DeltaResult::NonNumeric;
+    }
+    if (item->key_size + sizeof(uint64_t) > _max_size) {
+        return DeltaResult::NotStored;
+    }
+    result = increment ? number + delta : (number > delta ? number - delta : 0);
+    item->referenced.store(true, std::memory_order_relaxed);
+
+    if (!item->numeric || !item->exclusive()) {
+        // Counter switches to binary form, see SimpleCache::delta
+        current_size -= item->value_size;
+        evict(sizeof(uint64_t), item);
+        current_size += sizeof(uint64_t);
+        if (!item->exclusive() || item->key_size + sizeof(uint64_t) > item->capacity) {
+            Item *fresh = Item::create(item->hash, item->key(), item->key_size, "", 0, sizeof(uint64_t));
+            fresh->flags = item->flags;
+            replace(item, fresh);
+            item = fresh;
+        }
+    }
+    item->store(result);
+    return DeltaResult::Stored;
+}
+
+void ClockLRU::lookup(const std::vector<std::string> &keys, std::vector<ValueView> &values, ValueInfo *infos) {
+    uint32_t now = _clock();
+    std::vector<uint64_t> hashes(keys.size());
+    for (size_t i = 0; i < keys.size(); i++) {
+        hashes[i] = hash_key(keys[i]);
+    }
+
+    // Same two stage prefetch pipeline as in SimpleCache::GetBatch
+    for (size_t i = 0; i < keys.size() && i < 2 * kPrefetchDistance; i++) {
+        _index.prefetch(hashes[i]);
+    }
+    for (size_t i = 0; i < keys.size() && i < kPrefetchDistance; i++) {
+        _index.prefetch_node(hashes[i]);
+    }
+
+    for (size_t i = 0; i < keys.size(); i++) {
+        if (i + 2 * kPrefetchDistance < keys.size()) {
+            _index.prefetch(hashes[i + 2 * kPrefetchDistance]);
+        }
+        if (i + kPrefetchDistance < keys.size()) {
+            _index.prefetch_node(hashes[i + kPrefetchDistance]);
+        }
+
+        Item *item = _index.find(hashes[i], keys[i]);
+        if (item != nullptr && (item->expire == 0 || item->expire > now)) {
+            values[i] = Item::view(item);
+            if (infos != nullptr) {
+                infos[i].cas = item->cas;
+                infos[i].flags = item->flags;
+                infos[i].header = (item->header_size != 0) ? item->header() : nullptr;
+                infos[i].header_size = item->header_size;
+            }
+            item->referenced.store(true, std::memory_order_relaxed);
+        }
+    }
+}
+
+// See ClockLRU.h
+void ClockLRU::MultiGet(const std::vector<std::string> &keys, std::vector<ValueView> &values) {
+    values.clear();
+    values.resize(keys.size());
+    lookup(keys, values, nullptr);
+}
+
+// See ClockLRU.h
+void ClockLRU::MultiGetWithInfo(const std::vector<std::string> &keys, std::vector<ValueView> &values,
+                                std::vector<ValueInfo> &infos) {
+    values.clear();
+    values.resize(keys.size());
+    infos.resize(keys.size());
+    lookup(keys, values, infos.data());
+}
+
+// See ClockLRU.h
+bool ClockLRU::PutWithTTL(const std::string &key, const std::string &value, uint32_t ttl, uint32_t flags) {
+    if (key.size() + value.size() > _max_size) {
+        return false;
+    }
+    uint32_t now = tick();
+    uint64_t hash = hash_key(key);
+    Item *item = find(hash, key, now);
+    if (item != nullptr) {
+        update(item, key, value, expire_time(now, ttl), flags);
+    } else {
+        insert(hash, key, value, expire_time(now, ttl), flags);
+    }
+    return true;
+}
+
+// See ClockLRU.h
+bool ClockLRU::PutIfAbsentWithTTL(const std::string &key, const std::string &value, uint32_t ttl, uint32_t flags) {
+    if (key.size() + value.size() > _max_size) {
+        return false;
+    }
+    uint32_t now = tick();
+    uint64_t hash = hash_key(key);
+    if (find(hash, key, now) != nullptr) {
+        return false;
+    }
+    insert(hash, key, value, expire_time(now, ttl), flags);
+    return true;
+}
+
+// See ClockLRU.h
+bool ClockLRU::SetWithTTL(const std::string &key, const std::string &value, uint32_t ttl, uint32_t flags) {
+    if (key.size() + value.size() > _max_size) {
+        return false;
+    }
+    uint32_t now = tick();
+    Item *item = find(hash_key(key), key, now);
+    if (item == nullptr) {
+        return false;
+    }
+    update(item, key, value, expire_time(now, ttl), flags);
+    return true;
+}
+
+// See ClockLRU.h
+CasResult ClockLRU::CompareAndSwap(const std::string &key, const std::string &value, uint32_t ttl, uint32_t flags,
+                                   uint64_t cas) {
+    if (key.size() + value.size() > _max_size) {
+        return CasResult::NotStored;
+    }
+    uint32_t now = tick();
+    Item *item = find(hash_key(key), key, now);
+    if (item == nullptr) {
+        return CasResult::NotFound;
+    }
+    if (item->cas != cas) {
+        return CasResult::Exists;
+    }
+    update(item, key, value, expire_time(now, ttl), flags);
+    return CasResult::Stored;
+}
+
+// See ClockLRU.h
+bool ClockLRU::Append(const std::string &key, const std::string &data) { return concat(key, data, true); }
+
+// See ClockLRU.h
+bool ClockLRU::Prepend(const std::string &key, const std::string &data) { return concat(key, data, false); }
+
+// See ClockLRU.h
+DeltaResult ClockLRU::Increment(const std::string &key, uint64_t delta, uint64_t &result) {
+    return ClockLRU::delta(key, delta, true, result);
+}
+
+// See ClockLRU.h
+DeltaResult ClockLRU::Decrement(const std::string &key, uint64_t delta, uint64_t &result) {
+    return ClockLRU::delta(key, delta, false, result);
+}
+
+// See ClockLRU.h
+bool ClockLRU::EvictionCandidate(const std::string &key, const std::string &value, std::string &victim) {
+    size_t size = key.size() + value.size();
+    if (_hand == nullptr || size > _max_size || size + current_size <= _max_size) {
+        return false;
+    }
+
+    // Sweep without clearing bits: if every item is referenced the real sweep clears them all and
+    // comes back to the hand
+    Item *item = _hand;
+    while (item->referenced.load(std::memory_order_relaxed) && item->next != _hand) {
+        item = item->next;
+    }
+    if (item->referenced.load(std::memory_order_relaxed)) {
+        item = _hand;
+    }
+    victim.assign(item->key(), item->key_size);
+    return true;
+}
+
+// See ClockLRU.h
+void ClockLRU::Stats(std::map<std::string, std::string> &stats) {
+    stats["curr_items"] = std::to_string(_index.size());
+    stats["bytes"] = std::to_string(current_size);
+    stats["limit_maxbytes"] = std::to_string(_max_size);
+}
+
+} // namespace Backend
+} // namespace Afina
@@ -0,0 +1,143 @@
+#ifndef AFINA_STORAGE_CLOCK_LRU_H
+#define AFINA_STORAGE_CLOCK_LRU_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <afina/Storage.h>
+
+#include "HashIndex.h"
+#include "Item.h"
+#include "TimingWheel.h"
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # CLOCK based approximate LRU
+ * Items are kept in a ring with a "hand" pointing to the next eviction candidate. Cache hit only sets
+ * reference bit of the item, so Get doesn't modify any shared structure except one atomic flag. On
+ * eviction hand sweeps the ring: referenced items get second chance (bit cleared, hand moves on), the
+ * first item with cleared bit is evicted.
+ *
+ * Items with TTL are freed by timing wheel as SimpleCache does, see SimpleLRU.h. Get only skips
+ * expired item, since it must not modify cache.
+ *
+ * That is NOT thread safe implementaiton, however Get could run concurrently with other Gets, see
+ * ThreadSafeClockLRU.h
+ */
+class ClockLRU : public Afina::Storage {
+public:
+    ClockLRU(size_t max_size = 1024, Clock clock = steady_seconds)
+        : _max_size(max_size), current_size(0), _hand(nullptr), _clock(clock), _wheel(clock()) {}
+    ~ClockLRU();
+
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Delete(const std::string &key) override;
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool GetView(const std::string &key, ValueView &value) override;
+
+    // Implements Afina::Storage interface
+    void MultiGet(const std::vector<std::string> &keys, std::vector<ValueView> &values) override;
+
+    // Implements Afina::Storage interface
+    void MultiGetWithInfo(const std::vector<std::string> &keys, std::vector<ValueView> &values,
+                          std::vector<ValueInfo> &infos) override;
+
+    // Implements Afina::Storage interface
+    bool PutWithTTL(const std::string &key, const std::string &value, uint32_t ttl, uint32_t flags) override;
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsentWithTTL(const std::string &key, const std::string &value, uint32_t ttl, uint32_t flags) override;
+
+    // Implements Afina::Storage interface
+    bool SetWithTTL(const std::string &key, const std::string &value, uint32_t ttl, uint32_t flags) override;
+
+    // Implements Afina::Storage interface
+    CasResult CompareAndSwap(const std::string &key, const std::string &value, uint32_t ttl, uint32_t flags,
+                             uint64_t cas) override;
+
+    // Implements Afina::Storage interface
+    bool Append(const std::string &key, const std::string &data) override;
+
+    // Implements Afina::Storage interface
+    bool Prepend(const std::string &key, const std::string &data) override;
+
+    // Implements Afina::Storage interface
+    DeltaResult Increment(const std::string &key, uint64_t delta, uint64_t &result) override;
+
+    // Implements Afina::Storage interface
+    DeltaResult Decrement(const std::string &key, uint64_t delta, uint64_t &result) override;
+
+    // Implements Afina::Storage interface
+    bool EvictionCandidate(const std::string &key, const std::string &value, std::string &victim) override;
+
+    // Implements Afina::Storage interface
+    void Stats(std::map<std::string, std::string> &stats) override;
+
+private:
+    // Maximum number of bytes could be stored in this cache.
+    // i.e all (keys+values) must be less the _max_size
+    std::size_t _max_size;
+    std::size_t current_size;
+
+    // Ring of all items, hand points to the next eviction candidate, new items are placed right
+    // behind the hand so that they are examined the last. nullptr if ring is empty.
+    //
+    // Ring owns all items
+    Item *_hand;
+
+    // Index of items from the ring above
+    HashIndex<Item, ItemTraits> _index;
+
+    // Expiration of items with TTL
+    Clock _clock;
+    TimingWheel _wheel;
+
+    // Moves timing wheel to the current time, returns that time
+    uint32_t tick();
+    // Looks up item that isn't expired at the given time, expired one is deleted on the way
+    Item *find(uint64_t hash, const std::string &key, uint32_t now);
+    // Sets deadline of the item, 0 means it never expires
+    void set_expire(Item *item, uint32_t expire);
+
+    // Places item behind the hand
+    void link(Item *item);
+    // Removes item from the ring without freeing it
+    void unlink(Item *item);
+    // Removes item from index, ring and timing wheel, frees item memory
+    void delete_item(Item *item);
+    // Sweeps the ring until there is enough space to store extra size bytes, item keep is never evicted
+    void evict(size_t size, const Item *keep = nullptr);
+    // Creates new item for the key that isn't in the cache yet
+    void insert(uint64_t hash, const std::string &key, const std::string &value, uint32_t expire, uint32_t flags);
+    // Stores new value, deadline and flags for the existing item
+    void update(Item *item, const std::string &key, const std::string &value, uint32_t expire, uint32_t flags);
+    // Puts fresh item in place of the given one everywhere, deadline included, frees the old one
+    void replace(Item *item, Item *fresh);
+    // Adds data to the value of the existing key, in place if item has room for it or the value is chunked
+    bool concat(const std::string &key, const std::string &data, bool append);
+    // Updates counter of the existing key, keeps it in binary form in place
+    DeltaResult delta(const std::string &key, uint64_t delta, bool increment, uint64_t &result);
+    // Batch lookup that doesn't modify cache, metadata goes to infos unless it is nullptr
+    void lookup(const std::vector<std::string> &keys, std::vector<ValueView> &values, ValueInfo *infos);
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_CLOCK_LRU_H
@@ -0,0 +1,460 @@
+#include "CompactLRU.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+#include "HashIndex.h"
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * Header in the beginning of every item block, varint encoded flags and sizes follow it
+ */
+struct CompactLRU::Header {
+    // Links in the class list
+    uint32_t prev;
+    uint32_t next;
+
+    // Next item of the hash bucket
+    uint32_t chain;
+
+    // Clock time when item expires, 0 if it never does
+    uint32_t expire;
+};
+
+// Offsets are counted in these granules, slab chunks are aligned to them
+static const size_t kGranule = 16;
+
+// Initial number of hash buckets
+static const size_t kMinBuckets = 1024;
+
+// Region for the given budget, see SlabLRU.cpp
+static size_t region_size(size_t max_size) {
+    size_t size = std::max(max_size, Allocator::Slab::kPageSize) + Allocator::Slab::kPageSize - 1;
+    if (size / kGranule > UINT32_MAX) {
+        throw std::runtime_error("Region is too large for 32-bit item offsets");
+    }
+    return size;
+}
+
+// LEB128: 7 bits per byte, lowest first, high bit is set on every byte but the last one
+static uint8_t *put_varint(uint8_t *out, uint32_t value) {
+    while (value >= 0x80) {
+        *out++ = uint8_t(value) | 0x80;
+        value >>= 7;
+    }
+    *out++ = uint8_t(value);
+    return out;
+}
+
+static const uint8_t *get_varint(const uint8_t *in, uint32_t &value) {
+    value = 0;
+    for (unsigned shift = 0;; shift += 7) {
+        uint8_t byte = *in++;
+        value |= uint32_t(byte & 0x7f) << shift;
+        if (byte < 0x80) {
+            return in;
+        }
+    }
+}
+
+static size_t varint_size(uint32_t value) {
+    size_t size = 1;
+    while (value >= 0x80) {
+        value >>= 7;
+        size++;
+    }
+    return size;
+}
+
+CompactLRU::CompactLRU(size_t max_size, double factor, Clock clock, Allocator::HugePages huge_pages)
+    : _max_size(max_size), _memory(region_size(max_size), huge_pages),
+      _slab(_memory.data(), region_size(max_size), factor), _base(static_cast<char *>(_memory.data())),
+      _lru(_slab.classes(), List{0, 0}), _buckets(kMinBuckets, 0), _clock(clock), _items(0), _current_size(0),
+      _evictions(0), _prefault_ms(-1) {}
+
+CompactLRU::Header *CompactLRU::item(uint32_t offset) const {
+    return reinterpret_cast<Header *>(_base + size_t(offset) * kGranule);
+}
+
+uint32_t CompactLRU::offset(const Header *item) const {
+    return uint32_t((reinterpret_cast<const char *>(item) - _base) / kGranule);
+}
+
+size_t CompactLRU::decode(const Header *item, Fields &fields) {
+    const uint8_t *p = reinterpret_cast<const uint8_t *>(item + 1);
+    p = get_varint(p, fields.flags);
+    p = get_varint(p, fields.key_size);
+    p = get_varint(p, fields.value_size);
+    fields.key = reinterpret_cast<const char *>(p);
+    fields.value = fields.key + fields.key_size;
+    return (fields.value + fields.value_size) - reinterpret_cast<const char *>(item);
+}
+
+size_t CompactLRU::block_size(uint32_t flags, size_t key_size, size_t value_size) {
+    return sizeof(Header) + varint_size(flags) + varint_size(key_size) + varint_size(value_size) + key_size +
+           value_size;
+}
+
+size_t CompactLRU::class_of(const Header *item) const {
+    Fields fields;
+    return _slab.class_of(decode(item, fields));
+}
+
+void CompactLRU::link(size_t cls, Header *item) {
+    List &list = _lru[cls];
+    item->prev = list.tail;
+    item->next = 0;
+    if (list.tail != 0) {
+        this->item(list.tail)->next = offset(item);
+    } else {
+        list.head = offset(item);
+    }
+    list.tail = offset(item);
+}
+
+void CompactLRU::unlink(size_t cls, Header *item) {
+    List &list = _lru[cls];
+    if (item->prev != 0) {
+        this->item(item->prev)->next = item->next;
+    } else {
+        list.head = item->next;
+    }
+    if (item->next != 0) {
+        this->item(item->next)->prev = item->prev;
+    } else {
+        list.tail = item->prev;
+    }
+}
+
+void CompactLRU::grow() {
+    std::vector<uint32_t> buckets(2 * _buckets.size(), 0);
+    size_t mask = buckets.size() - 1;
+    for (uint32_t head : _buckets) {
+        while (head != 0) {
+            Header *current = item(head);
+            uint32_t next = current->chain;
+            Fields fields;
+            decode(current, fields);
+            uint32_t &bucket = buckets[hash_key(fields.key, fields.key_size) & mask];
+            current->chain = bucket;
+            bucket = head;
+            head = next;
+        }
+    }
+    _buckets.swap(buckets);
+}
+
+CompactLRU::Header *CompactLRU::find(uint64_t hash, const std::string &key, uint32_t now) {
+    for (uint32_t o = _buckets[hash & (_buckets.size() - 1)]; o != 0;) {
+        Header *current = item(o);
+        Fields fields;
+        decode(current, fields);
+        if (fields.key_size == key.size() && std::memcmp(fields.key, key.data(), key.size()) == 0) {
+            if (current->expire != 0 && current->expire <= now) {
+                delete_item(current);
+                return nullptr;
+            }
+            return current;
+        }
+        o = current->chain;
+    }
+    return nullptr;
+}
+
+void CompactLRU::delete_item(Header *item) {
+    Fields fields;
+    unlink(_slab.class_of(decode(item, fields)), item);
+
+    uint32_t *link = &_buckets[hash_key(fields.key, fields.key_size) & (_buckets.size() - 1)];
+    while (*link != offset(item)) {
+        link = &this->item(*link)->chain;
+    }
+    *link = item->chain;
+
+    _items--;
+    _current_size -= size_t(fields.key_size) + fields.value_size;
+    Allocator::Slab::free(item);
+}
+
+size_t CompactLRU::largest(size_t except) const {
+    size_t result = _slab.classes();
+    size_t result_pages = 0;
+    for (size_t cls = 0; cls < _slab.classes(); cls++) {
+        if (cls == except || _lru[cls].head == 0) {
+            continue;
+        }
+        size_t pages = _slab.class_pages(cls);
+        if (pages > result_pages) {
+            result = cls;
+            result_pages = pages;
+        }
+    }
+    return result;
+}
+
+bool CompactLRU::free_page(size_t cls) {
+    if (_lru[cls].head == 0) {
+        return false;
+    }
+
+    // Items of a page are scattered over the list, the whole list is scanned
+    const void *page = Allocator::Slab::page_of(item(_lru[cls].head));
+    for (uint32_t o = _lru[cls].head; o != 0;) {
+        Header *current = item(o);
+        o = current->next;
+        if (Allocator::Slab::page_of(current) == page) {
+            delete_item(current);
+            _evictions++;
+        }
+    }
+    return true;
+}
+
+bool CompactLRU::insert(uint64_t hash, const std::string &key, const char *value, size_t value_size,
+                        uint32_t expire, uint32_t flags) {
+    size_t size = block_size(flags, key.size(), value_size);
+    size_t cls = _slab.class_of(size);
+    if (cls == _slab.classes()) {
+        return false;
+    }
+
+    void *block;
+    while ((block = _slab.try_alloc(size)) == nullptr) {
+        if (_lru[cls].head != 0) {
+            delete_item(item(_lru[cls].head));
+            _evictions++;
+            continue;
+        }
+
+        // Class is starved, page of the largest class is taken right away
+        size_t source = largest(cls);
+        if (source == _slab.classes() || !free_page(source)) {
+            return false;
+        }
+    }
+
+    Header *fresh = static_cast<Header *>(block);
+    fresh->expire = expire;
+    uint8_t *p = reinterpret_cast<uint8_t *>(fresh + 1);
+    p = put_varint(p, flags);
+    p = put_varint(p, key.size());
+    p = put_varint(p, value_size);
+    std::memcpy(p, key.data(), key.size());
+    std::memcpy(p + key.size(), value, value_size);
+    link(cls, fresh);
+
+    if (_items >= _buckets.size()) {
+        grow();
+    }
+    uint32_t &bucket = _buckets[hash & (_buckets.size() - 1)];
+    fresh->chain = bucket;
+    bucket = offset(fresh);
+
+    _items++;
+    _current_size += key.size() + value_size;
+    return true;
+}
+
+bool CompactLRU::rewrite(Header *item, const std::string &value) {
+    Fields fields;
+    decode(item, fields);
+    if (_slab.class_of(block_size(fields.flags, fields.key_size, value.size())) == _slab.classes()) {
+        return false;
+    }
+    std::string key(fields.key, fields.key_size);
+    std::string old(fields.value, fields.value_size);
+    uint32_t expire = item->expire;
+    uint32_t flags = fields.flags;
+    uint64_t hash = hash_key(key);
+
+    // Old item goes first, so that its memory could serve the new one. If the new one gets no memory anyway,
+    // old value is put back into the chunk just freed: failed write keeps it, as memcached does
+    delete_item(item);
+    if (insert(hash, key, value.data(), value.size(), expire, flags)) {
+        return true;
+    }
+    insert(hash, key, old.data(), old.size(), expire, flags);
+    return false;
+}
+
+// See CompactLRU.h
+void CompactLRU::Start() {
+    size_t n_threads = std::max(1u, std::thread::hardware_concurrency());
+    _prefault_ms = _memory.prefault(n_threads).count();
+}
+
+// See CompactLRU.h
+bool CompactLRU::Put(const std::string &key, const std::string &value) {
+    return CompactLRU::PutWithTTL(key, value, 0, 0);
+}
+
+// See CompactLRU.h
+bool CompactLRU::PutIfAbsent(const std::string &key, const std::string &value) {
+    return CompactLRU::PutIfAbsentWithTTL(key, value, 0, 0);
+}
+
+// See CompactLRU.h
+bool CompactLRU::Set(const std::string &key, const std::string &value) {
+    return CompactLRU::SetWithTTL(key, value, 0, 0);
+}
+
+// See CompactLRU.h
+bool CompactLRU::PutWithTTL(const std::string &key, const std::string &value, uint32_t ttl, uint32_t flags) {
+    if (key.size() + value.size() > _max_size) {
+        return false;
+    }
+    uint32_t now = _clock();
+    uint64_t hash = hash_key(key);
+    Header *current = find(hash, key, now);
+    if (current != nullptr) {
+        delete_item(current);
+    }
+    return insert(hash, key, value.data(), value.size(), expire_time(now, ttl), flags);
+}
+
+// See CompactLRU.h
+bool CompactLRU::PutIfAbsentWithTTL(const std::string &key, const std::string &value, uint32_t ttl,
+                                    uint32_t flags) {
+    if (key.size() + value.size() > _max_size) {
+        return false;
+    }
+    uint32_t now = _clock();
+    uint64_t hash = hash_key(key);
+    if (find(hash, key, now) != nullptr) {
+        return false;
+    }
+    return insert(hash, key, value.data(), value.size(), expire_time(now, ttl), flags);
+}
+
+// See CompactLRU.h
+bool CompactLRU::SetWithTTL(const std::string &key, const std::string &value, uint32_t ttl, uint32_t flags) {
+    uint32_t now = _clock();
+    uint64_t hash = hash_key(key);
+    Header *current = find(hash, key, now);
+    if (current == nullptr) {
+        return false;
+    }
+    delete_item(current);
+    if (key.size() + value.size() > _max_size) {
+        return false;
+    }
+    return insert(hash, key, value.data(), value.size(), expire_time(now, ttl), flags);
+}
+
+// See CompactLRU.h
+bool CompactLRU::Delete(const std::string &key) {
+    Header *current = find(hash_key(key), key, _clock());
+    if (current == nullptr) {
+        return false;
+    }
+    delete_item(current);
+    return true;
+}
+
+// See CompactLRU.h
+bool CompactLRU::Get(const std::string &key, std::string &value) {
+    Header *current = find(hash_key(key), key, _clock());
+    if (current == nullptr) {
+        return false;
+    }
+    Fields fields;
+    size_t cls = _slab.class_of(decode(current, fields));
+    value.assign(fields.value, fields.value_size);
+    unlink(cls, current);
+    link(cls, current);
+    return true;
+}
+
+// See CompactLRU.h
+void CompactLRU::MultiGetWithInfo(const std::vector<std::string> &keys, std::vector<ValueView> &values,
+                                  std::vector<ValueInfo> &infos) {
+    uint32_t now = _clock();
+    values.clear();
+    values.resize(keys.size());
+    infos.assign(keys.size(), ValueInfo{0, 0, nullptr, 0});
+    for (size_t i = 0; i < keys.size(); i++) {
+        Header *current = find(hash_key(keys[i]), keys[i], now);
+        if (current == nullptr) {
+            continue;
+        }
+        Fields fields;
+        size_t cls = _slab.class_of(decode(current, fields));
+        values[i] = ValueView::Copy(std::string(fields.value, fields.value_size));
+        infos[i].flags = fields.flags;
+        unlink(cls, current);
+        link(cls, current);
+    }
+}
+
+bool CompactLRU::concat(const std::string &key, const std::string &data, bool append) {
+    Header *current = find(hash_key(key), key, _clock());
+    if (current == nullptr) {
+        return false;
+    }
+    Fields fields;
+    decode(current, fields);
+    std::string value(fields.value, fields.value_size);
+    if (value.size() + data.size() + key.size() > _max_size) {
+        return false;
+    }
+    return rewrite(current, append ? value + data : data + value);
+}
+
+// See CompactLRU.h
+bool CompactLRU::Append(const std::string &key, const std::string &data) { return concat(key, data, true); }
+
+// See CompactLRU.h
+bool CompactLRU::Prepend(const std::string &key, const std::string &data) { return concat(key, data, false); }
+
+DeltaResult CompactLRU::delta(const std::string &key, uint64_t delta, bool increment, uint64_t &result) {
+    Header *current = find(hash_key(key), key, _clock());
+    if (current == nullptr) {
+        return DeltaResult::NotFound;
+    }
+    Fields fields;
+    decode(current, fields);
+    uint64_t number;
+    if (!ParseCounter(fields.value, fields.value_size, number)) {
+        return DeltaResult::NonNumeric;
+    }
+    if (increment) {
+        result = number + delta;
+    } else {
+        result = (number > delta) ? number - delta : 0;
+    }
+    return rewrite(current, std::to_string(result)) ? DeltaResult::Stored : DeltaResult::NotStored;
+}
+
+// See CompactLRU.h
+DeltaResult CompactLRU::Increment(const std::string &key, uint64_t delta, uint64_t &result) {
+    return this->delta(key, delta, true, result);
+}
+
+// See CompactLRU.h
+DeltaResult CompactLRU::Decrement(const std::string &key, uint64_t delta, uint64_t &result) {
+    return this->delta(key, delta, false, result);
+}
+
+// See CompactLRU.h
+void CompactLRU::Stats(std::map<std::string, std::string> &stats) {
+    stats["curr_items"] = std::to_string(_items);
+    stats["bytes"] = std::to_string(_current_size);
+    stats["limit_maxbytes"] = std::to_string(_max_size);
+    stats["evictions"] = std::to_string(_evictions);
+    stats["slab_pages"] = std::to_string(_slab.pages());
+    stats["slab_free_pages"] = std::to_string(_slab.free_pages());
+    stats["hash_buckets"] = std::to_string(_buckets.size());
+
+    static const char *pages[] = {"none", "transparent", "explicit"};
+    stats["huge_pages"] = pages[int(_memory.huge_pages())];
+    if (_prefault_ms >= 0) {
+        stats["prefault_ms"] = std::to_string(_prefault_ms);
+    }
+}
+
+} // namespace Backend
+} // namespace Afina
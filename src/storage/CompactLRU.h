@@ -0,0 +1,178 @@
+#ifndef AFINA_STORAGE_COMPACT_LRU_H
+#define AFINA_STORAGE_COMPACT_LRU_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <afina/Storage.h>
+#include <afina/allocator/Region.h>
+#include <afina/allocator/Slab.h>
+
+#include "TimingWheel.h"
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # LRU with compact items
+ * Keeps items in a single region carved by Allocator::Slab, the same way SlabLRU does, but squeezes
+ * per item overhead for small values. Since every item lives in the region, links between items are
+ * 32-bit offsets in the region rather than pointers, and item block is:
+ *
+ * [ prev | next | chain | expire | varint flags | varint key size | varint value size | key | value ]
+ *
+ * That is 16 bytes of header and usually 3 bytes of sizes, against 80 bytes of Item. Hash index is an
+ * array of 32-bit chain heads, chains go through the items themselves. Hash of the key isn't stored,
+ * it is computed again whenever item moves to another bucket.
+ *
+ * Savings come at a price:
+ * - expired items are only deleted on access or eviction, there is no timing wheel
+ * - values aren't versioned, CompareAndSwap never stores anything
+ * - views are copies of values, item memory is reused as soon as item is gone
+ * - values are never modified in place, every write builds a new item
+ *
+ * Region could take up to 64 GB, offsets are counted in 16 bytes granules.
+ *
+ * That is NOT thread safe implementaiton
+ */
+class CompactLRU : public Afina::Storage {
+public:
+    /**
+     * @param max_size number of bytes in the region, at least one slab page is taken
+     * @param factor ratio of chunk sizes of the adjacent slab classes
+     * @param huge_pages pages to back the region by, see Allocator::Region
+     */
+    CompactLRU(size_t max_size = 64 << 20, double factor = 1.25, Clock clock = steady_seconds,
+               Allocator::HugePages huge_pages = Allocator::HugePages::None);
+    ~CompactLRU() {}
+
+    // Prefaults the region in parallel, must be called before the cache is used
+    void Start() override;
+
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Delete(const std::string &key) override;
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, std::string &value) override;
+
+    // Implements Afina::Storage interface
+    void MultiGetWithInfo(const std::vector<std::string> &keys, std::vector<ValueView> &values,
+                          std::vector<ValueInfo> &infos) override;
+
+    // Implements Afina::Storage interface
+    bool PutWithTTL(const std::string &key, const std::string &value, uint32_t ttl, uint32_t flags) override;
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsentWithTTL(const std::string &key, const std::string &value, uint32_t ttl, uint32_t flags) override;
+
+    // Implements Afina::Storage interface
+    bool SetWithTTL(const std::string &key, const std::string &value, uint32_t ttl, uint32_t flags) override;
+
+    // Implements Afina::Storage interface
+    bool Append(const std::string &key, const std::string &data) override;
+
+    // Implements Afina::Storage interface
+    bool Prepend(const std::string &key, const std::string &data) override;
+
+    // Implements Afina::Storage interface
+    DeltaResult Increment(const std::string &key, uint64_t delta, uint64_t &result) override;
+
+    // Implements Afina::Storage interface
+    DeltaResult Decrement(const std::string &key, uint64_t delta, uint64_t &result) override;
+
+    // Implements Afina::Storage interface, adds slab usage and number of evictions
+    void Stats(std::map<std::string, std::string> &stats) override;
+
+private:
+    struct Header;
+
+    // Item fields following the header
+    struct Fields {
+        uint32_t flags;
+        const char *key;
+        uint32_t key_size;
+        const char *value;
+        uint32_t value_size;
+    };
+
+    // Head and tail of the class list
+    struct List {
+        uint32_t head;
+        uint32_t tail;
+    };
+
+    // Region all items live in and allocator carving it
+    const std::size_t _max_size;
+    Allocator::Region _memory;
+    Allocator::Slab _slab;
+    char *_base;
+
+    // LRU list of every slab class
+    std::vector<List> _lru;
+
+    // Hash index: chain head of every bucket, number of buckets is a power of 2
+    std::vector<uint32_t> _buckets;
+
+    Clock _clock;
+
+    // Number of items, total number of bytes in their keys and values, items evicted for others
+    std::size_t _items;
+    std::size_t _current_size;
+    uint64_t _evictions;
+
+    // Time the last Start spent on prefaulting the region, -1 if it was never called
+    int64_t _prefault_ms;
+
+    // Conversion between item and its offset, 0 stands for nullptr
+    Header *item(uint32_t offset) const;
+    uint32_t offset(const Header *item) const;
+
+    // Decodes fields following the header, returns number of bytes item takes
+    static size_t decode(const Header *item, Fields &fields);
+    // Number of bytes item with given fields takes
+    static size_t block_size(uint32_t flags, size_t key_size, size_t value_size);
+    // Slab class of the item
+    size_t class_of(const Header *item) const;
+
+    // Looks up item that isn't expired at the given time, expired one is deleted on the way
+    Header *find(uint64_t hash, const std::string &key, uint32_t now);
+    // Builds new item, evicts least recently used items of its class while it has no room. Returns false
+    // if item doesn't fit into any class or there is nothing left to evict
+    bool insert(uint64_t hash, const std::string &key, const char *value, size_t value_size, uint32_t expire,
+                uint32_t flags);
+    // Removes item from its list and its chain, frees item memory
+    void delete_item(Header *item);
+    // Evicts every item of the page holding the least recently used item of the class, returns false if
+    // class has no items
+    bool free_page(size_t cls);
+    // Class having the most pages other than except, number of classes if there is none having items
+    size_t largest(size_t except) const;
+
+    // List helpers
+    void link(size_t cls, Header *item);
+    void unlink(size_t cls, Header *item);
+    // Doubles number of buckets
+    void grow();
+
+    // Replaces value of the existing item keeping its deadline and flags
+    bool rewrite(Header *item, const std::string &value);
+    // Adds data to the value of the existing key
+    bool concat(const std::string &key, const std::string &data, bool append);
+    // Updates counter of the existing key
+    DeltaResult delta(const std::string &key, uint64_t delta, bool increment, uint64_t &result);
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_COMPACT_LRU_H
@@ -0,0 +1,645 @@
+#include "CuckooClock.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <thread>
+
+#include "HashIndex.h"
+#include "Item.h"
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * Header in the beginning of every item block, key and value follow it. Readers look at it while the writer
+ * could free and reuse the block, so fields are atomics, the version counter orders them
+ */
+struct CuckooClock::Entry {
+    // Hash of the key, so that item finds its version counter without rehash
+    std::atomic<uint64_t> hash;
+
+    // Version of the value, see Afina::ValueInfo
+    std::atomic<uint64_t> cas;
+
+    // Clock time when item expires, 0 if it never does
+    std::atomic<uint32_t> expire;
+
+    // Opaque client flags, see Afina::ValueInfo
+    std::atomic<uint32_t> flags;
+
+    std::atomic<uint32_t> key_size;
+    std::atomic<uint32_t> value_size;
+
+    char *key() { return reinterpret_cast<char *>(this + 1); }
+    const char *key() const { return reinterpret_cast<const char *>(this + 1); }
+
+    const char *value() const { return key() + key_size; }
+
+    bool expired(uint32_t now) const { return expire != 0 && expire <= now; }
+};
+
+// Copies bytes of the item memory readers could look at concurrently, aligned words are moved whole
+static void load_bytes(char *to, const char *from, size_t n) {
+    size_t i = 0;
+    for (; i < n && reinterpret_cast<uintptr_t>(from + i) % 8 != 0; i++) {
+        to[i] = __atomic_load_n(from + i, __ATOMIC_RELAXED);
+    }
+    for (; i + 8 <= n; i += 8) {
+        uint64_t word = __atomic_load_n(reinterpret_cast<const uint64_t *>(from + i), __ATOMIC_RELAXED);
+        std::memcpy(to + i, &word, 8);
+    }
+    for (; i < n; i++) {
+        to[i] = __atomic_load_n(from + i, __ATOMIC_RELAXED);
+    }
+}
+
+static void store_bytes(char *to, const char *from, size_t n) {
+    size_t i = 0;
+    for (; i < n && reinterpret_cast<uintptr_t>(to + i) % 8 != 0; i++) {
+        __atomic_store_n(to + i, from[i], __ATOMIC_RELAXED);
+    }
+    for (; i + 8 <= n; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, from + i, 8);
+        __atomic_store_n(reinterpret_cast<uint64_t *>(to + i), word, __ATOMIC_RELAXED);
+    }
+    for (; i < n; i++) {
+        __atomic_store_n(to + i, from[i], __ATOMIC_RELAXED);
+    }
+}
+
+// Compares item memory readers could look at concurrently with the key
+static bool equal_bytes(const char *shared, const std::string &key) {
+    char block[64];
+    for (size_t i = 0; i < key.size(); i += sizeof(block)) {
+        size_t n = std::min(sizeof(block), key.size() - i);
+        load_bytes(block, shared + i, n);
+        if (std::memcmp(block, key.data() + i, n) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+constexpr size_t CuckooClock::kSlots;
+
+// Number of version counters, power of 2
+static const size_t kStripes = 8192;
+
+// Number of buckets displacement search examines before giving up
+static const size_t kMaxSearch = 256;
+
+// Region for the given budget, see SlabLRU.cpp
+static size_t region_size(size_t max_size) {
+    return std::max(max_size, Allocator::Slab::kPageSize) + Allocator::Slab::kPageSize - 1;
+}
+
+// Enough buckets for the slab pages filled by the smallest chunks
+static size_t table_size(size_t pages) {
+    size_t buckets = 16;
+    while (buckets * 4 < pages * (Allocator::Slab::kPageSize / Allocator::Slab::kMinChunk)) {
+        buckets *= 2;
+    }
+    return buckets;
+}
+
+CuckooClock::CuckooClock(size_t max_size, double factor, Clock clock, Allocator::HugePages huge_pages)
+    : _max_size(max_size), _memory(region_size(max_size), huge_pages),
+      _slab(_memory.data(), region_size(max_size), factor), _buckets(table_size(_slab.pages())), _versions(kStripes),
+      _clock(clock), _hand(0), _items(0), _current_size(0), _evictions(0), _displacements(0), _prefault_ms(-1) {}
+
+uint8_t CuckooClock::tag_of(uint64_t hash) {
+    uint8_t tag = uint8_t(hash >> 56);
+    return (tag != 0) ? tag : 1;
+}
+
+size_t CuckooClock::bucket_of(uint64_t hash) const { return hash & (_buckets.size() - 1); }
+
+size_t CuckooClock::alternate(size_t bucket, uint8_t tag) const {
+    // Xor keeps it symmetric: alternate of the alternate is the bucket itself
+    return (bucket ^ (tag * 0xc6a4a7935bd1e995ull)) & (_buckets.size() - 1);
+}
+
+std::atomic<uint32_t> &CuckooClock::version_of(uint64_t hash) { return _versions[(hash >> 24) & (kStripes - 1)]; }
+
+void CuckooClock::begin_write(uint64_t hash) {
+    std::atomic<uint32_t> &version = version_of(hash);
+    version.store(version.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+void CuckooClock::end_write(uint64_t hash) {
+    std::atomic<uint32_t> &version = version_of(hash);
+    version.store(version.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+bool CuckooClock::read(uint64_t hash, const std::string &key, uint32_t now, std::string &value, ValueInfo *info) {
+    const uint8_t tag = tag_of(hash);
+    const size_t first = bucket_of(hash);
+    const size_t candidates[] = {first, alternate(first, tag)};
+    std::atomic<uint32_t> &version = version_of(hash);
+
+    for (;;) {
+        uint32_t before = version.load(std::memory_order_acquire);
+        if (before & 1) {
+            // Writer is in the middle of the change, let it finish
+            std::this_thread::yield();
+            continue;
+        }
+
+        // Item could be freed and reused meanwhile, so header is loaded once and sizes are checked against its
+        // page before any copy: chunk never crosses the page end
+        std::atomic<uint8_t> *referenced = nullptr;
+        for (size_t b = 0; b < 2 && referenced == nullptr; b++) {
+            Bucket &bucket = _buckets[candidates[b]];
+            for (size_t i = 0; i < kSlots; i++) {
+                if (bucket.tags[i].load(std::memory_order_relaxed) != tag) {
+                    continue;
+                }
+                const Entry *entry = bucket.entries[i].load(std::memory_order_acquire);
+                if (entry == nullptr || entry->hash.load(std::memory_order_relaxed) != hash) {
+                    continue;
+                }
+                const uint32_t key_size = entry->key_size.load(std::memory_order_relaxed);
+                const uint32_t value_size = entry->value_size.load(std::memory_order_relaxed);
+                const char *page_end = static_cast<const char *>(Allocator::Slab::page_of(entry)) +
+                                       Allocator::Slab::kPageSize;
+                if (key_size != key.size() || size_t(key_size) + value_size > size_t(page_end - entry->key()) ||
+                    !equal_bytes(entry->key(), key)) {
+                    continue;
+                }
+                const uint32_t expire = entry->expire.load(std::memory_order_relaxed);
+                if (expire == 0 || expire > now) {
+                    value.resize(value_size);
+                    load_bytes(&value[0], entry->key() + key_size, value_size);
+                    if (info != nullptr) {
+                        info->cas = entry->cas.load(std::memory_order_relaxed);
+                        info->flags = entry->flags.load(std::memory_order_relaxed);
+                    }
+                    referenced = &bucket.referenced[i];
+                }
+                break;
+            }
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (version.load(std::memory_order_relaxed) != before) {
+            continue;
+        }
+        if (referenced == nullptr) {
+            return false;
+        }
+        // Slot could hold another item by now, that one gets second chance instead
+        if (referenced->load(std::memory_order_relaxed) == 0) {
+            referenced->store(1, std::memory_order_relaxed);
+        }
+        return true;
+    }
+}
+
+CuckooClock::Entry *CuckooClock::find(uint64_t hash, const std::string &key, uint32_t now, size_t &bucket,
+                                      size_t &slot) {
+    const uint8_t tag = tag_of(hash);
+    const size_t first = bucket_of(hash);
+    const size_t candidates[] = {first, alternate(first, tag)};
+    for (size_t b : candidates) {
+        for (size_t i = 0; i < kSlots; i++) {
+            Entry *entry = _buckets[b].entries[i].load(std::memory_order_relaxed);
+            if (entry == nullptr || _buckets[b].tags[i].load(std::memory_order_relaxed) != tag ||
+                entry->hash != hash || entry->key_size != key.size() ||
+                std::memcmp(entry->key(), key.data(), key.size()) != 0) {
+                continue;
+            }
+            if (entry->expired(now)) {
+                remove(b, i);
+                return nullptr;
+            }
+            bucket = b;
+            slot = i;
+            return entry;
+        }
+    }
+    return nullptr;
+}
+
+size_t CuckooClock::class_of(const Entry *entry) const {
+    return _slab.class_of(sizeof(Entry) + entry->key_size + entry->value_size);
+}
+
+void CuckooClock::remove(size_t bucket, size_t slot) {
+    Bucket &b = _buckets[bucket];
+    Entry *entry = b.entries[slot].load(std::memory_order_relaxed);
+    begin_write(entry->hash);
+    b.tags[slot].store(0, std::memory_order_relaxed);
+    b.entries[slot].store(nullptr, std::memory_order_relaxed);
+    b.referenced[slot].store(0, std::memory_order_relaxed);
+    end_write(entry->hash);
+
+    _items--;
+    _current_size -= size_t(entry->key_size) + entry->value_size;
+    Allocator::Slab::free(entry);
+}
+
+void CuckooClock::replace(size_t bucket, size_t slot, Entry *fresh) {
+    Bucket &b = _buckets[bucket];
+    Entry *entry = b.entries[slot].load(std::memory_order_relaxed);
+    begin_write(entry->hash);
+    b.entries[slot].store(fresh, std::memory_order_release);
+    b.referenced[slot].store(1, std::memory_order_relaxed);
+    end_write(entry->hash);
+
+    _current_size -= size_t(entry->key_size) + entry->value_size;
+    _current_size += size_t(fresh->key_size) + fresh->value_size;
+    Allocator::Slab::free(entry);
+}
+
+CuckooClock::Entry *CuckooClock::create(uint64_t hash, const std::string &key, const char *value,
+                                        size_t value_size, uint32_t expire, uint32_t flags, const Entry *keep) {
+    size_t size = sizeof(Entry) + key.size() + value_size;
+    size_t cls = _slab.class_of(size);
+    if (cls == _slab.classes()) {
+        return nullptr;
+    }
+
+    // Two rounds clear every reference bit, so the third one finds item of the class unless keep is the only one
+    const size_t n_slots = _buckets.size() * kSlots;
+    const uint32_t now = _clock();
+    void *block;
+    for (size_t steps = 0; (block = _slab.try_alloc(size)) == nullptr; steps++) {
+        // Class having no items to evict gets a page of another class, emptied as a whole
+        if (_slab.class_used(cls) == 0 || steps >= 3 * n_slots) {
+            if (!free_page(keep)) {
+                return nullptr;
+            }
+            continue;
+        }
+        size_t bucket = _hand / kSlots, slot = _hand % kSlots;
+        _hand = (_hand + 1) % n_slots;
+
+        Bucket &b = _buckets[bucket];
+        Entry *entry = b.entries[slot].load(std::memory_order_relaxed);
+        if (entry == nullptr || entry == keep) {
+            continue;
+        }
+        if (entry->expired(now)) {
+            remove(bucket, slot);
+            continue;
+        }
+        if (b.referenced[slot].load(std::memory_order_relaxed) != 0) {
+            b.referenced[slot].store(0, std::memory_order_relaxed);
+            continue;
+        }
+        if (class_of(entry) != cls) {
+            continue;
+        }
+        remove(bucket, slot);
+        _evictions++;
+    }
+
+    // Stale readers could still look at the block, see read()
+    Entry *entry = static_cast<Entry *>(block);
+    entry->hash.store(hash, std::memory_order_relaxed);
+    entry->cas.store(Item::next_cas(), std::memory_order_relaxed);
+    entry->expire.store(expire, std::memory_order_relaxed);
+    entry->flags.store(flags, std::memory_order_relaxed);
+    entry->key_size.store(key.size(), std::memory_order_relaxed);
+    entry->value_size.store(value_size, std::memory_order_relaxed);
+    store_bytes(entry->key(), key.data(), key.size());
+    store_bytes(entry->key() + key.size(), value, value_size);
+    return entry;
+}
+
+bool CuckooClock::free_page(const Entry *keep) {
+    // Page of the first item hand finds unreferenced goes
+    const size_t n_slots = _buckets.size() * kSlots;
+    const void *kept = (keep != nullptr) ? Allocator::Slab::page_of(keep) : nullptr;
+    const void *page = nullptr;
+    for (size_t steps = 0; page == nullptr && steps < 2 * n_slots; steps++) {
+        Bucket &b = _buckets[_hand / kSlots];
+        size_t slot = _hand % kSlots;
+        _hand = (_hand + 1) % n_slots;
+
+        Entry *entry = b.entries[slot].load(std::memory_order_relaxed);
+        if (entry == nullptr || Allocator::Slab::page_of(entry) == kept) {
+            continue;
+        }
+        if (b.referenced[slot].load(std::memory_order_relaxed) != 0) {
+            b.referenced[slot].store(0, std::memory_order_relaxed);
+            continue;
+        }
+        page = Allocator::Slab::page_of(entry);
+    }
+    if (page == nullptr) {
+        return false;
+    }
+
+    // Items of a page are scattered over the table, the whole table is scanned
+    for (size_t i = 0; i < n_slots; i++) {
+        Entry *entry = _buckets[i / kSlots].entries[i % kSlots].load(std::memory_order_relaxed);
+        if (entry != nullptr && Allocator::Slab::page_of(entry) == page) {
+            remove(i / kSlots, i % kSlots);
+            _evictions++;
+        }
+    }
+    return true;
+}
+
+bool CuckooClock::displace(size_t first, size_t second) {
+    // Breadth first search over buckets, so that the chain of moves is the shortest one
+    struct Step {
+        size_t bucket;
+        // Step that led here and its slot moved to this bucket, -1 for the starting buckets
+        int parent;
+        size_t slot;
+    };
+    std::vector<Step> steps{{first, -1, 0}};
+    if (second != first) {
+        steps.push_back({second, -1, 0});
+    }
+
+    for (size_t head = 0; head < steps.size() && steps.size() < kMaxSearch; head++) {
+        Bucket &b = _buckets[steps[head].bucket];
+        for (size_t i = 0; i < kSlots; i++) {
+            size_t target = alternate(steps[head].bucket, b.tags[i].load(std::memory_order_relaxed));
+            steps.push_back({target, int(head), i});
+
+            size_t empty = kSlots;
+            for (size_t j = 0; j < kSlots && empty == kSlots; j++) {
+                if (_buckets[target].entries[j].load(std::memory_order_relaxed) == nullptr) {
+                    empty = j;
+                }
+            }
+            if (empty == kSlots) {
+                continue;
+            }
+
+            // Moves go from the end of the chain, every one fills the slot the previous move has freed
+            for (int s = int(steps.size()) - 1; steps[s].parent >= 0; s = steps[s].parent) {
+                size_t source = steps[steps[s].parent].bucket;
+                Bucket &from = _buckets[source];
+                Bucket &to = _buckets[steps[s].bucket];
+                size_t slot = steps[s].slot;
+                Entry *entry = from.entries[slot].load(std::memory_order_relaxed);
+                uint8_t tag = from.tags[slot].load(std::memory_order_relaxed);
+                if (alternate(source, tag) != steps[s].bucket) {
+                    // Chain went through the same slot twice, moves made so far are valid anyway
+                    return false;
+                }
+
+                begin_write(entry->hash);
+                to.entries[empty].store(entry, std::memory_order_release);
+                to.tags[empty].store(tag, std::memory_order_relaxed);
+                to.referenced[empty].store(from.referenced[slot].load(std::memory_order_relaxed),
+                                           std::memory_order_relaxed);
+                from.tags[slot].store(0, std::memory_order_relaxed);
+                from.entries[slot].store(nullptr, std::memory_order_relaxed);
+                from.referenced[slot].store(0, std::memory_order_relaxed);
+                end_write(entry->hash);
+
+                _displacements++;
+                empty = slot;
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+void CuckooClock::insert(Entry *entry) {
+    const uint8_t tag = tag_of(entry->hash);
+    const size_t first = bucket_of(entry->hash);
+    const size_t second = alternate(first, tag);
+
+    for (;;) {
+        for (size_t b : {first, second}) {
+            Bucket &bucket = _buckets[b];
+            for (size_t i = 0; i < kSlots; i++) {
+                if (bucket.entries[i].load(std::memory_order_relaxed) != nullptr) {
+                    continue;
+                }
+                // Fresh key has no readers to confuse, so there is no need for the version change
+                bucket.entries[i].store(entry, std::memory_order_release);
+                bucket.tags[i].store(tag, std::memory_order_relaxed);
+                bucket.referenced[i].store(0, std::memory_order_relaxed);
+                _items++;
+                _current_size += size_t(entry->key_size) + entry->value_size;
+                return;
+            }
+        }
+
+        if (!displace(first, second)) {
+            // Table is too crowded around the key: the slot of the first bucket CLOCK would take goes
+            size_t victim = 0;
+            for (size_t i = 0; i < kSlots; i++) {
+                if (_buckets[first].referenced[i].load(std::memory_order_relaxed) == 0) {
+                    victim = i;
+                    break;
+                }
+            }
+            remove(first, victim);
+            _evictions++;
+        }
+    }
+}
+
+bool CuckooClock::store(uint64_t hash, const std::string &key, const std::string &value, uint32_t expire,
+                        uint32_t flags, Entry *current, size_t bucket, size_t slot) {
+    Entry *fresh = create(hash, key, value.data(), value.size(), expire, flags, current);
+    if (fresh == nullptr) {
+        return false;
+    }
+    if (current != nullptr) {
+        replace(bucket, slot, fresh);
+    } else {
+        insert(fresh);
+    }
+    return true;
+}
+
+// See CuckooClock.h
+void CuckooClock::Start() {
+    std::lock_guard<std::mutex> lock(_write_lock);
+    size_t n_threads = std::max(1u, std::thread::hardware_concurrency());
+    _prefault_ms = _memory.prefault(n_threads).count();
+}
+
+// See CuckooClock.h
+bool CuckooClock::Put(const std::string &key, const std::string &value) {
+    return CuckooClock::PutWithTTL(key, value, 0, 0);
+}
+
+// See CuckooClock.h
+bool CuckooClock::PutIfAbsent(const std::string &key, const std::string &value) {
+    return CuckooClock::PutIfAbsentWithTTL(key, value, 0, 0);
+}
+
+// See CuckooClock.h
+bool CuckooClock::Set(const std::string &key, const std::string &value) {
+    return CuckooClock::SetWithTTL(key, value, 0, 0);
+}
+
+// See CuckooClock.h
+bool CuckooClock::PutWithTTL(const std::string &key, const std::string &value, uint32_t ttl, uint32_t flags) {
+    std::lock_guard<std::mutex> lock(_write_lock);
+    uint32_t now = _clock();
+    uint64_t hash = hash_key(key);
+    size_t bucket, slot;
+    Entry *current = find(hash, key, now, bucket, slot);
+    return store(hash, key, value, expire_time(now, ttl), flags, current, bucket, slot);
+}
+
+// See CuckooClock.h
+bool CuckooClock::PutIfAbsentWithTTL(const std::string &key, const std::string &value, uint32_t ttl,
+                                     uint32_t flags) {
+    std::lock_guard<std::mutex> lock(_write_lock);
+    uint32_t now = _clock();
+    uint64_t hash = hash_key(key);
+    size_t bucket, slot;
+    if (find(hash, key, now, bucket, slot) != nullptr) {
+        return false;
+    }
+    return store(hash, key, value, expire_time(now, ttl), flags, nullptr, 0, 0);
+}
+
+// See CuckooClock.h
+bool CuckooClock::SetWithTTL(const std::string &key, const std::string &value, uint32_t ttl, uint32_t flags) {
+    std::lock_guard<std::mutex> lock(_write_lock);
+    uint32_t now = _clock();
+    uint64_t hash = hash_key(key);
+    size_t bucket, slot;
+    Entry *current = find(hash, key, now, bucket, slot);
+    if (current == nullptr) {
+        return false;
+    }
+    return store(hash, key, value, expire_time(now, ttl), flags, current, bucket, slot);
+}
+
+// See CuckooClock.h
+CasResult CuckooClock::CompareAndSwap(const std::string &key, const std::string &value, uint32_t ttl,
+                                      uint32_t flags, uint64_t cas) {
+    std::lock_guard<std::mutex> lock(_write_lock);
+    uint32_t now = _clock();
+    uint64_t hash = hash_key(key);
+    size_t bucket, slot;
+    Entry *current = find(hash, key, now, bucket, slot);
+    if (current == nullptr) {
+        return CasResult::NotFound;
+    }
+    if (current->cas != cas) {
+        return CasResult::Exists;
+    }
+    return store(hash, key, value, expire_time(now, ttl), flags, current, bucket, slot) ? CasResult::Stored
+                                                                                        : CasResult::NotStored;
+}
+
+// See CuckooClock.h
+bool CuckooClock::Delete(const std::string &key) {
+    std::lock_guard<std::mutex> lock(_write_lock);
+    size_t bucket, slot;
+    if (find(hash_key(key), key, _clock(), bucket, slot) == nullptr) {
+        return false;
+    }
+    remove(bucket, slot);
+    return true;
+}
+
+// See CuckooClock.h
+bool CuckooClock::Get(const std::string &key, std::string &value) {
+    // Optimistic copy could be thrown away, so output isn't touched until the read is consistent
+    static thread_local std::string copy;
+    if (!read(hash_key(key), key, _clock(), copy, nullptr)) {
+        return false;
+    }
+    value.assign(copy);
+    return true;
+}
+
+// See CuckooClock.h
+void CuckooClock::MultiGetWithInfo(const std::vector<std::string> &keys, std::vector<ValueView> &values,
+                                   std::vector<ValueInfo> &infos) {
+    uint32_t now = _clock();
+    values.clear();
+    values.resize(keys.size());
+    infos.assign(keys.size(), ValueInfo{0, 0, nullptr, 0});
+    for (size_t i = 0; i < keys.size(); i++) {
+        std::string value;
+        if (read(hash_key(keys[i]), keys[i], now, value, &infos[i])) {
+            values[i] = ValueView::Copy(std::move(value));
+        }
+    }
+}
+
+bool CuckooClock::concat(const std::string &key, const std::string &data, bool append) {
+    std::lock_guard<std::mutex> lock(_write_lock);
+    uint64_t hash = hash_key(key);
+    size_t bucket, slot;
+    Entry *current = find(hash, key, _clock(), bucket, slot);
+    if (current == nullptr) {
+        return false;
+    }
+    std::string value(current->value(), current->value_size);
+    value = append ? value + data : data + value;
+    return store(hash, key, value, current->expire, current->flags, current, bucket, slot);
+}
+
+// See CuckooClock.h
+bool CuckooClock::Append(const std::string &key, const std::string &data) { return concat(key, data, true); }
+
+// See CuckooClock.h
+bool CuckooClock::Prepend(const std::string &key, const std::string &data) { return concat(key, data, false); }
+
+DeltaResult CuckooClock::delta(const std::string &key, uint64_t delta, bool increment, uint64_t &result) {
+    std::lock_guard<std::mutex> lock(_write_lock);
+    uint64_t hash = hash_key(key);
+    size_t bucket, slot;
+    Entry *current = find(hash, key, _clock(), bucket, slot);
+    if (current == nullptr) {
+        return DeltaResult::NotFound;
+    }
+    uint64_t number;
+    if (!ParseCounter(current->value(), current->value_size, number)) {
+        return DeltaResult::NonNumeric;
+    }
+    if (increment) {
+        result = number + delta;
+    } else {
+        result = (number > delta) ? number - delta : 0;
+    }
+    return store(hash, key, std::to_string(result), current->expire, current->flags, current, bucket, slot)
+               ? DeltaResult::Stored
+               : DeltaResult::NotStored;
+}
+
+// See CuckooClock.h
+DeltaResult CuckooClock::Increment(const std::string &key, uint64_t delta, uint64_t &result) {
+    return this->delta(key, delta, true, result);
+}
+
+// See CuckooClock.h
+DeltaResult CuckooClock::Decrement(const std::string &key, uint64_t delta, uint64_t &result) {
+    return this->delta(key, delta, false, result);
+}
+
+// See CuckooClock.h
+void CuckooClock::Stats(std::map<std::string, std::string> &stats) {
+    std::lock_guard<std::mutex> lock(_write_lock);
+    stats["curr_items"] = std::to_string(_items);
+    stats["bytes"] = std::to_string(_current_size);
+    stats["limit_maxbytes"] = std::to_string(_max_size);
+    stats["evictions"] = std::to_string(_evictions);
+    stats["cuckoo_displacements"] = std::to_string(_displacements);
+    stats["hash_buckets"] = std::to_string(_buckets.size());
+    stats["slab_pages"] = std::to_string(_slab.pages());
+    stats["slab_free_pages"] = std::to_string(_slab.free_pages());
+
+    static const char *pages[] = {"none", "transparent", "explicit"};
+    stats["huge_pages"] = pages[int(_memory.huge_pages())];
+    if (_prefault_ms >= 0) {
+        stats["prefault_ms"] = std::to_string(_prefault_ms);
+    }
+}
+
+} // namespace Backend
+} // namespace Afina
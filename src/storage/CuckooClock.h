@@ -0,0 +1,198 @@
+#ifndef AFINA_STORAGE_CUCKOO_CLOCK_H
+#define AFINA_STORAGE_CUCKOO_CLOCK_H
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <afina/Storage.h>
+#include <afina/allocator/Region.h>
+#include <afina/allocator/Slab.h>
+
+#include "TimingWheel.h"
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # Optimistic cuckoo hash with CLOCK eviction
+ * Storage for read mostly workloads in the spirit of MemC3: readers take no lock at all and never write
+ * shared memory except a reference bit.
+ *
+ * Index is a cuckoo hash table of 4-way buckets, every key could live in one of two buckets. Slot keeps
+ * one byte tag of the key hash next to the item pointer, so lookup only dereferences items whose tag
+ * matches. The second bucket is computed from the first one and the tag (partial key cuckoo hashing),
+ * so item could be moved to its other bucket without reading the key. When both buckets are full,
+ * insert looks for the shortest chain of such moves ending in an empty slot.
+ *
+ * Keys are hash partitioned across version counters. Writer makes counter of the key odd while the key
+ * is moved, replaced or removed, and even again once it is done. Reader copies value optimistically and
+ * retries if counter was odd or changed meanwhile. Item memory comes from Allocator::Slab carving a
+ * single region that lives as long as storage, so reader racing with a writer could read stale bytes but
+ * never unmapped memory, and version check throws such reads away.
+ *
+ * Writes are serialized by a single mutex. Once the slab class of a new item has no room, CLOCK hand
+ * sweeps table slots: referenced slots get second chance, the first unreferenced item of the class is
+ * evicted. Class having no items at all takes items of any class until a page is free.
+ *
+ * Expired items are only skipped by readers and removed by writers. Views are copies of values.
+ */
+class CuckooClock : public Afina::Storage {
+public:
+    /**
+     * @param max_size number of bytes in the region, at least one slab page is taken
+     * @param factor ratio of chunk sizes of the adjacent slab classes
+     * @param huge_pages pages to back the region by, see Allocator::Region
+     */
+    CuckooClock(size_t max_size = 64 << 20, double factor = 1.25, Clock clock = steady_seconds,
+                Allocator::HugePages huge_pages = Allocator::HugePages::None);
+    ~CuckooClock() {}
+
+    // Prefaults the region in parallel, must be called before the cache is used
+    void Start() override;
+
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Delete(const std::string &key) override;
+
+    // Implements Afina::Storage interface, takes no lock
+    bool Get(const std::string &key, std::string &value) override;
+
+    // Implements Afina::Storage interface, takes no lock
+    void MultiGetWithInfo(const std::vector<std::string> &keys, std::vector<ValueView> &values,
+                          std::vector<ValueInfo> &infos) override;
+
+    // Implements Afina::Storage interface
+    bool PutWithTTL(const std::string &key, const std::string &value, uint32_t ttl, uint32_t flags) override;
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsentWithTTL(const std::string &key, const std::string &value, uint32_t ttl, uint32_t flags) override;
+
+    // Implements Afina::Storage interface
+    bool SetWithTTL(const std::string &key, const std::string &value, uint32_t ttl, uint32_t flags) override;
+
+    // Implements Afina::Storage interface
+    CasResult CompareAndSwap(const std::string &key, const std::string &value, uint32_t ttl, uint32_t flags,
+                             uint64_t cas) override;
+
+    // Implements Afina::Storage interface
+    bool Append(const std::string &key, const std::string &data) override;
+
+    // Implements Afina::Storage interface
+    bool Prepend(const std::string &key, const std::string &data) override;
+
+    // Implements Afina::Storage interface
+    DeltaResult Increment(const std::string &key, uint64_t delta, uint64_t &result) override;
+
+    // Implements Afina::Storage interface
+    DeltaResult Decrement(const std::string &key, uint64_t delta, uint64_t &result) override;
+
+    // Implements Afina::Storage interface, adds table and slab usage, evictions and cuckoo moves
+    void Stats(std::map<std::string, std::string> &stats) override;
+
+private:
+    struct Entry;
+
+    // Number of slots in every bucket
+    static constexpr size_t kSlots = 4;
+
+    struct Bucket {
+        // Tag of the key hash, 0 for an empty slot
+        std::atomic<uint8_t> tags[kSlots];
+        // CLOCK reference bits, set by readers
+        std::atomic<uint8_t> referenced[kSlots];
+        std::atomic<Entry *> entries[kSlots];
+    };
+
+    // Region all items live in and allocator carving it
+    const std::size_t _max_size;
+    Allocator::Region _memory;
+    Allocator::Slab _slab;
+
+    // Cuckoo table, number of buckets is a power of 2 and never changes
+    std::vector<Bucket> _buckets;
+
+    // Version counters of the key stripes, odd while key is being changed
+    std::vector<std::atomic<uint32_t>> _versions;
+
+    Clock _clock;
+
+    // Serializes writers, fields below are only touched with it held
+    std::mutex _write_lock;
+
+    // CLOCK hand: index of the next slot to examine
+    std::size_t _hand;
+
+    // Number of items, total number of bytes in their keys and values
+    std::size_t _items;
+    std::size_t _current_size;
+
+    // Items evicted for others, items moved to their other bucket
+    uint64_t _evictions;
+    uint64_t _displacements;
+
+    // Time the last Start spent on prefaulting the region, -1 if it was never called
+    int64_t _prefault_ms;
+
+    // Key hash helpers
+    static uint8_t tag_of(uint64_t hash);
+    size_t bucket_of(uint64_t hash) const;
+    size_t alternate(size_t bucket, uint8_t tag) const;
+    std::atomic<uint32_t> &version_of(uint64_t hash);
+
+    // Marks key as being changed and back
+    void begin_write(uint64_t hash);
+    void end_write(uint64_t hash);
+
+    // Copies value and metadata of the item that isn't expired at the given time, takes no lock. Returns
+    // false if there is no such item
+    bool read(uint64_t hash, const std::string &key, uint32_t now, std::string &value, ValueInfo *info);
+
+    // Looks up item that isn't expired at the given time, expired one is deleted on the way. Slot of the
+    // item goes to bucket and slot. Write lock must be held
+    Entry *find(uint64_t hash, const std::string &key, uint32_t now, size_t &bucket, size_t &slot);
+
+    // Builds new item, evicts items while its class has no room, item keep is never evicted. Returns
+    // nullptr if item doesn't fit into any class or there is nothing left to evict
+    Entry *create(uint64_t hash, const std::string &key, const char *value, size_t value_size, uint32_t expire,
+                  uint32_t flags, const Entry *keep);
+    // Slab class of the item
+    size_t class_of(const Entry *entry) const;
+    // Evicts every item of the page CLOCK picks, except the page of item keep, so that the page goes back to
+    // the pool. Returns false if there is nothing to evict
+    bool free_page(const Entry *keep);
+
+    // Places new item into the table, moves other items out of the way or evicts one if needed
+    void insert(Entry *entry);
+    // Looks for the chain of moves freeing a slot in one of the given buckets and performs it. Returns
+    // false if there is no chain short enough
+    bool displace(size_t first, size_t second);
+    // Puts fresh item into the slot of the current one, frees the current one
+    void replace(size_t bucket, size_t slot, Entry *fresh);
+    // Empties the slot and frees its item
+    void remove(size_t bucket, size_t slot);
+
+    // Writes value for the key, existing item with its slot is given if there is one
+    bool store(uint64_t hash, const std::string &key, const std::string &value, uint32_t expire, uint32_t flags,
+               Entry *current, size_t bucket, size_t slot);
+    // Adds data to the value of the existing key
+    bool concat(const std::string &key, const std::string &data, bool append);
+    // Updates counter of the existing key
+    DeltaResult delta(const std::string &key, uint64_t delta, bool increment, uint64_t &result);
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_CUCKOO_CLOCK_H
@@ -0,0 +1,250 @@
+#include "EvictionPolicy.h"
+
+#include <algorithm>
+
+namespace Afina {
+namespace Backend {
+
+// See EvictionPolicy.h
+void SLRUPolicy::Insert(Item *item) {
+    item->policy_data = kProbation;
+    _probation.push_back(item);
+}
+
+// See EvictionPolicy.h
+void SLRUPolicy::Touch(Item *item) {
+    if (item->policy_data == kProtected) {
+        _protected.move_back(item);
+        return;
+    }
+
+    _probation.remove(item);
+    item->policy_data = kProtected;
+    _protected.push_back(item);
+    while (_protected.bytes() > _protected_max && _protected.front() != item) {
+        Item *demoted = _protected.front();
+        _protected.remove(demoted);
+        demoted->policy_data = kProbation;
+        _probation.push_back(demoted);
+    }
+}
+
+// See EvictionPolicy.h
+void SLRUPolicy::Replace(Item *old, Item *fresh) {
+    fresh->policy_data = old->policy_data;
+    segment(old).replace(old, fresh);
+}
+
+// See EvictionPolicy.h
+void SLRUPolicy::Remove(Item *item) { segment(item).remove(item); }
+
+// See EvictionPolicy.h
+void SLRUPolicy::Stats(std::map<std::string, std::string> &stats) const {
+    stats["slru_probation_bytes"] = std::to_string(_probation.bytes());
+    stats["slru_protected_bytes"] = std::to_string(_protected.bytes());
+}
+
+// See EvictionPolicy.h
+Item *SLRUPolicy::Victim(const Item *keep) const {
+    Item *victim = _probation.empty() ? nullptr : _probation.first_except(keep);
+    if (victim == nullptr && !_protected.empty()) {
+        victim = _protected.first_except(keep);
+    }
+    return victim;
+}
+
+// See EvictionPolicy.h
+void ARCPolicy::GhostList::push_back(uint64_t hash, size_t size) {
+    take(hash);
+    _entries.emplace_back(hash, size);
+    _index[hash] = std::prev(_entries.end());
+    _bytes += size;
+}
+
+// See EvictionPolicy.h
+void ARCPolicy::GhostList::pop_front() {
+    _bytes -= _entries.front().second;
+    _index.erase(_entries.front().first);
+    _entries.pop_front();
+}
+
+// See EvictionPolicy.h
+size_t ARCPolicy::GhostList::take(uint64_t hash) {
+    auto it = _index.find(hash);
+    if (it == _index.end()) {
+        return 0;
+    }
+    size_t size = it->second->second;
+    _bytes -= size;
+    _entries.erase(it->second);
+    _index.erase(it);
+    return size;
+}
+
+// See EvictionPolicy.h
+void ARCPolicy::Admit(uint64_t hash) {
+    _pending = hash;
+    _pending_t2 = false;
+
+    // Hit in B1: recency side was too small, grow T1 target
+    size_t size = _b1.take(hash);
+    if (size > 0) {
+        size_t ratio = std::max<size_t>(1, _b2.count() / std::max<size_t>(1, _b1.count() + 1));
+        _p = std::min(_max_size, _p + size * ratio);
+        _pending_t2 = true;
+        return;
+    }
+
+    // Hit in B2: frequency side was too small, shrink T1 target
+    size = _b2.take(hash);
+    if (size > 0) {
+        size_t ratio = std::max<size_t>(1, _b1.count() / std::max<size_t>(1, _b2.count() + 1));
+        _p = _p - std::min(_p, size * ratio);
+        _pending_t2 = true;
+    }
+}
+
+// See EvictionPolicy.h
+void ARCPolicy::Insert(Item *item) {
+    if (_pending_t2 && _pending == item->hash) {
+        item->policy_data = kT2;
+        _t2.push_back(item);
+    } else {
+        item->policy_data = kT1;
+        _t1.push_back(item);
+    }
+    _pending_t2 = false;
+    trim_ghosts();
+}
+
+// See EvictionPolicy.h
+void ARCPolicy::Touch(Item *item) {
+    if (item->policy_data == kT2) {
+        _t2.move_back(item);
+        return;
+    }
+    _t1.remove(item);
+    item->policy_data = kT2;
+    _t2.push_back(item);
+}
+
+// See EvictionPolicy.h
+void ARCPolicy::Replace(Item *old, Item *fresh) {
+    fresh->policy_data = old->policy_data;
+    list(old).replace(old, fresh);
+}
+
+// See EvictionPolicy.h
+void ARCPolicy::Remove(Item *item) { list(item).remove(item); }
+
+// See EvictionPolicy.h
+void ARCPolicy::Stats(std::map<std::string, std::string> &stats) const {
+    stats["arc_t1_bytes"] = std::to_string(_t1.bytes());
+    stats["arc_t2_bytes"] = std::to_string(_t2.bytes());
+    stats["arc_b1_bytes"] = std::to_string(_b1.bytes());
+    stats["arc_b2_bytes"] = std::to_string(_b2.bytes());
+    stats["arc_target_t1_bytes"] = std::to_string(_p);
+}
+
+// See EvictionPolicy.h
+Item *ARCPolicy::Victim(const Item *keep) const {
+    Item *from_t1 = _t1.empty() ? nullptr : _t1.first_except(keep);
+    Item *from_t2 = _t2.empty() ? nullptr : _t2.first_except(keep);
+    if (from_t1 != nullptr && (_t1.bytes() > _p || from_t2 == nullptr)) {
+        return from_t1;
+    }
+    return (from_t2 != nullptr) ? from_t2 : from_t1;
+}
+
+// See EvictionPolicy.h
+void ARCPolicy::Evict(Item *item) {
+    if (item->policy_data == kT2) {
+        _t2.remove(item);
+        _b2.push_back(item->hash, item->size());
+    } else {
+        _t1.remove(item);
+        _b1.push_back(item->hash, item->size());
+    }
+    trim_ghosts();
+}
+
+// See EvictionPolicy.h
+void ARCPolicy::trim_ghosts() {
+    while (_b1.count() > 0 && _t1.bytes() + _b1.bytes() > _max_size) {
+        _b1.pop_front();
+    }
+    while (_b2.count() > 0 && _t1.bytes() + _t2.bytes() + _b1.bytes() + _b2.bytes() > 2 * _max_size) {
+        _b2.pop_front();
+    }
+}
+
+// See EvictionPolicy.h
+void LFUPolicy::Insert(Item *item) {
+    item->policy_data = 1;
+    _buckets[1].push_back(item);
+    _items++;
+}
+
+// See EvictionPolicy.h
+void LFUPolicy::Touch(Item *item) {
+    auto it = _buckets.find(item->policy_data);
+    it->second.remove(item);
+    if (it->second.empty()) {
+        _buckets.erase(it);
+    }
+    if (item->policy_data < UINT32_MAX) {
+        item->policy_data++;
+    }
+    _buckets[item->policy_data].push_back(item);
+
+    if (++_hits >= 8 * _items) {
+        decay();
+    }
+}
+
+// See EvictionPolicy.h
+void LFUPolicy::Replace(Item *old, Item *fresh) {
+    fresh->policy_data = old->policy_data;
+    _buckets[old->policy_data].replace(old, fresh);
+}
+
+// See EvictionPolicy.h
+void LFUPolicy::Remove(Item *item) {
+    auto it = _buckets.find(item->policy_data);
+    it->second.remove(item);
+    if (it->second.empty()) {
+        _buckets.erase(it);
+    }
+    _items--;
+}
+
+// See EvictionPolicy.h
+Item *LFUPolicy::Victim(const Item *keep) const {
+    for (auto &bucket : _buckets) {
+        Item *victim = bucket.second.first_except(keep);
+        if (victim != nullptr) {
+            return victim;
+        }
+    }
+    return nullptr;
+}
+
+// See EvictionPolicy.h
+void LFUPolicy::decay() {
+    std::map<uint32_t, ItemList> buckets;
+    for (auto &bucket : _buckets) {
+        uint32_t count = std::max<uint32_t>(1, bucket.first / 2);
+        ItemList &target = buckets[count];
+        for (Item *item = bucket.second.front(); item != nullptr;) {
+            Item *next = item->next;
+            item->policy_data = count;
+            target.push_back(item);
+            item = next;
+        }
+    }
+    _buckets.swap(buckets);
+    _hits = 0;
+}
+
+} // namespace Backend
+} // namespace Afina
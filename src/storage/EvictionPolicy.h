@@ -0,0 +1,261 @@
+#ifndef AFINA_STORAGE_EVICTION_POLICY_H
+#define AFINA_STORAGE_EVICTION_POLICY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "Item.h"
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # Eviction policies
+ * Storage engine (see SimpleLRU.h) is templated on the policy, which decides in what order resident
+ * items leave the cache. Policy doesn't own items, it only orders them through intrusive Item links
+ * and Item::policy_data. Every policy implements the same set of methods:
+ *
+ * - Policy(size_t max_size): max_size is the byte budget of the cache
+ * - void Admit(uint64_t hash): new key is about to be inserted, called before any eviction for it
+ * - void Insert(Item *item): item became resident
+ * - void Touch(Item *item): resident item was accessed
+ * - void Replace(Item *old, Item *fresh): item moved into new memory block, policy state is kept
+ * - void Resize(Item *item, size_t old_size): value of resident item changed its size in place
+ * - void Remove(Item *item): item leaves cache explicitly (deleted, not evicted)
+ * - Item *Victim(const Item *keep): next item to evict, never returns keep, nullptr if there is none
+ * - void Evict(Item *item): item returned by Victim leaves cache
+ * - void Stats(std::map<std::string, std::string> &stats): adds sizes of policy lists
+ */
+
+/**
+ * Intrusive list of items over Item::prev/next, tracks total payload bytes of its items
+ */
+class ItemList {
+public:
+    ItemList() : _head(nullptr), _tail(nullptr), _bytes(0) {}
+
+    Item *front() const { return _head; }
+    bool empty() const { return _head == nullptr; }
+    size_t bytes() const { return _bytes; }
+
+    void push_back(Item *item) {
+        item->next = nullptr;
+        item->prev = _tail;
+        if (_tail != nullptr) {
+            _tail->next = item;
+        } else {
+            _head = item;
+        }
+        _tail = item;
+        _bytes += item->size();
+    }
+
+    void remove(Item *item) {
+        if (item->prev != nullptr) {
+            item->prev->next = item->next;
+        } else {
+            _head = item->next;
+        }
+        if (item->next != nullptr) {
+            item->next->prev = item->prev;
+        } else {
+            _tail = item->prev;
+        }
+        _bytes -= item->size();
+    }
+
+    void move_back(Item *item) {
+        if (item != _tail) {
+            remove(item);
+            push_back(item);
+        }
+    }
+
+    // Fresh item takes exactly the same position as old one
+    void replace(Item *old, Item *fresh) {
+        fresh->prev = old->prev;
+        fresh->next = old->next;
+        if (old->prev != nullptr) {
+            old->prev->next = fresh;
+        } else {
+            _head = fresh;
+        }
+        if (old->next != nullptr) {
+            old->next->prev = fresh;
+        } else {
+            _tail = fresh;
+        }
+        _bytes = _bytes - old->size() + fresh->size();
+    }
+
+    // Item already in the list changed its size from old_size
+    void resize(const Item *item, size_t old_size) { _bytes = _bytes - old_size + item->size(); }
+
+    // First item from the head that is not keep
+    Item *first_except(const Item *keep) const { return (_head != keep) ? _head : _head->next; }
+
+private:
+    Item *_head;
+    Item *_tail;
+    size_t _bytes;
+};
+
+/**
+ * # Least recently used
+ * Single list, hit moves item to the tail, victim is the head
+ */
+class LRUPolicy {
+public:
+    LRUPolicy(size_t max_size) {}
+
+    void Admit(uint64_t hash) {}
+    void Insert(Item *item) { _list.push_back(item); }
+    void Touch(Item *item) { _list.move_back(item); }
+    void Replace(Item *old, Item *fresh) { _list.replace(old, fresh); }
+    void Resize(Item *item, size_t old_size) { _list.resize(item, old_size); }
+    void Remove(Item *item) { _list.remove(item); }
+    Item *Victim(const Item *keep) const { return _list.empty() ? nullptr : _list.first_except(keep); }
+    void Evict(Item *item) { _list.remove(item); }
+    void Stats(std::map<std::string, std::string> &stats) const {}
+
+private:
+    ItemList _list;
+};
+
+/**
+ * # Segmented LRU
+ * New items go into probation segment, second hit promotes item into protected one. Protected segment
+ * is limited to 80% of the cache, overflow is demoted back to probation tail. Victims are taken from
+ * probation first, so a scan of one-time keys never flushes items that were hit at least twice.
+ */
+class SLRUPolicy {
+public:
+    SLRUPolicy(size_t max_size) : _protected_max(max_size / 5 * 4) {}
+
+    void Admit(uint64_t hash) {}
+    void Insert(Item *item);
+    void Touch(Item *item);
+    void Replace(Item *old, Item *fresh);
+    void Resize(Item *item, size_t old_size) { segment(item).resize(item, old_size); }
+    void Remove(Item *item);
+    Item *Victim(const Item *keep) const;
+    void Evict(Item *item) { Remove(item); }
+    void Stats(std::map<std::string, std::string> &stats) const;
+
+private:
+    enum Segment : uint32_t { kProbation, kProtected };
+
+    ItemList &segment(const Item *item) { return item->policy_data == kProtected ? _protected : _probation; }
+
+    const size_t _protected_max;
+    ItemList _probation;
+    ItemList _protected;
+};
+
+/**
+ * # Adaptive replacement cache
+ * Resident items are split between T1 (seen once recently) and T2 (seen at least twice). Ghost lists
+ * B1 and B2 remember keys recently evicted from T1 and T2 respectively. Target size of T1 adapts: hit
+ * in B1 means T1 is too small, hit in B2 means T2 is too small. All sizes are measured in bytes.
+ */
+class ARCPolicy {
+public:
+    ARCPolicy(size_t max_size) : _max_size(max_size), _p(0), _pending(0), _pending_t2(false) {}
+
+    void Admit(uint64_t hash);
+    void Insert(Item *item);
+    void Touch(Item *item);
+    void Replace(Item *old, Item *fresh);
+    void Resize(Item *item, size_t old_size) { list(item).resize(item, old_size); }
+    void Remove(Item *item);
+    Item *Victim(const Item *keep) const;
+    void Evict(Item *item);
+    void Stats(std::map<std::string, std::string> &stats) const;
+
+private:
+    enum List : uint32_t { kT1, kT2 };
+
+    /**
+     * LRU list of evicted keys: only hash and size of the item are remembered
+     */
+    class GhostList {
+    public:
+        GhostList() : _bytes(0) {}
+
+        size_t bytes() const { return _bytes; }
+        size_t count() const { return _entries.size(); }
+
+        void push_back(uint64_t hash, size_t size);
+        void pop_front();
+        // Removes entry if it exists, returns its size or 0 if not found
+        size_t take(uint64_t hash);
+
+    private:
+        std::list<std::pair<uint64_t, size_t>> _entries;
+        std::unordered_map<uint64_t, std::list<std::pair<uint64_t, size_t>>::iterator> _index;
+        size_t _bytes;
+    };
+
+    ItemList &list(const Item *item) { return item->policy_data == kT2 ? _t2 : _t1; }
+
+    // Drops ghost entries so that directory doesn't grow over 2 * max_size
+    void trim_ghosts();
+
+    const size_t _max_size;
+
+    // Target size of T1 in bytes
+    size_t _p;
+
+    ItemList _t1;
+    ItemList _t2;
+    GhostList _b1;
+    GhostList _b2;
+
+    // Result of the last Admit: key that was found in ghost lists and so goes directly into T2
+    uint64_t _pending;
+    bool _pending_t2;
+};
+
+/**
+ * # Least frequently used with aging
+ * Items are grouped into buckets by access count, victim is the least recently used item of the
+ * lowest bucket. Counts are halved once number of hits reaches 8x number of resident items, so that
+ * items popular long time ago lose their advantage and cache follows workload changes.
+ */
+class LFUPolicy {
+public:
+    LFUPolicy(size_t max_size) : _items(0), _hits(0) {}
+
+    void Admit(uint64_t hash) {}
+    void Insert(Item *item);
+    void Touch(Item *item);
+    void Replace(Item *old, Item *fresh);
+    void Resize(Item *item, size_t old_size) { _buckets[item->policy_data].resize(item, old_size); }
+    void Remove(Item *item);
+    Item *Victim(const Item *keep) const;
+    void Evict(Item *item) { Remove(item); }
+    void Stats(std::map<std::string, std::string> &stats) const {}
+
+private:
+    // Halves all counts
+    void decay();
+
+    // Frequency -> items having it, in LRU order
+    std::map<uint32_t, ItemList> _buckets;
+
+    // Number of resident items
+    size_t _items;
+
+    // Hits since last decay
+    size_t _hits;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_EVICTION_POLICY_H
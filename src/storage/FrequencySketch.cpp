@@ -0,0 +1,89 @@
+#include "FrequencySketch.h"
+
+#include <algorithm>
+
+namespace Afina {
+namespace Backend {
+
+constexpr size_t FrequencySketch::kBlockWords;
+constexpr uint32_t FrequencySketch::kMaxCount;
+
+// See FrequencySketch.h
+FrequencySketch::FrequencySketch(size_t expected_items) : _additions(0) {
+    // One word, i.e. 16 counters, per expected key, but at least one block
+    size_t words = kBlockWords;
+    while (words < expected_items) {
+        words *= 2;
+    }
+    _block_mask = words / kBlockWords - 1;
+    _sample_size = 10 * std::max<size_t>(expected_items, 1);
+
+    std::vector<std::atomic<uint64_t>>(words + kBlockWords).swap(_storage);
+    uintptr_t base = reinterpret_cast<uintptr_t>(_storage.data());
+    uintptr_t aligned = (base + kBlockWords * sizeof(uint64_t) - 1) & ~(kBlockWords * sizeof(uint64_t) - 1);
+    _table = reinterpret_cast<std::atomic<uint64_t> *>(aligned);
+}
+
+// See FrequencySketch.h
+void FrequencySketch::locate(uint64_t hash, int i, size_t &word, int &shift) const {
+    // Index hash could be correlated with whatever uses low bits of it, so remix first. High half
+    // selects the block, every byte of the low half selects word and counter for one row
+    uint64_t h = hash * 0x9E3779B97F4A7C15ull;
+    size_t block = static_cast<size_t>(h >> 32) & _block_mask;
+    uint32_t bits = static_cast<uint32_t>(h >> (8 * i));
+    word = block * kBlockWords + 2 * i + (bits & 1);
+    shift = static_cast<int>((bits >> 1) & 15) * 4;
+}
+
+// See FrequencySketch.h
+void FrequencySketch::Increment(uint64_t hash) {
+    bool added = false;
+    for (int i = 0; i < 4; i++) {
+        size_t word;
+        int shift;
+        locate(hash, i, word, shift);
+        uint64_t current = _table[word].load(std::memory_order_relaxed);
+        while (((current >> shift) & kMaxCount) < kMaxCount) {
+            if (_table[word].compare_exchange_weak(current, current + (uint64_t(1) << shift),
+                                                   std::memory_order_relaxed)) {
+                added = true;
+                break;
+            }
+        }
+    }
+
+    // Reset only moves the number down, so exactly one increment hits the threshold
+    if (added && _additions.fetch_add(1, std::memory_order_relaxed) + 1 == _sample_size) {
+        Reset();
+    }
+}
+
+// See FrequencySketch.h
+uint32_t FrequencySketch::Frequency(uint64_t hash) const {
+    uint32_t frequency = kMaxCount;
+    for (int i = 0; i < 4; i++) {
+        size_t word;
+        int shift;
+        locate(hash, i, word, shift);
+        uint64_t current = _table[word].load(std::memory_order_relaxed);
+        frequency = std::min(frequency, static_cast<uint32_t>((current >> shift) & kMaxCount));
+    }
+    return frequency;
+}
+
+// See FrequencySketch.h
+void FrequencySketch::Reset() {
+    size_t words = (_block_mask + 1) * kBlockWords;
+    for (size_t i = 0; i < words; i++) {
+        uint64_t current = _table[i].load(std::memory_order_relaxed);
+        while (!_table[i].compare_exchange_weak(current, (current >> 1) & 0x7777777777777777ull,
+                                                std::memory_order_relaxed)) {
+        }
+    }
+    size_t additions = _additions.load(std::memory_order_relaxed);
+    while (!_additions.compare_exchange_weak(additions, additions / 2, std::memory_order_relaxed)) {
+    }
+}
+
+} // namespace Backend
+} // namespace Afina
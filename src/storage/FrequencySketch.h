@@ -0,0 +1,60 @@
+#ifndef AFINA_STORAGE_FREQUENCY_SKETCH_H
+#define AFINA_STORAGE_FREQUENCY_SKETCH_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # Count-min sketch of access frequencies
+ * Approximate popularity of keys in constant memory: four 4-bit counters per key, estimate is the
+ * minimum of them. All counters of a key live in a single 64 byte block, so increment and estimate
+ * touch one cache line only.
+ *
+ * Once number of increments reaches 10x expected number of keys, all counters are halved. That keeps
+ * estimates fresh: keys popular long time ago slowly lose their weight.
+ *
+ * Every method is lock free and could be called concurrently: counters are updated by CAS on their
+ * words, increment racing with reset could be lost, which estimates tolerate anyway.
+ */
+class FrequencySketch {
+public:
+    /**
+     * @param expected_items number of distinct keys sketch is sized for
+     */
+    FrequencySketch(size_t expected_items);
+
+    // Counts one more access to the key with the given hash
+    void Increment(uint64_t hash);
+
+    // Estimated number of accesses to the key with the given hash, at most 15
+    uint32_t Frequency(uint64_t hash) const;
+
+    // Halves all counters
+    void Reset();
+
+private:
+    static constexpr size_t kBlockWords = 8;
+    static constexpr uint32_t kMaxCount = 15;
+
+    // Position of the i-th counter of the key: word in the table and shift inside that word
+    void locate(uint64_t hash, int i, size_t &word, int &shift) const;
+
+    // Storage for the table, over-allocated by one block to align table to cache line
+    std::vector<std::atomic<uint64_t>> _storage;
+    std::atomic<uint64_t> *_table;
+    size_t _block_mask;
+
+    // Increments since last reset and the number that triggers it
+    std::atomic<size_t> _additions;
+    size_t _sample_size;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_FREQUENCY_SKETCH_H
@@ -0,0 +1,231 @@
+#ifndef AFINA_STORAGE_HASH_INDEX_H
+#define AFINA_STORAGE_HASH_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * Hash function used by all storage indexes, MurmurHash64A
+ */
+inline uint64_t hash_key(const char *key, size_t size) {
+    const uint64_t m = 0xc6a4a7935bd1e995ull;
+    const int r = 47;
+    uint64_t h = 0xc70f6907ull ^ (size * m);
+
+    const char *end = key + (size & ~size_t(7));
+    for (; key != end; key += 8) {
+        uint64_t k;
+        std::memcpy(&k, key, sizeof(k));
+        k *= m;
+        k ^= k >> r;
+        k *= m;
+        h ^= k;
+        h *= m;
+    }
+
+    switch (size & 7) {
+    case 7:
+        h ^= uint64_t(uint8_t(key[6])) << 48;
+    case 6:
+        h ^= uint64_t(uint8_t(key[5])) << 40;
+    case 5:
+        h ^= uint64_t(uint8_t(key[4])) << 32;
+    case 4:
+        h ^= uint64_t(uint8_t(key[3])) << 24;
+    case 3:
+        h ^= uint64_t(uint8_t(key[2])) << 16;
+    case 2:
+        h ^= uint64_t(uint8_t(key[1])) << 8;
+    case 1:
+        h ^= uint64_t(uint8_t(key[0]));
+        h *= m;
+    }
+
+    h ^= h >> r;
+    h *= m;
+    h ^= h >> r;
+    return h;
+}
+
+inline uint64_t hash_key(const std::string &key) { return hash_key(key.data(), key.size()); }
+
+/**
+ * # Open addressing hash index
+ * Maps keys to externally owned nodes. Each slot stores full hash of the key right next to the node
+ * pointer, so probe sequence compares hashes first and touches key bytes of a node only in case of
+ * hash match, which is almost always the node we are looking for.
+ *
+ * Table uses linear probing with backward shift deletion, so there are no tombstones and probe
+ * sequences stay short under any mix of inserts and deletes. Capacity is always power of two and
+ * table grows twice once load factor exceeds 3/4.
+ *
+ * Index doesn't own nodes. Traits must provide static method to compare node key with the given one:
+ * - bool Traits::equals(const Node *node, const char *key, size_t size)
+ */
+template <typename Node, typename Traits> class HashIndex {
+public:
+    HashIndex(size_t capacity = 16) : _size(0) { resize(round_up(capacity)); }
+
+    /**
+     * Returns node associated with the given key or nullptr if there is no such key in the index
+     */
+    Node *find(uint64_t hash, const char *key, size_t size) const {
+        for (size_t pos = hash & _mask;; pos = (pos + 1) & _mask) {
+            const Slot &slot = _slots[pos];
+            if (slot.node == nullptr) {
+                return nullptr;
+            }
+            if (slot.hash == hash && Traits::equals(slot.node, key, size)) {
+                return slot.node;
+            }
+        }
+    }
+
+    Node *find(uint64_t hash, const std::string &key) const { return find(hash, key.data(), key.size()); }
+
+    /**
+     * Adds new node in the index. Caller must guarantee there is no node with the same key yet
+     */
+    void insert(uint64_t hash, Node *node) {
+        if ((_size + 1) * 4 > _slots.size() * 3) {
+            resize(_slots.size() * 2);
+        }
+        place(hash, node);
+        _size++;
+    }
+
+    /**
+     * Replaces node for the key, returns false if the given node is not in the index
+     */
+    bool replace(uint64_t hash, const Node *old_node, Node *new_node) {
+        size_t pos = lookup(hash, old_node);
+        if (pos == npos) {
+            return false;
+        }
+        _slots[pos].node = new_node;
+        return true;
+    }
+
+    /**
+     * Removes exactly given node from the index. Returns false if the node is not there
+     */
+    bool erase(uint64_t hash, const Node *node) {
+        size_t pos = lookup(hash, node);
+        if (pos == npos) {
+            return false;
+        }
+
+        // Backward shift: move following entries of the cluster to fill the hole, if they
+        // are not at their home position already
+        size_t hole = pos;
+        for (size_t next = (hole + 1) & _mask; _slots[next].node != nullptr; next = (next + 1) & _mask) {
+            size_t home = _slots[next].hash & _mask;
+            if (((next - home) & _mask) >= ((next - hole) & _mask)) {
+                _slots[hole] = _slots[next];
+                hole = next;
+            }
+        }
+        _slots[hole].node = nullptr;
+        _size--;
+        return true;
+    }
+
+    /**
+     * Prefetch first slot of probe sequence for the given hash into cache
+     */
+    void prefetch(uint64_t hash) const { __builtin_prefetch(&_slots[hash & _mask]); }
+
+    /**
+     * Prefetch node sitting at the home slot of the given hash, if hashes match. Reads the slot, so
+     * it should be issued some time after prefetch(hash) for the same hash
+     */
+    void prefetch_node(uint64_t hash) const {
+        const Slot &slot = _slots[hash & _mask];
+        if (slot.node != nullptr && slot.hash == hash) {
+            __builtin_prefetch(slot.node);
+        }
+    }
+
+    /**
+     * Drops all entries, nodes remain untouched
+     */
+    void clear() {
+        std::vector<Slot>(_slots.size()).swap(_slots);
+        _size = 0;
+    }
+
+    size_t size() const { return _size; }
+
+    /**
+     * Number of bytes used by index itself
+     */
+    size_t memory_usage() const { return _slots.size() * sizeof(Slot); }
+
+private:
+    struct Slot {
+        uint64_t hash;
+        Node *node;
+    };
+
+    static const size_t npos = ~size_t(0);
+
+    static size_t round_up(size_t n) {
+        size_t result = 16;
+        while (result < n) {
+            result *= 2;
+        }
+        return result;
+    }
+
+    size_t lookup(uint64_t hash, const Node *node) const {
+        for (size_t pos = hash & _mask;; pos = (pos + 1) & _mask) {
+            const Slot &slot = _slots[pos];
+            if (slot.node == nullptr) {
+                return npos;
+            }
+            if (slot.node == node) {
+                return pos;
+            }
+        }
+    }
+
+    void place(uint64_t hash, Node *node) {
+        size_t pos = hash & _mask;
+        while (_slots[pos].node != nullptr) {
+            pos = (pos + 1) & _mask;
+        }
+        _slots[pos].hash = hash;
+        _slots[pos].node = node;
+    }
+
+    void resize(size_t capacity) {
+        std::vector<Slot> old(capacity);
+        old.swap(_slots);
+        _mask = capacity - 1;
+        for (auto &slot : old) {
+            if (slot.node != nullptr) {
+                place(slot.hash, slot.node);
+            }
+        }
+    }
+
+    // Number of nodes in the index
+    size_t _size;
+
+    // capacity - 1, capacity is power of two
+    size_t _mask;
+
+    // Table itself, empty slot has nullptr node
+    std::vector<Slot> _slots;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_HASH_INDEX_H
@@ -0,0 +1,461 @@
+#ifndef AFINA_STORAGE_ITEM_H
+#define AFINA_STORAGE_ITEM_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <new>
+#include <string>
+
+#include <afina/Storage.h>
+#include <afina/ValueView.h>
+#include <afina/allocator/Slab.h>
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # Piece of a chunked value
+ * Value that grows past a single chunk through append or prepend is kept in a list of fixed size
+ * chunks, so adding data to it never copies bytes stored already. Chunk is reference counted the same
+ * way as Item: item holds one reference to each chunk of its value, every ValueView of a chunk holds
+ * one more. View covers bytes that were in the chunk once view was taken and those never change, so
+ * the last chunk keeps taking appends while being read.
+ */
+struct Chunk {
+    // Number of bytes occupied by each chunk block
+    static constexpr size_t kBlockSize = 4096;
+
+    // Next chunk of the value, nullptr for the last one
+    Chunk *next;
+
+    // Number of references to the block
+    std::atomic<uint32_t> refs;
+
+    // Number of value bytes in the chunk
+    uint32_t size;
+
+    char *data() { return reinterpret_cast<char *>(this + 1); }
+
+    // Number of value bytes every chunk has room for
+    static constexpr size_t capacity() { return kBlockSize - sizeof(Chunk); }
+
+    /**
+     * Copies data into the list of new chunks, returns its head and the last chunk through last. Empty
+     * data gives empty list
+     */
+    static Chunk *build(const char *data, size_t size, Chunk *&last) {
+        Chunk *head = nullptr;
+        Chunk **link = &head;
+        last = nullptr;
+        while (size > 0) {
+            size_t piece = std::min(size, capacity());
+            Chunk *chunk = new (::operator new(kBlockSize)) Chunk;
+            chunk->next = nullptr;
+            chunk->refs.store(1, std::memory_order_relaxed);
+            chunk->size = piece;
+            std::memcpy(chunk->data(), data, piece);
+
+            *link = chunk;
+            link = &chunk->next;
+            last = chunk;
+            data += piece;
+            size -= piece;
+        }
+        return head;
+    }
+
+    // Copies data to the end of the list, fills the last chunk first. Returns new last chunk
+    static Chunk *extend(Chunk *last, const char *data, size_t size) {
+        size_t piece = std::min(size, capacity() - last->size);
+        std::memcpy(last->data() + last->size, data, piece);
+        last->size += piece;
+        if (piece < size) {
+            last->next = build(data + piece, size - piece, last);
+        }
+        return last;
+    }
+
+    // Drops one reference, the last one frees the block
+    static void release(Chunk *chunk) {
+        if (chunk->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            chunk->~Chunk();
+            ::operator delete(chunk);
+        }
+    }
+};
+
+/**
+ * # Storage item
+ * Header, key and value of an item live in a single contiguous memory block:
+ *
+ * [ header | key bytes | value bytes | response line tail ]
+ *
+ * So that each item costs exactly one allocation, and once header is in cache key comparison and
+ * value copy continue on the same or adjacent cache lines. LRU list and hash index point into the
+ * block intrusively.
+ *
+ * Response line tail is " <flags> <bytes>\r\n" of the memcached VALUE line, rendered on write so
+ * that get only gathers it, see Afina::ValueInfo::header. Block carries it only if it has room.
+ *
+ * Block is reference counted: storage holds one reference while item is resident, every ValueView
+ * given out holds one more. Value of the block that has views must not be modified.
+ *
+ * Chunked item keeps value in the list of chunks instead, value bytes of the block hold pointers to
+ * the first and the last one. Views of such item refer to chunks, not to the block.
+ */
+struct Item {
+    // List links, owned by storage eviction policy
+    Item *prev;
+    Item *next;
+
+    // Timing wheel slot links, used only if item expires, see TimingWheel.h
+    Item *timer_next;
+    Item **timer_pprev;
+
+    // Hash of the key, cached to avoid rehash on eviction
+    uint64_t hash;
+
+    uint32_t key_size;
+    uint32_t value_size;
+
+    // Number of payload bytes block has room for, at least key_size + value_size
+    uint32_t capacity;
+
+    // CLOCK reference bit, set by readers without any lock held
+    std::atomic<bool> referenced;
+
+    // Value is a counter kept in binary form: value bytes hold uint64_t in native byte order, readers
+    // see its decimal representation
+    bool numeric;
+
+    // Length of the response line tail following the value, 0 if block has none
+    uint8_t header_size : 6;
+
+    // Value is kept in chunks, see Chunk
+    uint8_t chunked : 1;
+
+    // Block came from Allocator::Slab rather than from the global heap
+    uint8_t slab : 1;
+
+    // Opaque state of the eviction policy: list or segment id, access counter, etc
+    uint32_t policy_data;
+
+    // Clock time when item expires, 0 if it never does
+    uint32_t expire;
+
+    // Number of references to the block
+    std::atomic<uint32_t> refs;
+
+    // Opaque client flags, see Afina::ValueInfo. Takes the padding before cas, so costs nothing
+    uint32_t flags;
+
+    // Version of the value, see Afina::ValueInfo
+    uint64_t cas;
+
+    char *key() { return reinterpret_cast<char *>(this + 1); }
+    const char *key() const { return reinterpret_cast<const char *>(this + 1); }
+
+    char *value() { return key() + key_size; }
+    const char *value() const { return key() + key_size; }
+
+    // Response line tail, valid only if header_size isn't 0
+    const char *header() const { return value() + value_size; }
+
+    // Number of payload bytes: key + value
+    size_t size() const { return size_t(key_size) + value_size; }
+
+    // Number of bytes occupied by the whole block
+    size_t memory() const { return sizeof(Item) + capacity; }
+
+    // Number of value bytes chunked item keeps in the block
+    static constexpr size_t kChunkLinks = 2 * sizeof(Chunk *);
+
+    // List of value chunks of the chunked item, pointers are unaligned, so they are copied out
+    Chunk *first_chunk() const {
+        Chunk *chunk;
+        std::memcpy(&chunk, value(), sizeof(chunk));
+        return chunk;
+    }
+    Chunk *last_chunk() const {
+        Chunk *chunk;
+        std::memcpy(&chunk, value() + sizeof(chunk), sizeof(chunk));
+        return chunk;
+    }
+    void set_chunks(Chunk *first, Chunk *last) {
+        std::memcpy(value(), &first, sizeof(first));
+        std::memcpy(value() + sizeof(first), &last, sizeof(last));
+    }
+
+    bool key_equals(const char *k, size_t k_size) const {
+        return key_size == k_size && std::memcmp(key(), k, k_size) == 0;
+    }
+
+    // True if nobody but the storage sees the block, so it could be changed in place. Views are only
+    // taken with storage lock held, so the answer stays valid while caller holds that lock
+    bool exclusive() const { return refs.load(std::memory_order_acquire) == 1; }
+
+    // Copies value as readers see it
+    void read(std::string &out) const {
+        if (numeric) {
+            out = std::to_string(number());
+        } else if (chunked) {
+            out.clear();
+            out.reserve(value_size);
+            for (Chunk *chunk = first_chunk(); chunk != nullptr; chunk = chunk->next) {
+                out.append(chunk->data(), chunk->size);
+            }
+        } else {
+            out.assign(value(), value_size);
+        }
+    }
+
+    // Value of the numeric item
+    uint64_t number() const {
+        uint64_t n;
+        std::memcpy(&n, value(), sizeof(n));
+        return n;
+    }
+
+    // Reads value as a counter, returns false if it isn't a number, see Afina::ParseCounter
+    bool counter(uint64_t &n) const {
+        if (numeric) {
+            n = number();
+            return true;
+        }
+        // Chunked value is way too long for a number
+        return !chunked && ParseCounter(value(), value_size, n);
+    }
+
+    /**
+     * Replaces value with the binary counter and stamps new version, block must be exclusive and have
+     * room for it
+     */
+    void store(uint64_t n) {
+        numeric = true;
+        header_size = 0;
+        value_size = sizeof(n);
+        std::memcpy(value(), &n, sizeof(n));
+        cas = next_cas();
+    }
+
+    // Next value version, unique across all storages of the process, so that version stays unique when
+    // key moves from one storage to another
+    static uint64_t next_cas() {
+        static std::atomic<uint64_t> last(0);
+        return last.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+    // True if value of the given size could replace current one in place: block is exclusive and not
+    // chunked, value fits and doesn't leave more than half of the block unused
+    bool reusable(size_t size) const {
+        size_t payload = size_t(key_size) + size;
+        return exclusive() && !chunked && payload <= capacity && 2 * payload >= capacity;
+    }
+
+    /**
+     * Adds data to the end (append) or to the beginning of the value in place and stamps new version,
+     * block must hold no counter. Unless item is chunked, block must be exclusive and have room for
+     * data as well
+     */
+    void concat(const char *data, size_t size, bool append) {
+        if (chunked) {
+            if (append) {
+                set_chunks(first_chunk(), Chunk::extend(last_chunk(), data, size));
+            } else if (size > 0) {
+                Chunk *last;
+                Chunk *first = Chunk::build(data, size, last);
+                last->next = first_chunk();
+                set_chunks(first, last_chunk());
+            }
+        } else if (append) {
+            std::memcpy(value() + value_size, data, size);
+        } else {
+            std::memmove(value() + size, value(), value_size);
+            std::memcpy(value(), data, size);
+        }
+        value_size += size;
+        cas = next_cas();
+        render_header();
+    }
+
+    /**
+     * Writes response line tail for current flags and value after the value if block has room for it,
+     * must be called once either of them changes. Counters get no tail, their text isn't in the block
+     */
+    void render_header() {
+        char buffer[kHeaderMax];
+        size_t size = format_header(buffer, flags, value_size);
+        if (numeric || chunked || this->size() + size > capacity) {
+            header_size = 0;
+            return;
+        }
+        std::memcpy(value() + value_size, buffer, size);
+        header_size = size;
+    }
+
+    /**
+     * Allocates new item block with room for extra bytes of payload besides key and value, copies key
+     * and value inside and stamps new version. Block has single reference owned by caller. Links are
+     * left uninitialized
+     */
+    static Item *create(uint64_t hash, const char *key, size_t key_size, const char *value, size_t value_size,
+                        size_t extra = 0) {
+        // Allocator hands out 16 bytes granules anyway, so the tail of the last one is free room
+        size_t memory = (sizeof(Item) + key_size + value_size + extra + 15) & ~size_t(15);
+        return place(::operator new(memory), memory, hash, key, key_size, value, value_size);
+    }
+
+    /**
+     * Builds item in the given block of memory bytes, the rest is the same as in create. Block goes
+     * back to the global heap on release unless item is marked as slab one
+     */
+    static Item *place(void *block, size_t memory, uint64_t hash, const char *key, size_t key_size,
+                       const char *value, size_t value_size) {
+        Item *item = new (block) Item;
+        item->hash = hash;
+        item->referenced.store(false, std::memory_order_relaxed);
+        item->numeric = false;
+        item->header_size = 0;
+        item->chunked = false;
+        item->slab = false;
+        item->policy_data = 0;
+        item->timer_next = nullptr;
+        item->timer_pprev = nullptr;
+        item->expire = 0;
+        item->refs.store(1, std::memory_order_relaxed);
+        item->flags = 0;
+        item->key_size = key_size;
+        item->value_size = value_size;
+        item->capacity = memory - sizeof(Item);
+        item->cas = next_cas();
+        std::memcpy(item->key(), key, key_size);
+        std::memcpy(item->value(), value, value_size);
+        return item;
+    }
+
+    /**
+     * Allocates new item block for the value with given flags, block gets room for the response line
+     * tail as well
+     */
+    static Item *create(uint64_t hash, const std::string &key, const std::string &value, uint32_t flags) {
+        Item *item = create(hash, key.data(), key.size(), value.data(), value.size(),
+                            block_size(0, 0, flags, value.size()) - sizeof(Item));
+        item->flags = flags;
+        item->render_header();
+        return item;
+    }
+
+    /**
+     * Number of bytes item block takes for the key and value of given sizes with given flags, response
+     * line tail included
+     */
+    static size_t block_size(size_t key_size, size_t value_size, uint32_t flags) {
+        return block_size(key_size, value_size, flags, value_size);
+    }
+
+    /**
+     * Allocates new chunked item block for the key of the given item, copies its value into chunks
+     * along with data added to the end (append) or to the beginning of it. Block has single reference
+     * owned by caller. Links and flags are left uninitialized as in create
+     */
+    static Item *create_chunked(const Item *item, const char *data, size_t size, bool append) {
+        Item *fresh = create(item->hash, item->key(), item->key_size, "", 0, kChunkLinks);
+        const char *head = append ? item->value() : data;
+        size_t head_size = append ? item->value_size : size;
+
+        Chunk *last;
+        Chunk *first = Chunk::build(head, head_size, last);
+        if (first == nullptr) {
+            first = Chunk::build(append ? data : item->value(), append ? size : item->value_size, last);
+        } else {
+            last = Chunk::extend(last, append ? data : item->value(), append ? size : item->value_size);
+        }
+        fresh->chunked = true;
+        fresh->value_size = item->value_size + size;
+        fresh->set_chunks(first, last);
+        return fresh;
+    }
+
+    /**
+     * Drops one reference, the last one frees the block along with item references to value chunks
+     */
+    static void release(Item *item) {
+        if (item->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            if (item->chunked) {
+                Chunk *chunk = item->first_chunk();
+                while (chunk != nullptr) {
+                    Chunk *next = chunk->next;
+                    Chunk::release(chunk);
+                    chunk = next;
+                }
+            }
+            bool slab = item->slab;
+            item->~Item();
+            if (slab) {
+                Allocator::Slab::free(item);
+            } else {
+                ::operator delete(item);
+            }
+        }
+    }
+
+    /**
+     * View of the item value holding its own reference to the block. Counter is formatted into memory
+     * owned by the view, so block stays exclusive and counter could be updated in place. Chunked value
+     * is seen through the chain of views, one per chunk, each holding reference to its chunk
+     */
+    static ValueView view(Item *item) {
+        if (item->numeric) {
+            return ValueView::Copy(std::to_string(item->number()));
+        }
+        if (item->chunked) {
+            ValueView result;
+            ValueView *last = nullptr;
+            for (Chunk *chunk = item->first_chunk(); chunk != nullptr; chunk = chunk->next) {
+                chunk->refs.fetch_add(1, std::memory_order_relaxed);
+                ValueView piece(chunk->data(), chunk->size, chunk,
+                                [](void *owner) { Chunk::release(static_cast<Chunk *>(owner)); });
+                if (last == nullptr) {
+                    result = std::move(piece);
+                    last = &result;
+                } else {
+                    last = &last->chain(std::move(piece));
+                }
+            }
+            return result;
+        }
+        item->refs.fetch_add(1, std::memory_order_relaxed);
+        return ValueView(item->value(), item->value_size, item,
+                         [](void *owner) { Item::release(static_cast<Item *>(owner)); });
+    }
+
+    // Longest response line tail: " 4294967295 4294967295\r\n" and terminating zero
+    static constexpr size_t kHeaderMax = 32;
+
+    // Size of the block for key and value with room for the tail of the given value size
+    static size_t block_size(size_t key_size, size_t value_size, uint32_t flags, size_t tail_value_size) {
+        char buffer[kHeaderMax];
+        return sizeof(Item) + key_size + value_size + format_header(buffer, flags, tail_value_size);
+    }
+
+    // Formats response line tail into the buffer of kHeaderMax bytes, returns its length
+    static size_t format_header(char *out, uint32_t flags, size_t value_size) {
+        return std::snprintf(out, kHeaderMax, " %u %u\r\n", unsigned(flags), unsigned(value_size));
+    }
+};
+
+/**
+ * Adapter for HashIndex
+ */
+struct ItemTraits {
+    static bool equals(const Item *item, const char *key, size_t size) { return item->key_equals(key, size); }
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_ITEM_H
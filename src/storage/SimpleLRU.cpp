@@ -1,130 +1,485 @@
 #include "SimpleLRU.h"
-#include <iostream>
+
 namespace Afina {
 namespace Backend {
 
-void SimpleLRU::delete_node_from_list(lru_node *node) {
-    if (node == _lru_head.get()) {
-        if (node->next.get() == nullptr) {
-            _lru_head.reset(nullptr);
-            return;
+// Number of keys batch operations look ahead when prefetching
+static const size_t kPrefetchDistance = 4;
+
+template <typename Policy> SimpleCache<Policy>::~SimpleCache() {
+    _lru_index.clear();
+    while (Item *item = _policy.Victim(nullptr)) {
+        _policy.Remove(item);
+        Item::release(item);
+    }
+}
+
+template <typename Policy> uint32_t SimpleCache<Policy>::tick() {
+    uint32_t now = _clock();
+    _wheel.Advance(now, [this](Item *item) { delete_item(item); });
+    return now;
+}
+
+template <typename Policy> Item *SimpleCache<Policy>::find(uint64_t hash, const std::string &key, uint32_t now) {
+    Item *item = _lru_index.find(hash, key);
+    if (item != nullptr && item->expire != 0 && item->expire <= now) {
+        delete_item(item);
+        return nullptr;
+    }
+    return item;
+}
+
+template <typename Policy> void SimpleCache<Policy>::set_expire(Item *item, uint32_t expire) {
+    if (item->timer_pprev != nullptr) {
+        _wheel.Cancel(item);
+    }
+    item->expire = expire;
+    if (expire != 0) {
+        _wheel.Schedule(item);
+    }
+}
+
+template <typename Policy> void SimpleCache<Policy>::delete_item(Item *item) {
+    current_size -= item->size();
+    _lru_index.erase(item->hash, item);
+    _policy.Remove(item);
+    if (item->timer_pprev != nullptr) {
+        _wheel.Cancel(item);
+    }
+    Item::release(item);
+}
+
+template <typename Policy> void SimpleCache<Policy>::evict(size_t size, const Item *keep) {
+    while (size + current_size > _max_size) {
+        Item *victim = _policy.Victim(keep);
+        current_size -= victim->size();
+        _lru_index.erase(victim->hash, victim);
+        _policy.Evict(victim);
+        if (victim->timer_pprev != nullptr) {
+            _wheel.Cancel(victim);
         }
-        node->next->prev = node->prev;
-        std::swap(node->next, _lru_head);
-        node->next.reset(nullptr);
-        return;
+        Item::release(victim);
     }
-    node->next->prev = node->prev;
-    std::swap(node->next, node->prev->next);
-    node->next.reset(nullptr);
-    return;
 }
 
-void SimpleLRU::to_end(lru_node *node) {
-    if (node->next.get() == nullptr) {
-        return;
+template <typename Policy>
+Item *SimpleCache<Policy>::update(Item *item, const std::string &key, const std::string &value, uint32_t expire,
+                                  uint32_t flags) {
+    _policy.Touch(item);
+
+    // New value fits into cache by itself, so there is always something
+    // else to evict until it fits
+    current_size -= item->value_size;
+    evict(value.size(), item);
+    current_size += value.size();
+
+    if (item->reusable(value.size())) {
+        size_t old_size = item->size();
+        std::memcpy(item->value(), value.data(), value.size());
+        item->value_size = value.size();
+        item->numeric = false;
+        item->flags = flags;
+        item->cas = Item::next_cas();
+        item->render_header();
+        _policy.Resize(item, old_size);
+        set_expire(item, expire);
+        return item;
     }
-    if (node == _lru_head.get()) {
-		std::swap(node->prev->next, _lru_head);
-		std::swap(node->next, _lru_head);
-		_lru_head->prev = node;
-		return;
+
+    Item *fresh = Item::create(item->hash, key, value, flags);
+    replace(item, fresh);
+    set_expire(fresh, expire);
+    return fresh;
+}
+
+template <typename Policy> void SimpleCache<Policy>::replace(Item *item, Item *fresh) {
+    _lru_index.replace(item->hash, item, fresh);
+    _policy.Replace(item, fresh);
+    if (item->timer_pprev != nullptr) {
+        _wheel.Cancel(item);
     }
-	node->next->prev = node->prev;
-    std::swap(node->prev->next, node->next);
-    std::swap(node->next, _lru_head->prev->next);
-    node->prev = _lru_head->prev;
-    _lru_head->prev = node;
-    return;
+    set_expire(fresh, item->expire);
+    Item::release(item);
 }
 
-bool SimpleLRU::Put(const std::string &key, const std::string &value) {
-    if (key.size() + value.size() > _max_size) {
+template <typename Policy>
+bool SimpleCache<Policy>::concat(const std::string &key, const std::string &data, bool append) {
+    Item *item = find(hash_key(key), key, tick());
+    if (item == nullptr) {
         return false;
     }
-    auto cur = _lru_index.find(key);
-   if (cur == _lru_index.end()) {
-        size_t elem_size = key.size() + value.size();
-        while (elem_size + current_size > _max_size) {
-            Delete(_lru_head->key);
+    if (item->numeric) {
+        // Counter turns back into text
+        std::string number = std::to_string(item->number());
+        std::string value = append ? number + data : data + number;
+        if (key.size() + value.size() > _max_size) {
+            return false;
         }
-        lru_node *tmp = new lru_node{key, value};
-        if (_lru_head.get() != nullptr) {
-            tmp->prev = _lru_head->prev;
-            std::cout<<"AAAAA "<<_lru_head->prev->next.get()<<std::endl;
-            _lru_head->prev->next.reset(tmp);
-            _lru_head->prev = tmp;
-            tmp->next.reset(nullptr);
-        } else {
-            _lru_head.reset(tmp);
-            tmp->next.reset(nullptr);
-            tmp->prev = tmp;
-        }
-        _lru_index.insert(
-            std::make_pair(std::reference_wrapper<std::string>(tmp->key), std::reference_wrapper<lru_node>(*tmp)));
-        current_size += elem_size;
+        update(item, key, value, item->expire, item->flags);
         return true;
-    } else {
-        return Set(key, value);
     }
+    if (item->size() + data.size() > _max_size) {
+        return false;
+    }
+    _policy.Touch(item);
+    evict(data.size(), item);
+    current_size += data.size();
+
+    size_t size = item->size() + data.size();
+    if (!item->chunked && size - item->key_size > Chunk::capacity()) {
+        // Value outgrew a chunk, from now on it is kept in chunks and never copied again as it grows
+        Item *fresh = Item::create_chunked(item, data.data(), data.size(), append);
+        fresh->flags = item->flags;
+        replace(item, fresh);
+        return true;
+    }
+    if (!item->chunked && (!item->exclusive() || size > item->capacity)) {
+        // Key that grows once tends to grow again, so block gets half as much room on top to take the
+        // next few pieces in place
+        Item *fresh = Item::create(item->hash, item->key(), item->key_size, item->value(), item->value_size,
+                                   data.size() + size / 2);
+        fresh->flags = item->flags;
+        replace(item, fresh);
+        item = fresh;
+    }
+    size_t old_size = item->size();
+    item->concat(data.data(), data.size(), append);
+    _policy.Resize(item, old_size);
+    return true;
+}
+
+template <typename Policy>
+Item *SimpleCache<Policy>::insert(uint64_t hash, const std::string &key, const std::string &value, uint32_t expire,
+                                  uint32_t flags) {
+    _policy.Admit(hash);
+    evict(key.size() + value.size());
+    Item *item = Item::create(hash, key, value, flags);
+    _policy.Insert(item);
+    _lru_index.insert(hash, item);
+    set_expire(item, expire);
+    current_size += item->size();
+    return item;
+}
+
+// See MapBasedGlobalLockImpl.h
+template <typename Policy> bool SimpleCache<Policy>::Put(const std::string &key, const std::string &value) {
+    return SimpleCache<Policy>::PutWithTTL(key, value, 0, 0);
 }
 
 // See MapBasedGlobalLockImpl.h
-bool SimpleLRU::PutIfAbsent(const std::string &key, const std::string &value) {
-   if (key.size() + value.size() > _max_size) {
+template <typename Policy> bool SimpleCache<Policy>::PutIfAbsent(const std::string &key, const std::string &value) {
+    return SimpleCache<Policy>::PutIfAbsentWithTTL(key, value, 0, 0);
+}
+
+// See MapBasedGlobalLockImpl.h
+template <typename Policy> bool SimpleCache<Policy>::Set(const std::string &key, const std::string &value) {
+    return SimpleCache<Policy>::SetWithTTL(key, value, 0, 0);
+}
+
+// See MapBasedGlobalLockmpl.h
+template <typename Policy> bool SimpleCache<Policy>::Delete(const std::string &key) {
+    Item *item = find(hash_key(key), key, tick());
+    if (item == nullptr) {
         return false;
     }
-    if (_lru_index.find(key) != _lru_index.end()) {
+    delete_item(item);
+    return true;
+}
+
+// See MapBasedGlobalLockImpl.h
+template <typename Policy> bool SimpleCache<Policy>::Get(const std::string &key, std::string &value) {
+    Item *item = find(hash_key(key), key, tick());
+    if (item == nullptr) {
         return false;
     }
-    return Put(key, value);
+    item->read(value);
+    _policy.Touch(item);
+    return true;
 }
 
-// See MapBasedGlobalLockImpl.h
-bool SimpleLRU::Set(const std::string &key, const std::string &value) {
-    if (value.size() + key.size() > _max_size) {
+// See afina/Storage.h
+template <typename Policy> bool SimpleCache<Policy>::GetView(const std::string &key, ValueView &value) {
+    Item *item = find(hash_key(key), key, tick());
+    if (item == nullptr) {
         return false;
     }
-    auto cur = _lru_index.find(key);
-    if (cur == _lru_index.end()) {
+    value = Item::view(item);
+    _policy.Touch(item);
+    return true;
+}
+
+template <typename Policy>
+bool SimpleCache<Policy>::put(uint64_t hash, const std::string &key, const std::string &value, uint32_t now,
+                              uint32_t ttl, uint32_t flags) {
+    if (key.size() + value.size() > _max_size) {
         return false;
     }
-    lru_node &cur_node = cur->second;
-    int difference = value.size() - cur_node.value.size();
-    to_end(&cur_node);
-    if (difference > 0) {
-        while (difference + current_size > _max_size) {
-            Delete(_lru_head->key);
+    Item *item = find(hash, key, now);
+    if (item != nullptr) {
+        update(item, key, value, expire_time(now, ttl), flags);
+    } else {
+        insert(hash, key, value, expire_time(now, ttl), flags);
+    }
+    return true;
+}
+
+// See afina/Storage.h
+template <typename Policy>
+void SimpleCache<Policy>::MultiGet(const std::vector<std::string> &keys, std::vector<ValueView> &values) {
+    values.clear();
+    values.resize(keys.size());
+    std::vector<size_t> indices(keys.size());
+    for (size_t i = 0; i < keys.size(); i++) {
+        indices[i] = i;
+    }
+    SimpleCache<Policy>::GetBatch(keys, indices.data(), indices.size(), values, nullptr);
+}
+
+// See afina/Storage.h
+template <typename Policy>
+void SimpleCache<Policy>::MultiGetWithInfo(const std::vector<std::string> &keys, std::vector<ValueView> &values,
+                                           std::vector<ValueInfo> &infos) {
+    values.clear();
+    values.resize(keys.size());
+    infos.resize(keys.size());
+    std::vector<size_t> indices(keys.size());
+    for (size_t i = 0; i < keys.size(); i++) {
+        indices[i] = i;
+    }
+    SimpleCache<Policy>::GetBatch(keys, indices.data(), indices.size(), values, infos.data());
+}
+
+// See afina/Storage.h
+template <typename Policy>
+bool SimpleCache<Policy>::MultiPut(const std::vector<std::string> &keys, const std::vector<std::string> &values) {
+    std::vector<size_t> indices(keys.size());
+    for (size_t i = 0; i < keys.size(); i++) {
+        indices[i] = i;
+    }
+    return SimpleCache<Policy>::PutBatch(keys, values, indices.data(), indices.size());
+}
+
+// See SimpleLRU.h
+template <typename Policy>
+void SimpleCache<Policy>::GetBatch(const std::vector<std::string> &keys, const size_t *indices, size_t count,
+                                   std::vector<ValueView> &values, ValueInfo *infos) {
+    uint32_t now = tick();
+    std::vector<uint64_t> hashes(count);
+    for (size_t j = 0; j < count; j++) {
+        hashes[j] = hash_key(keys[indices[j]]);
+    }
+
+    // Two stage pipeline: slot of the key kPrefetchDistance * 2 ahead is fetched, then node of the key
+    // kPrefetchDistance ahead, whose slot should be in cache by now
+    for (size_t j = 0; j < count && j < 2 * kPrefetchDistance; j++) {
+        _lru_index.prefetch(hashes[j]);
+    }
+    for (size_t j = 0; j < count && j < kPrefetchDistance; j++) {
+        _lru_index.prefetch_node(hashes[j]);
+    }
+
+    for (size_t j = 0; j < count; j++) {
+        if (j + 2 * kPrefetchDistance < count) {
+            _lru_index.prefetch(hashes[j + 2 * kPrefetchDistance]);
+        }
+        if (j + kPrefetchDistance < count) {
+            _lru_index.prefetch_node(hashes[j + kPrefetchDistance]);
+        }
+
+        size_t i = indices[j];
+        Item *item = find(hashes[j], keys[i], now);
+        if (item != nullptr) {
+            values[i] = Item::view(item);
+            if (infos != nullptr) {
+                infos[i].cas = item->cas;
+                infos[i].flags = item->flags;
+                infos[i].header = (item->header_size != 0) ? item->header() : nullptr;
+                infos[i].header_size = item->header_size;
+            }
+            _policy.Touch(item);
+        }
+    }
+}
+
+// See SimpleLRU.h
+template <typename Policy>
+bool SimpleCache<Policy>::PutBatch(const std::vector<std::string> &keys, const std::vector<std::string> &values,
+                                   const size_t *indices, size_t count) {
+    uint32_t now = tick();
+    std::vector<uint64_t> hashes(count);
+    for (size_t j = 0; j < count; j++) {
+        hashes[j] = hash_key(keys[indices[j]]);
+    }
+    for (size_t j = 0; j < count && j < kPrefetchDistance; j++) {
+        _lru_index.prefetch(hashes[j]);
+    }
+
+    bool stored = true;
+    for (size_t j = 0; j < count; j++) {
+        if (j + kPrefetchDistance < count) {
+            _lru_index.prefetch(hashes[j + kPrefetchDistance]);
         }
+        size_t i = indices[j];
+        stored = put(hashes[j], keys[i], values[i], now, 0, 0) && stored;
+    }
+    return stored;
+}
+
+// See afina/Storage.h
+template <typename Policy>
+bool SimpleCache<Policy>::PutWithTTL(const std::string &key, const std::string &value, uint32_t ttl, uint32_t flags) {
+    return put(hash_key(key), key, value, tick(), ttl, flags);
+}
+
+// See afina/Storage.h
+template <typename Policy>
+bool SimpleCache<Policy>::PutIfAbsentWithTTL(const std::string &key, const std::string &value, uint32_t ttl,
+                                             uint32_t flags) {
+    if (key.size() + value.size() > _max_size) {
+        return false;
+    }
+    uint32_t now = tick();
+    uint64_t hash = hash_key(key);
+    if (find(hash, key, now) != nullptr) {
+        return false;
     }
-    cur_node.value = value;
+    insert(hash, key, value, expire_time(now, ttl), flags);
     return true;
 }
 
-// See MapBasedGlobalLockmpl.h
-bool SimpleLRU::Delete(const std::string &key) {
-    auto cur = _lru_index.find(key);
-    if (cur == _lru_index.end()) {
+// See afina/Storage.h
+template <typename Policy>
+bool SimpleCache<Policy>::SetWithTTL(const std::string &key, const std::string &value, uint32_t ttl, uint32_t flags) {
+    if (value.size() + key.size() > _max_size) {
+        return false;
+    }
+    uint32_t now = tick();
+    Item *item = find(hash_key(key), key, now);
+    if (item == nullptr) {
         return false;
     }
-    lru_node &cur_node = cur->second;
-    current_size -= (cur_node.key.size() + cur_node.value.size());
-    _lru_index.erase(cur);
-    delete_node_from_list(&cur_node);
+    update(item, key, value, expire_time(now, ttl), flags);
     return true;
 }
 
-// See MapBasedGlobalLockImpl.h
-bool SimpleLRU::Get(const std::string &key, std::string &value) {
-    auto cur = _lru_index.find(key);
-    if (cur == _lru_index.end()) {
+// See afina/Storage.h
+template <typename Policy>
+CasResult SimpleCache<Policy>::CompareAndSwap(const std::string &key, const std::string &value, uint32_t ttl,
+                                              uint32_t flags, uint64_t cas) {
+    if (key.size() + value.size() > _max_size) {
+        return CasResult::NotStored;
+    }
+    uint32_t now = tick();
+    Item *item = find(hash_key(key), key, now);
+    if (item == nullptr) {
+        return CasResult::NotFound;
+    }
+    if (item->cas != cas) {
+        return CasResult::Exists;
+    }
+    update(item, key, value, expire_time(now, ttl), flags);
+    return CasResult::Stored;
+}
+
+// See afina/Storage.h
+template <typename Policy> bool SimpleCache<Policy>::Append(const std::string &key, const std::string &data) {
+    return concat(key, data, true);
+}
+
+// See afina/Storage.h
+template <typename Policy> bool SimpleCache<Policy>::Prepend(const std::string &key, const std::string &data) {
+    return concat(key, data, false);
+}
+
+template <typename Policy>
+DeltaResult SimpleCache<Policy>::delta(const std::string &key, uint64_t delta, bool increment, uint64_t &result) {
+    Item *item = find(hash_key(key), key, tick());
+    if (item == nullptr) {
+        return DeltaResult::NotFound;
+    }
+    uint64_t number;
+    if (!item->counter(number)) {
+        return DeltaResult::NonNumeric;
+    }
+    if (item->key_size + sizeof(uint64_t) > _max_size) {
+        return DeltaResult::NotStored;
+    }
+    result = increment ? number + delta : (number > delta ? number - delta : 0);
+    _policy.Touch(item);
+
+    if (!item->numeric || !item->exclusive()) {
+        // Counter switches to binary form, in the same block if it has room
+        current_size -= item->value_size;
+        evict(sizeof(uint64_t), item);
+        current_size += sizeof(uint64_t);
+        if (!item->exclusive() || item->key_size + sizeof(uint64_t) > item->capacity) {
+            Item *fresh = Item::create(item->hash, item->key(), item->key_size, "", 0, sizeof(uint64_t));
+            fresh->flags = item->flags;
+            replace(item, fresh);
+            item = fresh;
+        }
+    }
+    size_t old_size = item->size();
+    item->store(result);
+    _policy.Resize(item, old_size);
+    return DeltaResult::Stored;
+}
+
+// See afina/Storage.h
+template <typename Policy>
+DeltaResult SimpleCache<Policy>::Increment(const std::string &key, uint64_t delta, uint64_t &result) {
+    return SimpleCache<Policy>::delta(key, delta, true, result);
+}
+
+// See afina/Storage.h
+template <typename Policy>
+DeltaResult SimpleCache<Policy>::Decrement(const std::string &key, uint64_t delta, uint64_t &result) {
+    return SimpleCache<Policy>::delta(key, delta, false, result);
+}
+
+// See afina/Storage.h
+template <typename Policy>
+bool SimpleCache<Policy>::EvictionCandidate(const std::string &key, const std::string &value, std::string &victim) {
+    size_t size = key.size() + value.size();
+    if (size > _max_size || size + current_size <= _max_size) {
+        return false;
+    }
+    Item *item = _policy.Victim(nullptr);
+    if (item == nullptr) {
         return false;
     }
-    lru_node &cur_node = cur->second;
-    value = cur_node.value;
-    to_end(&cur_node);
+    victim.assign(item->key(), item->key_size);
     return true;
 }
 
+// See afina/Storage.h
+template <typename Policy> void SimpleCache<Policy>::Stats(std::map<std::string, std::string> &stats) {
+    tick();
+    stats["curr_items"] = std::to_string(_lru_index.size());
+    stats["bytes"] = std::to_string(current_size);
+    stats["limit_maxbytes"] = std::to_string(_max_size);
+    _policy.Stats(stats);
+}
+
+// See SimpleLRU.h
+template <typename Policy>
+bool SimpleCache<Policy>::Extract(const std::string &key, std::string &value, uint32_t &ttl, uint32_t &flags) {
+    uint32_t now = tick();
+    Item *item = find(hash_key(key), key, now);
+    if (item == nullptr) {
+        return false;
+    }
+    item->read(value);
+    ttl = (item->expire != 0) ? item->expire - now : 0;
+    flags = item->flags;
+    delete_item(item);
+    return true;
+}
+
+template class SimpleCache<LRUPolicy>;
+template class SimpleCache<SLRUPolicy>;
+template class SimpleCache<ARCPolicy>;
+template class SimpleCache<LFUPolicy>;
+
 } // namespace Backend
 } // namespace Afina
@@ -1,29 +1,39 @@
 #ifndef AFINA_STORAGE_SIMPLE_LRU_H
 #define AFINA_STORAGE_SIMPLE_LRU_H
 
+#include <cstring>
 #include <map>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <vector>
 
 #include <afina/Storage.h>
 
+#include "EvictionPolicy.h"
+#include "HashIndex.h"
+#include "Item.h"
+#include "TimingWheel.h"
+
 namespace Afina {
 namespace Backend {
 
 /**
- * # Map based implementation
+ * # Hash index based implementation
+ * Storage engine parametrized by eviction policy, see EvictionPolicy.h. Template is explicitly
+ * instantiated in SimpleLRU.cpp for every policy there.
+ *
+ * Items with TTL are tracked by timing wheel: every operation moves it to the current time and frees
+ * items that expired since, so they don't hold memory until eviction gets to them. Lookups check
+ * expiration as well, so item is never seen after its deadline.
+ *
  * That is NOT thread safe implementaiton!!
  */
-class SimpleLRU : public Afina::Storage {
+template <typename Policy> class SimpleCache : public Afina::Storage {
 public:
-    SimpleLRU(size_t max_size = 1024) : _max_size(max_size), current_size(0), _lru_head(nullptr) {}
-    ~SimpleLRU() {
-        _lru_index.clear();
-        while (_lru_head != nullptr) {
-            _lru_head = std::move(_lru_head->next);
-        }
-    }
+    SimpleCache(size_t max_size = 1024, Clock clock = steady_seconds)
+        : _max_size(max_size), current_size(0), _policy(max_size), _clock(clock), _wheel(clock()) {}
+    ~SimpleCache();
 
     // Implements Afina::Storage interface
     bool Put(const std::string &key, const std::string &value) override;
@@ -40,32 +50,136 @@ public:
     // Implements Afina::Storage interface
     bool Get(const std::string &key, std::string &value) override;
 
-private:
-    // LRU cache node
-    using lru_node = struct lru_node {
-        std::string key;
-        std::string value;
-        lru_node *prev;
-        std::unique_ptr<lru_node> next;
-    };
+    // Implements Afina::Storage interface
+    bool GetView(const std::string &key, ValueView &value) override;
+
+    // Implements Afina::Storage interface
+    void MultiGet(const std::vector<std::string> &keys, std::vector<ValueView> &values) override;
+
+    // Implements Afina::Storage interface
+    void MultiGetWithInfo(const std::vector<std::string> &keys, std::vector<ValueView> &values,
+                          std::vector<ValueInfo> &infos) override;
+
+    // Implements Afina::Storage interface
+    bool MultiPut(const std::vector<std::string> &keys, const std::vector<std::string> &values) override;
+
+    // Implements Afina::Storage interface
+    bool PutWithTTL(const std::string &key, const std::string &value, uint32_t ttl, uint32_t flags) override;
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsentWithTTL(const std::string &key, const std::string &value, uint32_t ttl, uint32_t flags) override;
+
+    // Implements Afina::Storage interface
+    bool SetWithTTL(const std::string &key, const std::string &value, uint32_t ttl, uint32_t flags) override;
+
+    // Implements Afina::Storage interface
+    CasResult CompareAndSwap(const std::string &key, const std::string &value, uint32_t ttl, uint32_t flags,
+                             uint64_t cas) override;
+
+    // Implements Afina::Storage interface
+    bool Append(const std::string &key, const std::string &data) override;
+
+    // Implements Afina::Storage interface
+    bool Prepend(const std::string &key, const std::string &data) override;
+
+    // Implements Afina::Storage interface
+    DeltaResult Increment(const std::string &key, uint64_t delta, uint64_t &result) override;
+
+    // Implements Afina::Storage interface
+    DeltaResult Decrement(const std::string &key, uint64_t delta, uint64_t &result) override;
 
+    // Implements Afina::Storage interface
+    bool EvictionCandidate(const std::string &key, const std::string &value, std::string &victim) override;
+
+    // Implements Afina::Storage interface
+    void Stats(std::map<std::string, std::string> &stats) override;
+
+    /**
+     * Removes association for the given key, copies its value, number of seconds it had left to live
+     * (0 if it never expires) and flags into output parameters
+     */
+    bool Extract(const std::string &key, std::string &value, uint32_t &ttl, uint32_t &flags);
+
+    /**
+     * Looks up keys[indices[j]] for every j < count, view of keys[i] goes into values[i] and its
+     * metadata into infos[i] unless infos is nullptr. Hash probes are pipelined with prefetch, so
+     * memory latency of different keys overlaps. Building block for MultiGet here and in StripedLRU
+     */
+    virtual void GetBatch(const std::vector<std::string> &keys, const size_t *indices, size_t count,
+                          std::vector<ValueView> &values, ValueInfo *infos);
+
+    /**
+     * Puts keys[indices[j]] -> values[indices[j]] for every j < count, returns true if all are stored
+     */
+    virtual bool PutBatch(const std::vector<std::string> &keys, const std::vector<std::string> &values,
+                          const size_t *indices, size_t count);
+
+private:
     // Maximum number of bytes could be stored in this cache.
     // i.e all (keys+values) must be less the _max_size
     std::size_t _max_size;
     std::size_t current_size;
-    // Main storage of lru_nodes, elements in this list ordered descending by "freshness": in the head
-    // element that wasn't used for longest time.
+
+    // Orders all resident items for eviction
     //
-    // List owns all nodes
-    std::unique_ptr<lru_node> _lru_head;
-    // std::unique_ptr<lru_node> _lru_tail;
-    // Index of nodes from list above, allows fast random access to elements by lru_node#key
-    std::map<std::reference_wrapper<const std::string>, std::reference_wrapper<lru_node>, std::less<std::string>>
-        _lru_index;
-    void to_end(lru_node *node);
-    void delete_node_from_list(lru_node *node);
+    // Storage owns all items that are known to policy
+    Policy _policy;
+
+    // Index of all resident items, allows fast random access to elements by key
+    HashIndex<Item, ItemTraits> _lru_index;
+
+    // Expiration of items with TTL
+    Clock _clock;
+    TimingWheel _wheel;
+
+    // Moves timing wheel to the current time, returns that time
+    uint32_t tick();
+    // Looks up item that isn't expired at the given time, expired one is deleted on the way
+    Item *find(uint64_t hash, const std::string &key, uint32_t now);
+    // Sets deadline of the item, 0 means it never expires
+    void set_expire(Item *item, uint32_t expire);
+
+    // Removes item from index, policy and timing wheel, frees item memory
+    void delete_item(Item *item);
+    // Evicts items chosen by policy until there is enough space to store extra size bytes, item keep
+    // is never evicted
+    void evict(size_t size, const Item *keep = nullptr);
+    // Put of the key with known hash at the given time
+    bool put(uint64_t hash, const std::string &key, const std::string &value, uint32_t now, uint32_t ttl,
+             uint32_t flags);
+    // Creates new item for the key that isn't in the cache yet
+    Item *insert(uint64_t hash, const std::string &key, const std::string &value, uint32_t expire, uint32_t flags);
+    // Stores new value, deadline and flags for the existing item, returns pointer to the item that holds
+    // value after all
+    Item *update(Item *item, const std::string &key, const std::string &value, uint32_t expire, uint32_t flags);
+    // Puts fresh item in place of the given one everywhere, deadline included, frees the old one
+    void replace(Item *item, Item *fresh);
+    // Adds data to the value of the existing key, in place if item has room for it or the value is chunked
+    bool concat(const std::string &key, const std::string &data, bool append);
+    // Updates counter of the existing key, keeps it in binary form in place
+    DeltaResult delta(const std::string &key, uint64_t delta, bool increment, uint64_t &result);
 };
 
+/**
+ * Classic exact LRU
+ */
+using SimpleLRU = SimpleCache<LRUPolicy>;
+
+/**
+ * Segmented LRU, see SLRUPolicy
+ */
+using SimpleSLRU = SimpleCache<SLRUPolicy>;
+
+/**
+ * Adaptive replacement cache, see ARCPolicy
+ */
+using SimpleARC = SimpleCache<ARCPolicy>;
+
+/**
+ * LFU with aging, see LFUPolicy
+ */
+using SimpleLFU = SimpleCache<LFUPolicy>;
+
 } // namespace Backend
 } // namespace Afina
 
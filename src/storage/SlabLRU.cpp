@@ -0,0 +1,537 @@
+#include "SlabLRU.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace Afina {
+namespace Backend {
+
+// Number of keys MultiGet looks ahead when prefetching
+static const size_t kPrefetchDistance = 4;
+
+// Region for the given budget, there must be at least one whole page after alignment. Mapping is only
+// aligned to the system page, so slab gets exactly that many bytes even if it is rounded up
+static size_t region_size(size_t max_size) {
+    return std::max(max_size, Allocator::Slab::kPageSize) + Allocator::Slab::kPageSize - 1;
+}
+
+SlabLRU::SlabLRU(size_t max_size, double factor, Clock clock, Allocator::HugePages huge_pages)
+    : _max_size(max_size), _memory(region_size(max_size), huge_pages),
+      _slab(_memory.data(), region_size(max_size), factor), _prefault_ms(-1), current_size(0),
+      _lru(_slab.classes()), _clock(clock), _wheel(clock()), _evictions(0),
+      _activity(_slab.classes(), ClassActivity{0, 0}), _pages_moved(0), _move_evictions(0) {}
+
+SlabLRU::~SlabLRU() {
+    _index.clear();
+    for (auto &list : _lru) {
+        while (!list.empty()) {
+            Item *item = list.front();
+            list.remove(item);
+            Item::release(item);
+        }
+    }
+}
+
+void SlabLRU::link(Item *item) {
+    _lru[item->policy_data].push_back(item);
+    current_size += item->size();
+}
+
+void SlabLRU::unlink(Item *item) {
+    _lru[item->policy_data].remove(item);
+    current_size -= item->size();
+}
+
+void SlabLRU::touch(Item *item) {
+    _lru[item->policy_data].move_back(item);
+    _activity[item->policy_data].hits++;
+}
+
+uint32_t SlabLRU::tick() {
+    uint32_t now = _clock();
+    _wheel.Advance(now, [this](Item *item) { delete_item(item); });
+    return now;
+}
+
+Item *SlabLRU::find(uint64_t hash, const std::string &key, uint32_t now) {
+    Item *item = _index.find(hash, key);
+    if (item != nullptr && item->expire != 0 && item->expire <= now) {
+        delete_item(item);
+        return nullptr;
+    }
+    return item;
+}
+
+void SlabLRU::set_expire(Item *item, uint32_t expire) {
+    if (item->timer_pprev != nullptr) {
+        _wheel.Cancel(item);
+    }
+    item->expire = expire;
+    if (expire != 0) {
+        _wheel.Schedule(item);
+    }
+}
+
+void SlabLRU::delete_item(Item *item) {
+    _index.erase(item->hash, item);
+    unlink(item);
+    if (item->timer_pprev != nullptr) {
+        _wheel.Cancel(item);
+    }
+    Item::release(item);
+}
+
+Item *SlabLRU::allocate(uint64_t hash, const char *key, size_t key_size, const char *value, size_t value_size,
+                        size_t extra, const Item *keep) {
+    size_t memory = sizeof(Item) + key_size + value_size + extra;
+    size_t cls = _slab.class_of(memory);
+    if (cls == _slab.classes()) {
+        return nullptr;
+    }
+
+    // Evicted item still seen through a view keeps its chunk, so eviction goes on until some chunk
+    // is really freed
+    void *block;
+    bool page_freed = false;
+    while ((block = _slab.try_alloc(memory)) == nullptr) {
+        Item *victim = _lru[cls].empty() ? nullptr : _lru[cls].first_except(keep);
+        if (victim != nullptr) {
+            delete_item(victim);
+            _evictions++;
+            _activity[cls].pressure++;
+            continue;
+        }
+
+        // Class is starved, page of the coldest class is taken right away
+        size_t source = coldest(cls, false);
+        if (source == _slab.classes() || !free_page(source, keep)) {
+            _activity[cls].pressure++;
+            return nullptr;
+        }
+        page_freed = true;
+    }
+
+    // Page counts as moved only once the class really got it
+    if (page_freed) {
+        _pages_moved++;
+    }
+    Item *item = Item::place(block, _slab.chunk_size(cls), hash, key, key_size, value, value_size);
+    item->slab = true;
+    item->policy_data = cls;
+    return item;
+}
+
+Item *SlabLRU::allocate(uint64_t hash, const std::string &key, const std::string &value, uint32_t flags,
+                        const Item *keep) {
+    size_t payload = key.size() + value.size();
+    Item *item = allocate(hash, key.data(), key.size(), value.data(), value.size(),
+                          Item::block_size(key.size(), value.size(), flags) - sizeof(Item) - payload, keep);
+    if (item != nullptr) {
+        item->flags = flags;
+        item->render_header();
+    }
+    return item;
+}
+
+size_t SlabLRU::coldest(size_t except, bool background) const {
+    size_t result = _slab.classes();
+    double result_rate = 0;
+    for (size_t cls = 0; cls < _slab.classes(); cls++) {
+        if (cls == except || _lru[cls].empty()) {
+            continue;
+        }
+        size_t pages = _slab.class_pages(cls);
+        if (background && (pages < 2 || _activity[cls].pressure > 0)) {
+            continue;
+        }
+        double rate = double(_activity[cls].hits) / pages;
+        if (result == _slab.classes() || rate < result_rate) {
+            result = cls;
+            result_rate = rate;
+        }
+    }
+    return result;
+}
+
+bool SlabLRU::free_page(size_t cls, const Item *keep) {
+    Item *head = _lru[cls].first_except(keep);
+    if (head == nullptr) {
+        return false;
+    }
+
+    // Items of a page are scattered over the list, the whole list is scanned
+    const void *page = Allocator::Slab::page_of(head);
+    size_t evicted = 0;
+    for (Item *item = _lru[cls].front(); item != nullptr;) {
+        Item *next = item->next;
+        if (item != keep && Allocator::Slab::page_of(item) == page) {
+            delete_item(item);
+            evicted++;
+        }
+        item = next;
+    }
+    _move_evictions += evicted;
+    return true;
+}
+
+bool SlabLRU::insert(uint64_t hash, const std::string &key, const std::string &value, uint32_t expire,
+                     uint32_t flags) {
+    Item *item = allocate(hash, key, value, flags, nullptr);
+    if (item == nullptr) {
+        return false;
+    }
+    link(item);
+    _index.insert(hash, item);
+    set_expire(item, expire);
+    return true;
+}
+
+bool SlabLRU::update(Item *item, const std::string &key, const std::string &value, uint32_t expire,
+                     uint32_t flags) {
+    if (item->reusable(value.size())) {
+        unlink(item);
+        std::memcpy(item->value(), value.data(), value.size());
+        item->value_size = value.size();
+        item->numeric = false;
+        item->flags = flags;
+        item->cas = Item::next_cas();
+        item->render_header();
+        link(item);
+        set_expire(item, expire);
+        return true;
+    }
+
+    Item *fresh = allocate(item->hash, key, value, flags, item);
+    if (fresh == nullptr) {
+        // Old value must not be seen after failed update
+        delete_item(item);
+        return false;
+    }
+    replace(item, fresh);
+    set_expire(fresh, expire);
+    return true;
+}
+
+void SlabLRU::replace(Item *item, Item *fresh) {
+    _index.replace(item->hash, item, fresh);
+    unlink(item);
+    link(fresh);
+    if (item->timer_pprev != nullptr) {
+        _wheel.Cancel(item);
+    }
+    set_expire(fresh, item->expire);
+    Item::release(item);
+}
+
+bool SlabLRU::concat(const std::string &key, const std::string &data, bool append) {
+    Item *item = find(hash_key(key), key, tick());
+    if (item == nullptr) {
+        return false;
+    }
+    if (item->numeric) {
+        // Counter turns back into text
+        std::string number = std::to_string(item->number());
+        std::string value = append ? number + data : data + number;
+        if (key.size() + value.size() > _max_size) {
+            return false;
+        }
+        return update(item, key, value, item->expire, item->flags);
+    }
+    size_t size = item->size() + data.size();
+    if (size > _max_size) {
+        return false;
+    }
+
+    if (!item->exclusive() || size > item->capacity) {
+        // Block of the larger class, rounding up to class size leaves room for the next few pieces
+        size_t extra = Item::block_size(item->key_size, size - item->key_size, item->flags) - sizeof(Item) -
+                       item->size();
+        Item *fresh = allocate(item->hash, item->key(), item->key_size, item->value(), item->value_size, extra, item);
+        if (fresh == nullptr) {
+            return false;
+        }
+        fresh->flags = item->flags;
+        replace(item, fresh);
+        item = fresh;
+    }
+    unlink(item);
+    item->concat(data.data(), data.size(), append);
+    link(item);
+    return true;
+}
+
+// See SlabLRU.h
+bool SlabLRU::Put(const std::string &key, const std::string &value) { return SlabLRU::PutWithTTL(key, value, 0, 0); }
+
+// See SlabLRU.h
+bool SlabLRU::PutIfAbsent(const std::string &key, const std::string &value) {
+    return SlabLRU::PutIfAbsentWithTTL(key, value, 0, 0);
+}
+
+// See SlabLRU.h
+bool SlabLRU::Set(const std::string &key, const std::string &value) { return SlabLRU::SetWithTTL(key, value, 0, 0); }
+
+// See SlabLRU.h
+bool SlabLRU::Delete(const std::string &key) {
+    Item *item = find(hash_key(key), key, tick());
+    if (item == nullptr) {
+        return false;
+    }
+    delete_item(item);
+    return true;
+}
+
+// See SlabLRU.h
+bool SlabLRU::Get(const std::string &key, std::string &value) {
+    Item *item = find(hash_key(key), key, tick());
+    if (item == nullptr) {
+        return false;
+    }
+    item->read(value);
+    touch(item);
+    return true;
+}
+
+// See SlabLRU.h
+bool SlabLRU::GetView(const std::string &key, ValueView &value) {
+    Item *item = find(hash_key(key), key, tick());
+    if (item == nullptr) {
+        return false;
+    }
+    value = Item::view(item);
+    touch(item);
+    return true;
+}
+
+DeltaResult SlabLRU::delta(const std::string &key, uint64_t delta, bool increment, uint64_t &result) {
+    Item *item = find(hash_key(key), key, tick());
+    if (item == nullptr) {
+        return DeltaResult::NotFound;
+    }
+    uint64_t number;
+    if (!item->counter(number)) {
+        return DeltaResult::NonNumeric;
+    }
+    if (item->key_size + sizeof(uint64_t) > _max_size) {
+        return DeltaResult::NotStored;
+    }
+    result = increment ? number + delta : (number > delta ? number - delta : 0);
+
+    if (!item->exclusive() || item->key_size + sizeof(uint64_t) > item->capacity) {
+        // Counter switches to binary form, see SimpleCache::delta
+        Item *fresh = allocate(item->hash, item->key(), item->key_size, "", 0, sizeof(uint64_t), item);
+        if (fresh == nullptr) {
+            return DeltaResult::NotStored;
+        }
+        fresh->flags = item->flags;
+        replace(item, fresh);
+        item = fresh;
+    }
+    unlink(item);
+    item->store(result);
+    link(item);
+    return DeltaResult::Stored;
+}
+
+void SlabLRU::lookup(const std::vector<std::string> &keys, std::vector<ValueView> &values, ValueInfo *infos) {
+    uint32_t now = tick();
+    std::vector<uint64_t> hashes(keys.size());
+    for (size_t i = 0; i < keys.size(); i++) {
+        hashes[i] = hash_key(keys[i]);
+    }
+
+    // Same two stage prefetch pipeline as in SimpleCache::GetBatch
+    for (size_t i = 0; i < keys.size() && i < 2 * kPrefetchDistance; i++) {
+        _index.prefetch(hashes[i]);
+    }
+    for (size_t i = 0; i < keys.size() && i < kPrefetchDistance; i++) {
+        _index.prefetch_node(hashes[i]);
+    }
+
+    for (size_t i = 0; i < keys.size(); i++) {
+        if (i + 2 * kPrefetchDistance < keys.size()) {
+            _index.prefetch(hashes[i + 2 * kPrefetchDistance]);
+        }
+        if (i + kPrefetchDistance < keys.size()) {
+            _index.prefetch_node(hashes[i + kPrefetchDistance]);
+        }
+
+        Item *item = find(hashes[i], keys[i], now);
+        if (item != nullptr) {
+            values[i] = Item::view(item);
+            if (infos != nullptr) {
+                infos[i].cas = item->cas;
+                infos[i].flags = item->flags;
+                infos[i].header = (item->header_size != 0) ? item->header() : nullptr;
+                infos[i].header_size = item->header_size;
+            }
+            touch(item);
+        }
+    }
+}
+
+// See SlabLRU.h
+void SlabLRU::MultiGet(const std::vector<std::string> &keys, std::vector<ValueView> &values) {
+    values.clear();
+    values.resize(keys.size());
+    lookup(keys, values, nullptr);
+}
+
+// See SlabLRU.h
+void SlabLRU::MultiGetWithInfo(const std::vector<std::string> &keys, std::vector<ValueView> &values,
+                               std::vector<ValueInfo> &infos) {
+    values.clear();
+    values.resize(keys.size());
+    infos.resize(keys.size());
+    lookup(keys, values, infos.data());
+}
+
+// See SlabLRU.h
+bool SlabLRU::PutWithTTL(const std::string &key, const std::string &value, uint32_t ttl, uint32_t flags) {
+    if (key.size() + value.size() > _max_size) {
+        return false;
+    }
+    uint32_t now = tick();
+    uint64_t hash = hash_key(key);
+    Item *item = find(hash, key, now);
+    if (item != nullptr) {
+        return update(item, key, value, expire_time(now, ttl), flags);
+    }
+    return insert(hash, key, value, expire_time(now, ttl), flags);
+}
+
+// See SlabLRU.h
+bool SlabLRU::PutIfAbsentWithTTL(const std::string &key, const std::string &value, uint32_t ttl, uint32_t flags) {
+    if (key.size() + value.size() > _max_size) {
+        return false;
+    }
+    uint32_t now = tick();
+    uint64_t hash = hash_key(key);
+    if (find(hash, key, now) != nullptr) {
+        return false;
+    }
+    return insert(hash, key, value, expire_time(now, ttl), flags);
+}
+
+// See SlabLRU.h
+bool SlabLRU::SetWithTTL(const std::string &key, const std::string &value, uint32_t ttl, uint32_t flags) {
+    if (key.size() + value.size() > _max_size) {
+        return false;
+    }
+    uint32_t now = tick();
+    Item *item = find(hash_key(key), key, now);
+    if (item == nullptr) {
+        return false;
+    }
+    return update(item, key, value, expire_time(now, ttl), flags);
+}
+
+// See SlabLRU.h
+CasResult SlabLRU::CompareAndSwap(const std::string &key, const std::string &value, uint32_t ttl, uint32_t flags,
+                                  uint64_t cas) {
+    if (key.size() + value.size() > _max_size) {
+        return CasResult::NotStored;
+    }
+    uint32_t now = tick();
+    Item *item = find(hash_key(key), key, now);
+    if (item == nullptr) {
+        return CasResult::NotFound;
+    }
+    if (item->cas != cas) {
+        return CasResult::Exists;
+    }
+    return update(item, key, value, expire_time(now, ttl), flags) ? CasResult::Stored : CasResult::NotStored;
+}
+
+// See SlabLRU.h
+bool SlabLRU::Append(const std::string &key, const std::string &data) { return concat(key, data, true); }
+
+// See SlabLRU.h
+bool SlabLRU::Prepend(const std::string &key, const std::string &data) { return concat(key, data, false); }
+
+// See SlabLRU.h
+DeltaResult SlabLRU::Increment(const std::string &key, uint64_t delta, uint64_t &result) {
+    return SlabLRU::delta(key, delta, true, result);
+}
+
+// See SlabLRU.h
+DeltaResult SlabLRU::Decrement(const std::string &key, uint64_t delta, uint64_t &result) {
+    return SlabLRU::delta(key, delta, false, result);
+}
+
+// See SlabLRU.h
+bool SlabLRU::EvictionCandidate(const std::string &key, const std::string &value, std::string &victim) {
+    size_t memory = Item::block_size(key.size(), value.size(), 0);
+    size_t cls = _slab.class_of(memory);
+    if (cls == _slab.classes() || _lru[cls].empty() || _slab.available(memory)) {
+        return false;
+    }
+    Item *item = _lru[cls].front();
+    victim.assign(item->key(), item->key_size);
+    return true;
+}
+
+// See SlabLRU.h
+void SlabLRU::Start() {
+    size_t n_threads = std::max(1u, std::thread::hardware_concurrency());
+    _prefault_ms = _memory.prefault(n_threads).count();
+}
+
+// See SlabLRU.h
+void SlabLRU::Stats(std::map<std::string, std::string> &stats) {
+    stats["curr_items"] = std::to_string(_index.size());
+    stats["bytes"] = std::to_string(current_size);
+    stats["limit_maxbytes"] = std::to_string(_max_size);
+    stats["evictions"] = std::to_string(_evictions);
+    stats["slab_pages"] = std::to_string(_slab.pages());
+    stats["slab_free_pages"] = std::to_string(_slab.free_pages());
+    stats["slab_pages_moved"] = std::to_string(_pages_moved);
+    stats["slab_move_evictions"] = std::to_string(_move_evictions);
+    for (size_t cls = 0; cls < _slab.classes(); cls++) {
+        size_t pages = _slab.class_pages(cls);
+        if (pages > 0) {
+            stats["slab_class_" + std::to_string(cls) + "_pages"] = std::to_string(pages);
+        }
+    }
+
+    static const char *pages[] = {"none", "transparent", "explicit"};
+    stats["huge_pages"] = pages[int(_memory.huge_pages())];
+    if (_prefault_ms >= 0) {
+        stats["prefault_ms"] = std::to_string(_prefault_ms);
+    }
+}
+
+// See SlabLRU.h
+bool SlabLRU::Rebalance() {
+    size_t target = _slab.classes();
+    uint64_t pressure = 0;
+    for (size_t cls = 0; cls < _slab.classes(); cls++) {
+        if (_activity[cls].pressure > pressure) {
+            target = cls;
+            pressure = _activity[cls].pressure;
+        }
+    }
+    size_t source = (target != _slab.classes()) ? coldest(target, true) : target;
+
+    // Next period starts from scratch
+    for (auto &activity : _activity) {
+        activity = ClassActivity{0, 0};
+    }
+    if (target == _slab.classes()) {
+        return false;
+    }
+
+    // Page freed by an earlier move could be kept by views of its items until now, it goes first. Page goes
+    // to the target right away, otherwise any class, source included, could take it back
+    if (_slab.free_pages() == 0 && (source == _slab.classes() || !free_page(source, nullptr))) {
+        return false;
+    }
+    if (!_slab.assign(target)) {
+        return false;
+    }
+    _pages_moved++;
+    return true;
+}
+
+} // namespace Backend
+} // namespace Afina
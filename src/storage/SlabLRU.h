@@ -0,0 +1,213 @@
+#ifndef AFINA_STORAGE_SLAB_LRU_H
+#define AFINA_STORAGE_SLAB_LRU_H
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <afina/Storage.h>
+#include <afina/allocator/Region.h>
+#include <afina/allocator/Slab.h>
+
+#include "EvictionPolicy.h"
+#include "HashIndex.h"
+#include "Item.h"
+#include "TimingWheel.h"
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # LRU over slab allocated items
+ * Cache maps single memory region of max_size bytes on construction and carves every item out of it
+ * through Allocator::Slab, nothing else is allocated per item except index nodes. So the limit bounds
+ * real memory usage, and fragmentation is bounded by slab size classes: block never wastes more than
+ * (factor - 1) of its size. Region could be backed by huge pages, Start maps all of its pages upfront
+ * so that the cache doesn't take page faults while it fills up.
+ *
+ * Every size class has its own LRU list. New item evicts least recently used items of its class
+ * until a chunk of the class is free, so an item is never evicted for an item of a different size.
+ * Pages once given to a class stay there until all their chunks are freed. Once value sizes shift,
+ * memory stays in the classes nobody uses any more, so pages are moved between classes by evicting
+ * all items of the page:
+ * - right away, if class of new item has nothing to evict and there are no free pages
+ * - by Rebalance, from the class that is the coldest one over the last period to the class that
+ *   evicted the most during it
+ *
+ * Values are never split into chunks, value must fit into the largest slab class (a page). Views of
+ * values must not outlive the cache since they point into its region.
+ *
+ * Items with TTL are freed by timing wheel as SimpleCache does, see SimpleLRU.h
+ *
+ * That is NOT thread safe implementaiton, see ThreadSafeSlabLRU.h
+ */
+class SlabLRU : public Afina::Storage {
+public:
+    /**
+     * @param max_size number of bytes in the region, at least one slab page is taken
+     * @param factor ratio of chunk sizes of the adjacent slab classes
+     * @param huge_pages pages to back the region by, falls back to smaller ones if they are unavailable
+     */
+    SlabLRU(size_t max_size = 64 << 20, double factor = 1.25, Clock clock = steady_seconds,
+            Allocator::HugePages huge_pages = Allocator::HugePages::None);
+    ~SlabLRU();
+
+    // Prefaults the region in parallel, must be called before the cache is used
+    void Start() override;
+
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Delete(const std::string &key) override;
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool GetView(const std::string &key, ValueView &value) override;
+
+    // Implements Afina::Storage interface
+    void MultiGet(const std::vector<std::string> &keys, std::vector<ValueView> &values) override;
+
+    // Implements Afina::Storage interface
+    void MultiGetWithInfo(const std::vector<std::string> &keys, std::vector<ValueView> &values,
+                          std::vector<ValueInfo> &infos) override;
+
+    // Implements Afina::Storage interface
+    bool PutWithTTL(const std::string &key, const std::string &value, uint32_t ttl, uint32_t flags) override;
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsentWithTTL(const std::string &key, const std::string &value, uint32_t ttl, uint32_t flags) override;
+
+    // Implements Afina::Storage interface
+    bool SetWithTTL(const std::string &key, const std::string &value, uint32_t ttl, uint32_t flags) override;
+
+    // Implements Afina::Storage interface
+    CasResult CompareAndSwap(const std::string &key, const std::string &value, uint32_t ttl, uint32_t flags,
+                             uint64_t cas) override;
+
+    // Implements Afina::Storage interface
+    bool Append(const std::string &key, const std::string &data) override;
+
+    // Implements Afina::Storage interface
+    bool Prepend(const std::string &key, const std::string &data) override;
+
+    // Implements Afina::Storage interface
+    DeltaResult Increment(const std::string &key, uint64_t delta, uint64_t &result) override;
+
+    // Implements Afina::Storage interface
+    DeltaResult Decrement(const std::string &key, uint64_t delta, uint64_t &result) override;
+
+    // Implements Afina::Storage interface
+    bool EvictionCandidate(const std::string &key, const std::string &value, std::string &victim) override;
+
+    // Implements Afina::Storage interface, adds slab usage, pages of every class, number of evictions and
+    // page moves, kind of pages backing the region and time it took to prefault them
+    void Stats(std::map<std::string, std::string> &stats) override;
+
+    /**
+     * Moves one page to the class that evicted the most since the previous call, if there is a class
+     * that evicted nothing during that period and has more than one page. Page is taken from the one
+     * having the fewest hits per page, page left free by earlier moves is used first. Page is assigned
+     * to the class right away. Returns true if page was moved
+     */
+    virtual bool Rebalance();
+
+private:
+    // Region all items live in and allocator carving it
+    const std::size_t _max_size;
+    Allocator::Region _memory;
+    Allocator::Slab _slab;
+
+    // Time the last Start spent on prefaulting the region, -1 if it was never called
+    int64_t _prefault_ms;
+
+    // Total number of bytes in keys and values
+    std::size_t current_size;
+
+    // LRU list of every slab class, item keeps its class in policy_data. Lists own all items
+    std::vector<ItemList> _lru;
+
+    // Index of items from the lists above
+    HashIndex<Item, ItemTraits> _index;
+
+    // Expiration of items with TTL
+    Clock _clock;
+    TimingWheel _wheel;
+
+    // Items evicted to make room for others
+    uint64_t _evictions;
+
+    // Activity of the slab class since the last Rebalance
+    struct ClassActivity {
+        uint64_t hits;
+        // Items evicted and items not stored for lack of room
+        uint64_t pressure;
+    };
+    std::vector<ClassActivity> _activity;
+
+    // Pages moved between classes and items evicted to free them
+    uint64_t _pages_moved;
+    uint64_t _move_evictions;
+
+    // Moves timing wheel to the current time, returns that time
+    uint32_t tick();
+    // Looks up item that isn't expired at the given time, expired one is deleted on the way
+    Item *find(uint64_t hash, const std::string &key, uint32_t now);
+    // Sets deadline of the item, 0 means it never expires
+    void set_expire(Item *item, uint32_t expire);
+
+    // Builds item in a slab block with room for extra bytes besides key and value, evicts least recently
+    // used items of the block class while it has no free chunks, item keep is never evicted. Returns
+    // nullptr if item doesn't fit into any class or there is nothing left to evict
+    Item *allocate(uint64_t hash, const char *key, size_t key_size, const char *value, size_t value_size,
+                   size_t extra, const Item *keep);
+    // Same, but for the value with given flags, block gets response line tail
+    Item *allocate(uint64_t hash, const std::string &key, const std::string &value, uint32_t flags,
+                   const Item *keep);
+
+    // Class with the fewest hits per page during the current period among classes other than except
+    // having items. In background mode class must have evicted nothing and have more than one page.
+    // Returns number of classes if there is no such class
+    size_t coldest(size_t except, bool background) const;
+    // Evicts every item of the page holding the least recently used item of the class except item keep,
+    // so that page goes back to the pool once all views of the items are gone. Returns false if nothing
+    // is evicted
+    bool free_page(size_t cls, const Item *keep);
+
+    // Places item at the tail of its class list
+    void link(Item *item);
+    // Removes item from its class list without freeing it
+    void unlink(Item *item);
+    // Moves item to the tail of its class list on hit
+    void touch(Item *item);
+    // Removes item from index, list and timing wheel, frees item memory
+    void delete_item(Item *item);
+    // Creates new item for the key that isn't in the cache yet, false if there is no room for it
+    bool insert(uint64_t hash, const std::string &key, const std::string &value, uint32_t expire, uint32_t flags);
+    // Stores new value, deadline and flags for the existing item. If there is no room for the new value
+    // item is deleted and false is returned
+    bool update(Item *item, const std::string &key, const std::string &value, uint32_t expire, uint32_t flags);
+    // Puts fresh item in place of the given one in index and timing wheel, fresh item goes to the tail
+    // of its class list. Frees the old one
+    void replace(Item *item, Item *fresh);
+    // Adds data to the value of the existing key, in place if item has room for it
+    bool concat(const std::string &key, const std::string &data, bool append);
+    // Updates counter of the existing key, keeps it in binary form in place
+    DeltaResult delta(const std::string &key, uint64_t delta, bool increment, uint64_t &result);
+    // Batch lookup, metadata goes to infos unless it is nullptr
+    void lookup(const std::vector<std::string> &keys, std::vector<ValueView> &values, ValueInfo *infos);
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_SLAB_LRU_H
@@ -0,0 +1,175 @@
+#include "StripedLRU.h"
+
+#include <cstdint>
+#include <stdexcept>
+
+namespace Afina {
+namespace Backend {
+
+// See StripedLRU.h
+StripedLRU::StripedLRU(size_t max_size, size_t n_stripes) {
+    if (n_stripes == 0 || max_size / n_stripes == 0) {
+        throw std::runtime_error("Too small cache for the given number of stripes");
+    }
+
+    _shards.reserve(n_stripes);
+    for (size_t i = 0; i < n_stripes; i++) {
+        _shards.emplace_back(new ThreadSafeSimplLRU(max_size / n_stripes));
+    }
+}
+
+// See StripedLRU.h
+size_t StripedLRU::shard_index(const std::string &key) {
+    // Take high bits of the mixed hash, so that shard selection isn't correlated with
+    // whatever low bits the shard itself uses for indexing
+    uint64_t h = static_cast<uint64_t>(_hash(key)) * 0x9E3779B97F4A7C15ull;
+    return (h >> 32) % _shards.size();
+}
+
+// See StripedLRU.h
+ThreadSafeSimplLRU &StripedLRU::shard(const std::string &key) { return *_shards[shard_index(key)]; }
+
+// See StripedLRU.h
+void StripedLRU::group(const std::vector<std::string> &keys, std::vector<size_t> &order,
+                       std::vector<size_t> &offsets) {
+    // Counting sort by shard index
+    std::vector<size_t> shard_of(keys.size());
+    offsets.assign(_shards.size() + 1, 0);
+    for (size_t i = 0; i < keys.size(); i++) {
+        shard_of[i] = shard_index(keys[i]);
+        offsets[shard_of[i] + 1]++;
+    }
+    for (size_t s = 0; s < _shards.size(); s++) {
+        offsets[s + 1] += offsets[s];
+    }
+
+    order.resize(keys.size());
+    std::vector<size_t> next(offsets.begin(), offsets.end() - 1);
+    for (size_t i = 0; i < keys.size(); i++) {
+        order[next[shard_of[i]]++] = i;
+    }
+}
+
+// See StripedLRU.h
+bool StripedLRU::Put(const std::string &key, const std::string &value) { return shard(key).Put(key, value); }
+
+// See StripedLRU.h
+bool StripedLRU::PutIfAbsent(const std::string &key, const std::string &value) {
+    return shard(key).PutIfAbsent(key, value);
+}
+
+// See StripedLRU.h
+bool StripedLRU::Set(const std::string &key, const std::string &value) { return shard(key).Set(key, value); }
+
+// See StripedLRU.h
+bool StripedLRU::Delete(const std::string &key) { return shard(key).Delete(key); }
+
+// See StripedLRU.h
+bool StripedLRU::Get(const std::string &key, std::string &value) { return shard(key).Get(key, value); }
+
+// See StripedLRU.h
+bool StripedLRU::GetView(const std::string &key, ValueView &value) { return shard(key).GetView(key, value); }
+
+// See StripedLRU.h
+void StripedLRU::MultiGet(const std::vector<std::string> &keys, std::vector<ValueView> &values) {
+    values.clear();
+    values.resize(keys.size());
+
+    std::vector<size_t> order, offsets;
+    group(keys, order, offsets);
+    for (size_t s = 0; s < _shards.size(); s++) {
+        if (offsets[s + 1] > offsets[s]) {
+            _shards[s]->GetBatch(keys, &order[offsets[s]], offsets[s + 1] - offsets[s], values, nullptr);
+        }
+    }
+}
+
+// See StripedLRU.h
+void StripedLRU::MultiGetWithInfo(const std::vector<std::string> &keys, std::vector<ValueView> &values,
+                                  std::vector<ValueInfo> &infos) {
+    values.clear();
+    values.resize(keys.size());
+    infos.resize(keys.size());
+
+    std::vector<size_t> order, offsets;
+    group(keys, order, offsets);
+    for (size_t s = 0; s < _shards.size(); s++) {
+        if (offsets[s + 1] > offsets[s]) {
+            _shards[s]->GetBatch(keys, &order[offsets[s]], offsets[s + 1] - offsets[s], values, infos.data());
+        }
+    }
+}
+
+// See StripedLRU.h
+bool StripedLRU::MultiPut(const std::vector<std::string> &keys, const std::vector<std::string> &values) {
+    std::vector<size_t> order, offsets;
+    group(keys, order, offsets);
+
+    bool stored = true;
+    for (size_t s = 0; s < _shards.size(); s++) {
+        if (offsets[s + 1] > offsets[s]) {
+            stored = _shards[s]->PutBatch(keys, values, &order[offsets[s]], offsets[s + 1] - offsets[s]) && stored;
+        }
+    }
+    return stored;
+}
+
+// See StripedLRU.h
+bool StripedLRU::PutWithTTL(const std::string &key, const std::string &value, uint32_t ttl, uint32_t flags) {
+    return shard(key).PutWithTTL(key, value, ttl, flags);
+}
+
+// See StripedLRU.h
+bool StripedLRU::PutIfAbsentWithTTL(const std::string &key, const std::string &value, uint32_t ttl, uint32_t flags) {
+    return shard(key).PutIfAbsentWithTTL(key, value, ttl, flags);
+}
+
+// See StripedLRU.h
+bool StripedLRU::SetWithTTL(const std::string &key, const std::string &value, uint32_t ttl, uint32_t flags) {
+    return shard(key).SetWithTTL(key, value, ttl, flags);
+}
+
+// See StripedLRU.h
+CasResult StripedLRU::CompareAndSwap(const std::string &key, const std::string &value, uint32_t ttl, uint32_t flags,
+                                     uint64_t cas) {
+    return shard(key).CompareAndSwap(key, value, ttl, flags, cas);
+}
+
+// See StripedLRU.h
+bool StripedLRU::Append(const std::string &key, const std::string &data) { return shard(key).Append(key, data); }
+
+// See StripedLRU.h
+bool StripedLRU::Prepend(const std::string &key, const std::string &data) { return shard(key).Prepend(key, data); }
+
+// See StripedLRU.h
+DeltaResult StripedLRU::Increment(const std::string &key, uint64_t delta, uint64_t &result) {
+    return shard(key).Increment(key, delta, result);
+}
+
+// See StripedLRU.h
+DeltaResult StripedLRU::Decrement(const std::string &key, uint64_t delta, uint64_t &result) {
+    return shard(key).Decrement(key, delta, result);
+}
+
+// See StripedLRU.h
+bool StripedLRU::EvictionCandidate(const std::string &key, const std::string &value, std::string &victim) {
+    return shard(key).EvictionCandidate(key, value, victim);
+}
+
+// See StripedLRU.h
+void StripedLRU::Stats(std::map<std::string, std::string> &stats) {
+    std::map<std::string, uint64_t> totals;
+    for (auto &shard : _shards) {
+        std::map<std::string, std::string> shard_stats;
+        shard->Stats(shard_stats);
+        for (auto &stat : shard_stats) {
+            totals[stat.first] += std::stoull(stat.second);
+        }
+    }
+    for (auto &total : totals) {
+        stats[total.first] = std::to_string(total.second);
+    }
+}
+
+} // namespace Backend
+} // namespace Afina
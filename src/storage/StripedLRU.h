@@ -0,0 +1,113 @@
+#ifndef AFINA_STORAGE_STRIPED_LRU_H
+#define AFINA_STORAGE_STRIPED_LRU_H
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <afina/Storage.h>
+
+#include "ThreadSafeSimpleLRU.h"
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # Lock striped LRU
+ * Keys are hash partitioned across a number of independent ThreadSafeSimplLRU shards, each has
+ * its own lock and equal part of the total byte budget. Operations on different shards never
+ * contend with each other, so throughput scales with number of workers instead of being bound
+ * by a single global lock.
+ *
+ * LRU order is maintained per shard, so eviction is approximate on the whole cache level
+ */
+class StripedLRU : public Afina::Storage {
+public:
+    /**
+     * @param max_size total number of bytes could be stored in all shards
+     * @param n_stripes number of shards, each gets max_size / n_stripes bytes
+     */
+    StripedLRU(size_t max_size = 1024 * 16, size_t n_stripes = 16);
+    ~StripedLRU() {}
+
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Delete(const std::string &key) override;
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool GetView(const std::string &key, ValueView &value) override;
+
+    // Implements Afina::Storage interface, keys are grouped by shard so each shard lock is taken once
+    void MultiGet(const std::vector<std::string> &keys, std::vector<ValueView> &values) override;
+
+    // Implements Afina::Storage interface, same grouping as MultiGet
+    void MultiGetWithInfo(const std::vector<std::string> &keys, std::vector<ValueView> &values,
+                          std::vector<ValueInfo> &infos) override;
+
+    // Implements Afina::Storage interface, keys are grouped by shard so each shard lock is taken once
+    bool MultiPut(const std::vector<std::string> &keys, const std::vector<std::string> &values) override;
+
+    // Implements Afina::Storage interface
+    bool PutWithTTL(const std::string &key, const std::string &value, uint32_t ttl, uint32_t flags) override;
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsentWithTTL(const std::string &key, const std::string &value, uint32_t ttl, uint32_t flags) override;
+
+    // Implements Afina::Storage interface
+    bool SetWithTTL(const std::string &key, const std::string &value, uint32_t ttl, uint32_t flags) override;
+
+    // Implements Afina::Storage interface
+    CasResult CompareAndSwap(const std::string &key, const std::string &value, uint32_t ttl, uint32_t flags,
+                             uint64_t cas) override;
+
+    // Implements Afina::Storage interface
+    bool Append(const std::string &key, const std::string &data) override;
+
+    // Implements Afina::Storage interface
+    bool Prepend(const std::string &key, const std::string &data) override;
+
+    // Implements Afina::Storage interface
+    DeltaResult Increment(const std::string &key, uint64_t delta, uint64_t &result) override;
+
+    // Implements Afina::Storage interface
+    DeltaResult Decrement(const std::string &key, uint64_t delta, uint64_t &result) override;
+
+    // Implements Afina::Storage interface, victim comes from the shard that owns the key
+    bool EvictionCandidate(const std::string &key, const std::string &value, std::string &victim) override;
+
+    // Implements Afina::Storage interface, totals over all shards
+    void Stats(std::map<std::string, std::string> &stats) override;
+
+private:
+    // Returns shard that owns given key
+    ThreadSafeSimplLRU &shard(const std::string &key);
+    // Index of the shard that owns given key
+    size_t shard_index(const std::string &key);
+
+    // Orders key indices so that keys of the same shard go together: keys of shard s are
+    // order[offsets[s]] ... order[offsets[s + 1] - 1]
+    void group(const std::vector<std::string> &keys, std::vector<size_t> &order, std::vector<size_t> &offsets);
+
+    std::hash<std::string> _hash;
+
+    // Shards, never changed after construction
+    std::vector<std::unique_ptr<ThreadSafeSimplLRU>> _shards;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_STRIPED_LRU_H
@@ -0,0 +1,141 @@
+#ifndef AFINA_STORAGE_THREAD_SAFE_CLOCK_LRU_H
+#define AFINA_STORAGE_THREAD_SAFE_CLOCK_LRU_H
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <afina/concurrency/SharedMutex.h>
+
+#include "ClockLRU.h"
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # ClockLRU thread safe version
+ * Readers share the lock since cache hit only sets atomic reference bit, writers are exclusive
+ */
+class ThreadSafeClockLRU : public ClockLRU {
+public:
+    ThreadSafeClockLRU(size_t max_size = 1024, Clock clock = steady_seconds) : ClockLRU(max_size, clock) {}
+    ~ThreadSafeClockLRU() {}
+
+    // see ClockLRU.h
+    bool Put(const std::string &key, const std::string &value) override {
+        std::lock_guard<Concurrency::SharedMutex> lock(_lock);
+        return ClockLRU::Put(key, value);
+    }
+
+    // see ClockLRU.h
+    bool PutIfAbsent(const std::string &key, const std::string &value) override {
+        std::lock_guard<Concurrency::SharedMutex> lock(_lock);
+        return ClockLRU::PutIfAbsent(key, value);
+    }
+
+    // see ClockLRU.h
+    bool Set(const std::string &key, const std::string &value) override {
+        std::lock_guard<Concurrency::SharedMutex> lock(_lock);
+        return ClockLRU::Set(key, value);
+    }
+
+    // see ClockLRU.h
+    bool Delete(const std::string &key) override {
+        std::lock_guard<Concurrency::SharedMutex> lock(_lock);
+        return ClockLRU::Delete(key);
+    }
+
+    // see ClockLRU.h
+    bool Get(const std::string &key, std::string &value) override {
+        Concurrency::SharedLock lock(_lock);
+        return ClockLRU::Get(key, value);
+    }
+
+    // see ClockLRU.h
+    bool GetView(const std::string &key, ValueView &value) override {
+        Concurrency::SharedLock lock(_lock);
+        return ClockLRU::GetView(key, value);
+    }
+
+    // see ClockLRU.h
+    void MultiGet(const std::vector<std::string> &keys, std::vector<ValueView> &values) override {
+        Concurrency::SharedLock lock(_lock);
+        ClockLRU::MultiGet(keys, values);
+    }
+
+    // see ClockLRU.h
+    void MultiGetWithInfo(const std::vector<std::string> &keys, std::vector<ValueView> &values,
+                          std::vector<ValueInfo> &infos) override {
+        Concurrency::SharedLock lock(_lock);
+        ClockLRU::MultiGetWithInfo(keys, values, infos);
+    }
+
+    // see ClockLRU.h
+    bool PutWithTTL(const std::string &key, const std::string &value, uint32_t ttl, uint32_t flags) override {
+        std::lock_guard<Concurrency::SharedMutex> lock(_lock);
+        return ClockLRU::PutWithTTL(key, value, ttl, flags);
+    }
+
+    // see ClockLRU.h
+    bool PutIfAbsentWithTTL(const std::string &key, const std::string &value, uint32_t ttl, uint32_t flags) override {
+        std::lock_guard<Concurrency::SharedMutex> lock(_lock);
+        return ClockLRU::PutIfAbsentWithTTL(key, value, ttl, flags);
+    }
+
+    // see ClockLRU.h
+    bool SetWithTTL(const std::string &key, const std::string &value, uint32_t ttl, uint32_t flags) override {
+        std::lock_guard<Concurrency::SharedMutex> lock(_lock);
+        return ClockLRU::SetWithTTL(key, value, ttl, flags);
+    }
+
+    // see ClockLRU.h
+    CasResult CompareAndSwap(const std::string &key, const std::string &value, uint32_t ttl, uint32_t flags,
+                             uint64_t cas) override {
+        std::lock_guard<Concurrency::SharedMutex> lock(_lock);
+        return ClockLRU::CompareAndSwap(key, value, ttl, flags, cas);
+    }
+
+    // see ClockLRU.h
+    bool Append(const std::string &key, const std::string &data) override {
+        std::lock_guard<Concurrency::SharedMutex> lock(_lock);
+        return ClockLRU::Append(key, data);
+    }
+
+    // see ClockLRU.h
+    bool Prepend(const std::string &key, const std::string &data) override {
+        std::lock_guard<Concurrency::SharedMutex> lock(_lock);
+        return ClockLRU::Prepend(key, data);
+    }
+
+    // see ClockLRU.h
+    DeltaResult Increment(const std::string &key, uint64_t delta, uint64_t &result) override {
+        std::lock_guard<Concurrency::SharedMutex> lock(_lock);
+        return ClockLRU::Increment(key, delta, result);
+    }
+
+    // see ClockLRU.h
+    DeltaResult Decrement(const std::string &key, uint64_t delta, uint64_t &result) override {
+        std::lock_guard<Concurrency::SharedMutex> lock(_lock);
+        return ClockLRU::Decrement(key, delta, result);
+    }
+
+    // see ClockLRU.h
+    bool EvictionCandidate(const std::string &key, const std::string &value, std::string &victim) override {
+        Concurrency::SharedLock lock(_lock);
+        return ClockLRU::EvictionCandidate(key, value, victim);
+    }
+
+    // see ClockLRU.h
+    void Stats(std::map<std::string, std::string> &stats) override {
+        Concurrency::SharedLock lock(_lock);
+        ClockLRU::Stats(stats);
+    }
+
+private:
+    Concurrency::SharedMutex _lock;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_THREAD_SAFE_CLOCK_LRU_H
@@ -1,9 +1,9 @@
 #ifndef AFINA_STORAGE_THREAD_SAFE_SIMPLE_LRU_H
 #define AFINA_STORAGE_THREAD_SAFE_SIMPLE_LRU_H
 
-#include <map>
 #include <mutex>
 #include <string>
+#include <vector>
 
 #include "SimpleLRU.h"
 
@@ -11,49 +11,155 @@ namespace Afina {
 namespace Backend {
 
 /**
- * # SimpleLRU thread safe version
- *
- *
+ * # SimpleCache thread safe version
+ * Every operation is serialized by a single mutex
  */
-class ThreadSafeSimplLRU : public SimpleLRU {
+template <typename Policy> class ThreadSafeSimpleCache : public SimpleCache<Policy> {
 public:
-    ThreadSafeSimplLRU(size_t max_size = 1024) : SimpleLRU(max_size) {}
-    ~ThreadSafeSimplLRU() {}
+    ThreadSafeSimpleCache(size_t max_size = 1024, Clock clock = steady_seconds)
+        : SimpleCache<Policy>(max_size, clock) {}
+    ~ThreadSafeSimpleCache() {}
 
     // see SimpleLRU.h
     bool Put(const std::string &key, const std::string &value) override {
-        // TODO: sinchronization
-        return SimpleLRU::Put(key, value);
+        std::lock_guard<std::mutex> lock(_lock);
+        return SimpleCache<Policy>::Put(key, value);
     }
 
     // see SimpleLRU.h
     bool PutIfAbsent(const std::string &key, const std::string &value) override {
-        // TODO: sinchronization
-        return SimpleLRU::PutIfAbsent(key, value);
+        std::lock_guard<std::mutex> lock(_lock);
+        return SimpleCache<Policy>::PutIfAbsent(key, value);
     }
 
     // see SimpleLRU.h
     bool Set(const std::string &key, const std::string &value) override {
-        // TODO: sinchronization
-        return SimpleLRU::Set(key, value);
+        std::lock_guard<std::mutex> lock(_lock);
+        return SimpleCache<Policy>::Set(key, value);
     }
 
     // see SimpleLRU.h
     bool Delete(const std::string &key) override {
-        // TODO: sinchronization
-        return SimpleLRU::Delete(key);
+        std::lock_guard<std::mutex> lock(_lock);
+        return SimpleCache<Policy>::Delete(key);
     }
 
     // see SimpleLRU.h
     bool Get(const std::string &key, std::string &value) override {
-        // TODO: sinchronization
-        return SimpleLRU::Get(key, value);
+        std::lock_guard<std::mutex> lock(_lock);
+        return SimpleCache<Policy>::Get(key, value);
+    }
+
+    // see SimpleLRU.h
+    bool GetView(const std::string &key, ValueView &value) override {
+        std::lock_guard<std::mutex> lock(_lock);
+        return SimpleCache<Policy>::GetView(key, value);
+    }
+
+    // see SimpleLRU.h
+    void MultiGet(const std::vector<std::string> &keys, std::vector<ValueView> &values) override {
+        std::lock_guard<std::mutex> lock(_lock);
+        SimpleCache<Policy>::MultiGet(keys, values);
+    }
+
+    // see SimpleLRU.h
+    void MultiGetWithInfo(const std::vector<std::string> &keys, std::vector<ValueView> &values,
+                          std::vector<ValueInfo> &infos) override {
+        std::lock_guard<std::mutex> lock(_lock);
+        SimpleCache<Policy>::MultiGetWithInfo(keys, values, infos);
+    }
+
+    // see SimpleLRU.h
+    bool MultiPut(const std::vector<std::string> &keys, const std::vector<std::string> &values) override {
+        std::lock_guard<std::mutex> lock(_lock);
+        return SimpleCache<Policy>::MultiPut(keys, values);
+    }
+
+    // see SimpleLRU.h
+    void GetBatch(const std::vector<std::string> &keys, const size_t *indices, size_t count,
+                  std::vector<ValueView> &values, ValueInfo *infos) override {
+        std::lock_guard<std::mutex> lock(_lock);
+        SimpleCache<Policy>::GetBatch(keys, indices, count, values, infos);
+    }
+
+    // see SimpleLRU.h
+    bool PutBatch(const std::vector<std::string> &keys, const std::vector<std::string> &values, const size_t *indices,
+                  size_t count) override {
+        std::lock_guard<std::mutex> lock(_lock);
+        return SimpleCache<Policy>::PutBatch(keys, values, indices, count);
+    }
+
+    // see SimpleLRU.h
+    bool PutWithTTL(const std::string &key, const std::string &value, uint32_t ttl, uint32_t flags) override {
+        std::lock_guard<std::mutex> lock(_lock);
+        return SimpleCache<Policy>::PutWithTTL(key, value, ttl, flags);
+    }
+
+    // see SimpleLRU.h
+    bool PutIfAbsentWithTTL(const std::string &key, const std::string &value, uint32_t ttl, uint32_t flags) override {
+        std::lock_guard<std::mutex> lock(_lock);
+        return SimpleCache<Policy>::PutIfAbsentWithTTL(key, value, ttl, flags);
+    }
+
+    // see SimpleLRU.h
+    bool SetWithTTL(const std::string &key, const std::string &value, uint32_t ttl, uint32_t flags) override {
+        std::lock_guard<std::mutex> lock(_lock);
+        return SimpleCache<Policy>::SetWithTTL(key, value, ttl, flags);
+    }
+
+    // see SimpleLRU.h
+    CasResult CompareAndSwap(const std::string &key, const std::string &value, uint32_t ttl, uint32_t flags,
+                             uint64_t cas) override {
+        std::lock_guard<std::mutex> lock(_lock);
+        return SimpleCache<Policy>::CompareAndSwap(key, value, ttl, flags, cas);
+    }
+
+    // see SimpleLRU.h
+    bool Append(const std::string &key, const std::string &data) override {
+        std::lock_guard<std::mutex> lock(_lock);
+        return SimpleCache<Policy>::Append(key, data);
+    }
+
+    // see SimpleLRU.h
+    bool Prepend(const std::string &key, const std::string &data) override {
+        std::lock_guard<std::mutex> lock(_lock);
+        return SimpleCache<Policy>::Prepend(key, data);
+    }
+
+    // see SimpleLRU.h
+    DeltaResult Increment(const std::string &key, uint64_t delta, uint64_t &result) override {
+        std::lock_guard<std::mutex> lock(_lock);
+        return SimpleCache<Policy>::Increment(key, delta, result);
+    }
+
+    // see SimpleLRU.h
+    DeltaResult Decrement(const std::string &key, uint64_t delta, uint64_t &result) override {
+        std::lock_guard<std::mutex> lock(_lock);
+        return SimpleCache<Policy>::Decrement(key, delta, result);
+    }
+
+    // see SimpleLRU.h
+    bool EvictionCandidate(const std::string &key, const std::string &value, std::string &victim) override {
+        std::lock_guard<std::mutex> lock(_lock);
+        return SimpleCache<Policy>::EvictionCandidate(key, value, victim);
+    }
+
+    // see SimpleLRU.h
+    void Stats(std::map<std::string, std::string> &stats) override {
+        std::lock_guard<std::mutex> lock(_lock);
+        SimpleCache<Policy>::Stats(stats);
     }
 
 private:
-    // TODO: sinchronization primitives
+    // Guards whole underlying cache, Get mutates policy state as well so it takes the same lock
+    std::mutex _lock;
 };
 
+using ThreadSafeSimplLRU = ThreadSafeSimpleCache<LRUPolicy>;
+using ThreadSafeSimpleSLRU = ThreadSafeSimpleCache<SLRUPolicy>;
+using ThreadSafeSimpleARC = ThreadSafeSimpleCache<ARCPolicy>;
+using ThreadSafeSimpleLFU = ThreadSafeSimpleCache<LFUPolicy>;
+
 } // namespace Backend
 } // namespace Afina
 
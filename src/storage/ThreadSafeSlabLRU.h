@@ -0,0 +1,195 @@
+#ifndef AFINA_STORAGE_THREAD_SAFE_SLAB_LRU_H
+#define AFINA_STORAGE_THREAD_SAFE_SLAB_LRU_H
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "SlabLRU.h"
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # SlabLRU thread safe version
+ * Every operation is serialized by a single mutex. Start prefaults the region, then until Stop background
+ * thread moves slab pages between classes, running Rebalance once per interval
+ */
+class ThreadSafeSlabLRU : public SlabLRU {
+public:
+    ThreadSafeSlabLRU(size_t max_size = 64 << 20, double factor = 1.25, Clock clock = steady_seconds,
+                      std::chrono::milliseconds interval = std::chrono::seconds(1),
+                      Allocator::HugePages huge_pages = Allocator::HugePages::None)
+        : SlabLRU(max_size, factor, clock, huge_pages), _interval(interval), _running(false) {}
+    ~ThreadSafeSlabLRU() { ThreadSafeSlabLRU::Stop(); }
+
+    // Prefaults the region and starts rebalancer
+    void Start() override {
+        {
+            std::lock_guard<std::mutex> lock(_lock);
+            SlabLRU::Start();
+        }
+        std::lock_guard<std::mutex> lock(_rebalancer_lock);
+        if (!_running) {
+            _running = true;
+            _rebalancer = std::thread(&ThreadSafeSlabLRU::OnRun, this);
+        }
+    }
+
+    // Stops rebalancer and waits for it
+    void Stop() override {
+        {
+            std::lock_guard<std::mutex> lock(_rebalancer_lock);
+            _running = false;
+        }
+        _wakeup.notify_all();
+        if (_rebalancer.joinable()) {
+            _rebalancer.join();
+        }
+    }
+
+    // see SlabLRU.h
+    bool Rebalance() override {
+        std::lock_guard<std::mutex> lock(_lock);
+        return SlabLRU::Rebalance();
+    }
+
+    // see SlabLRU.h
+    bool Put(const std::string &key, const std::string &value) override {
+        std::lock_guard<std::mutex> lock(_lock);
+        return SlabLRU::Put(key, value);
+    }
+
+    // see SlabLRU.h
+    bool PutIfAbsent(const std::string &key, const std::string &value) override {
+        std::lock_guard<std::mutex> lock(_lock);
+        return SlabLRU::PutIfAbsent(key, value);
+    }
+
+    // see SlabLRU.h
+    bool Set(const std::string &key, const std::string &value) override {
+        std::lock_guard<std::mutex> lock(_lock);
+        return SlabLRU::Set(key, value);
+    }
+
+    // see SlabLRU.h
+    bool Delete(const std::string &key) override {
+        std::lock_guard<std::mutex> lock(_lock);
+        return SlabLRU::Delete(key);
+    }
+
+    // see SlabLRU.h
+    bool Get(const std::string &key, std::string &value) override {
+        std::lock_guard<std::mutex> lock(_lock);
+        return SlabLRU::Get(key, value);
+    }
+
+    // see SlabLRU.h
+    bool GetView(const std::string &key, ValueView &value) override {
+        std::lock_guard<std::mutex> lock(_lock);
+        return SlabLRU::GetView(key, value);
+    }
+
+    // see SlabLRU.h
+    void MultiGet(const std::vector<std::string> &keys, std::vector<ValueView> &values) override {
+        std::lock_guard<std::mutex> lock(_lock);
+        SlabLRU::MultiGet(keys, values);
+    }
+
+    // see SlabLRU.h
+    void MultiGetWithInfo(const std::vector<std::string> &keys, std::vector<ValueView> &values,
+                          std::vector<ValueInfo> &infos) override {
+        std::lock_guard<std::mutex> lock(_lock);
+        SlabLRU::MultiGetWithInfo(keys, values, infos);
+    }
+
+    // see SlabLRU.h
+    bool PutWithTTL(const std::string &key, const std::string &value, uint32_t ttl, uint32_t flags) override {
+        std::lock_guard<std::mutex> lock(_lock);
+        return SlabLRU::PutWithTTL(key, value, ttl, flags);
+    }
+
+    // see SlabLRU.h
+    bool PutIfAbsentWithTTL(const std::string &key, const std::string &value, uint32_t ttl, uint32_t flags) override {
+        std::lock_guard<std::mutex> lock(_lock);
+        return SlabLRU::PutIfAbsentWithTTL(key, value, ttl, flags);
+    }
+
+    // see SlabLRU.h
+    bool SetWithTTL(const std::string &key, const std::string &value, uint32_t ttl, uint32_t flags) override {
+        std::lock_guard<std::mutex> lock(_lock);
+        return SlabLRU::SetWithTTL(key, value, ttl, flags);
+    }
+
+    // see SlabLRU.h
+    CasResult CompareAndSwap(const std::string &key, const std::string &value, uint32_t ttl, uint32_t flags,
+                             uint64_t cas) override {
+        std::lock_guard<std::mutex> lock(_lock);
+        return SlabLRU::CompareAndSwap(key, value, ttl, flags, cas);
+    }
+
+    // see SlabLRU.h
+    bool Append(const std::string &key, const std::string &data) override {
+        std::lock_guard<std::mutex> lock(_lock);
+        return SlabLRU::Append(key, data);
+    }
+
+    // see SlabLRU.h
+    bool Prepend(const std::string &key, const std::string &data) override {
+        std::lock_guard<std::mutex> lock(_lock);
+        return SlabLRU::Prepend(key, data);
+    }
+
+    // see SlabLRU.h
+    DeltaResult Increment(const std::string &key, uint64_t delta, uint64_t &result) override {
+        std::lock_guard<std::mutex> lock(_lock);
+        return SlabLRU::Increment(key, delta, result);
+    }
+
+    // see SlabLRU.h
+    DeltaResult Decrement(const std::string &key, uint64_t delta, uint64_t &result) override {
+        std::lock_guard<std::mutex> lock(_lock);
+        return SlabLRU::Decrement(key, delta, result);
+    }
+
+    // see SlabLRU.h
+    bool EvictionCandidate(const std::string &key, const std::string &value, std::string &victim) override {
+        std::lock_guard<std::mutex> lock(_lock);
+        return SlabLRU::EvictionCandidate(key, value, victim);
+    }
+
+    // see SlabLRU.h
+    void Stats(std::map<std::string, std::string> &stats) override {
+        std::lock_guard<std::mutex> lock(_lock);
+        SlabLRU::Stats(stats);
+    }
+
+private:
+    // Rebalancer thread body
+    void OnRun() {
+        std::unique_lock<std::mutex> lock(_rebalancer_lock);
+        while (!_wakeup.wait_for(lock, _interval, [this] { return !_running; })) {
+            lock.unlock();
+            Rebalance();
+            lock.lock();
+        }
+    }
+
+    // Guards whole underlying cache, Get moves item in its class list so it takes the same lock
+    std::mutex _lock;
+
+    // Rebalancer state, guarded by its own lock so that Stop doesn't wait for cache operations
+    const std::chrono::milliseconds _interval;
+    std::mutex _rebalancer_lock;
+    std::condition_variable _wakeup;
+    bool _running;
+    std::thread _rebalancer;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_THREAD_SAFE_SLAB_LRU_H
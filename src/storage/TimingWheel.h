@@ -0,0 +1,167 @@
+#ifndef AFINA_STORAGE_TIMING_WHEEL_H
+#define AFINA_STORAGE_TIMING_WHEEL_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include "Item.h"
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * Source of time for item expiration: seconds of some monotonic clock, never 0
+ */
+using Clock = uint32_t (*)();
+
+/**
+ * Default Clock: seconds of std::chrono::steady_clock
+ */
+inline uint32_t steady_seconds() {
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::seconds>(now).count()) + 1;
+}
+
+/**
+ * Deadline of item living ttl seconds from now, 0 if ttl is 0, i.e item never expires
+ */
+inline uint32_t expire_time(uint32_t now, uint32_t ttl) {
+    if (ttl == 0) {
+        return 0;
+    }
+    return (now + ttl < now) ? UINT32_MAX : now + ttl;
+}
+
+/**
+ * # Hierarchical timing wheel
+ * Tracks items having Item::expire set. Level 0 has a slot per second for the next 64 seconds, every
+ * next level has 64 slots 64 times wider than the previous one, so 4 levels cover 194 days. Item is
+ * linked into a slot intrusively through Item::timer_next/timer_pprev, so schedule and cancel are O(1).
+ *
+ * Wheel moves one second at a time: items of the current level 0 slot are due, and whenever a lower
+ * level wraps around, the next slot of the upper one is cascaded down. Every item is touched at most
+ * once per level, so expiration costs O(1) per item and never scans the keyspace.
+ *
+ * Wheel doesn't own items
+ */
+class TimingWheel {
+public:
+    TimingWheel(uint32_t now) : _now(now), _size(0) {
+        for (auto &level : _slots) {
+            for (auto &slot : level) {
+                slot = nullptr;
+            }
+        }
+    }
+
+    // Links item into the wheel according to item->expire, which must not be 0
+    void Schedule(Item *item) {
+        // Slot of the current second is reported already, so anything due goes to the next one
+        link(item, item->expire > _now ? item->expire : _now + 1);
+        _size++;
+    }
+
+    // Unlinks item scheduled before
+    void Cancel(Item *item) {
+        *item->timer_pprev = item->timer_next;
+        if (item->timer_next != nullptr) {
+            item->timer_next->timer_pprev = item->timer_pprev;
+        }
+        item->timer_next = nullptr;
+        item->timer_pprev = nullptr;
+        _size--;
+    }
+
+    /**
+     * Moves wheel forward up to the given time, calls expired(Item *) for every item which deadline
+     * is passed. Items are unlinked from the wheel before callback is called
+     */
+    template <typename F> void Advance(uint32_t now, F expired) {
+        while (_now < now) {
+            if (_size == 0) {
+                // Nothing to report, just catch up
+                _now = now;
+                return;
+            }
+
+            _now++;
+            for (int level = 1; level < kLevels && (_now & ((uint32_t(1) << (kBits * level)) - 1)) == 0; level++) {
+                cascade(level, (_now >> (kBits * level)) & kMask);
+            }
+
+            Item *item = take(_slots[0][_now & kMask]);
+            while (item != nullptr) {
+                Item *next = item->timer_next;
+                item->timer_next = nullptr;
+                item->timer_pprev = nullptr;
+                _size--;
+                expired(item);
+                item = next;
+            }
+        }
+    }
+
+    uint32_t now() const { return _now; }
+
+    // Number of scheduled items
+    size_t size() const { return _size; }
+
+private:
+    static constexpr int kLevels = 4;
+    static constexpr int kBits = 6;
+    static constexpr uint32_t kMask = (1 << kBits) - 1;
+
+    // Detaches the whole slot list
+    static Item *take(Item *&head) {
+        Item *list = head;
+        head = nullptr;
+        return list;
+    }
+
+    // Links item into the slot of the given deadline, which is not in the past
+    void link(Item *item, uint32_t expire) {
+        uint64_t delta = expire - _now;
+        int level = 0;
+        while (level < kLevels - 1 && delta >= (uint64_t(1) << (kBits * (level + 1)))) {
+            level++;
+        }
+        if (delta >= (uint64_t(1) << (kBits * kLevels))) {
+            // Beyond wheel range, park in the farthest slot, it gets relinked on cascade
+            expire = _now + (uint32_t(1) << (kBits * kLevels)) - 1;
+        }
+
+        Item *&head = _slots[level][(expire >> (kBits * level)) & kMask];
+        item->timer_pprev = &head;
+        item->timer_next = head;
+        if (head != nullptr) {
+            head->timer_pprev = &item->timer_next;
+        }
+        head = item;
+    }
+
+    // Moves items of the upper level slot down according to their deadlines. Cascade happens right
+    // before slot of the current second is reported, so items due now still make it there
+    void cascade(int level, uint32_t slot) {
+        Item *item = take(_slots[level][slot]);
+        while (item != nullptr) {
+            Item *next = item->timer_next;
+            link(item, item->expire > _now ? item->expire : _now);
+            item = next;
+        }
+    }
+
+    // Current time: every item with deadline up to it is reported already
+    uint32_t _now;
+
+    // Number of items in all slots
+    size_t _size;
+
+    // Heads of slot lists
+    Item *_slots[kLevels][1 << kBits];
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_TIMING_WHEEL_H
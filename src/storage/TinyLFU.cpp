@@ -0,0 +1,276 @@
+#include "TinyLFU.h"
+
+#include "HashIndex.h"
+
+namespace Afina {
+namespace Backend {
+
+// See TinyLFU.h
+bool TinyLFU::update(const std::string &key, const std::string &value, uint32_t ttl, uint32_t flags) {
+    if (_main->SetWithTTL(key, value, ttl, flags)) {
+        return true;
+    }
+    if (key.size() + value.size() <= _window_size) {
+        return _window.SetWithTTL(key, value, ttl, flags);
+    }
+
+    // Value outgrew the window, it has to go into main cache right away
+    return _window.Delete(key) && admit(key, value, ttl, flags);
+}
+
+// See TinyLFU.h
+bool TinyLFU::insert(const std::string &key, const std::string &value, uint32_t ttl, uint32_t flags) {
+    if (key.size() + value.size() > _window_size) {
+        return admit(key, value, ttl, flags);
+    }
+
+    std::string candidate, candidate_value;
+    uint32_t candidate_ttl, candidate_flags;
+    while (_window.EvictionCandidate(key, value, candidate)) {
+        if (_window.Extract(candidate, candidate_value, candidate_ttl, candidate_flags)) {
+            admit(candidate, candidate_value, candidate_ttl, candidate_flags);
+        }
+    }
+    return _window.PutWithTTL(key, value, ttl, flags);
+}
+
+// See TinyLFU.h
+bool TinyLFU::admit(const std::string &key, const std::string &value, uint32_t ttl, uint32_t flags) {
+    std::string victim;
+    if (_main->EvictionCandidate(key, value, victim) &&
+        _sketch.Frequency(hash_key(key)) <= _sketch.Frequency(hash_key(victim))) {
+        _rejected++;
+        return false;
+    }
+    if (!_main->PutWithTTL(key, value, ttl, flags)) {
+        return false;
+    }
+    _admitted++;
+    return true;
+}
+
+// See TinyLFU.h
+bool TinyLFU::concat(const std::string &key, const std::string &data, bool append) {
+    _sketch.Increment(hash_key(key));
+    if (append ? _main->Append(key, data) : _main->Prepend(key, data)) {
+        return true;
+    }
+    if (append ? _window.Append(key, data) : _window.Prepend(key, data)) {
+        return true;
+    }
+
+    // Either there is no such key or value outgrew the window, in the latter case it has to go into
+    // main cache right away
+    std::string value;
+    uint32_t ttl, flags;
+    if (!_window.Extract(key, value, ttl, flags)) {
+        return false;
+    }
+    return admit(key, append ? value + data : data + value, ttl, flags);
+}
+
+// See TinyLFU.h
+bool TinyLFU::Put(const std::string &key, const std::string &value) { return TinyLFU::PutWithTTL(key, value, 0, 0); }
+
+// See TinyLFU.h
+bool TinyLFU::PutIfAbsent(const std::string &key, const std::string &value) {
+    return TinyLFU::PutIfAbsentWithTTL(key, value, 0, 0);
+}
+
+// See TinyLFU.h
+bool TinyLFU::Set(const std::string &key, const std::string &value) { return TinyLFU::SetWithTTL(key, value, 0, 0); }
+
+// See TinyLFU.h
+bool TinyLFU::Delete(const std::string &key) {
+    std::lock_guard<std::mutex> lock(_lock);
+    bool in_window = _window.Delete(key);
+    bool in_main = _main->Delete(key);
+    return in_window || in_main;
+}
+
+// See TinyLFU.h
+bool TinyLFU::Get(const std::string &key, std::string &value) {
+    _sketch.Increment(hash_key(key));
+    if (_main->Get(key, value)) {
+        return true;
+    }
+    std::lock_guard<std::mutex> lock(_lock);
+    return _window.Get(key, value) || _main->Get(key, value);
+}
+
+// See TinyLFU.h
+bool TinyLFU::GetView(const std::string &key, ValueView &value) {
+    _sketch.Increment(hash_key(key));
+    if (_main->GetView(key, value)) {
+        return true;
+    }
+    std::lock_guard<std::mutex> lock(_lock);
+    return _window.GetView(key, value) || _main->GetView(key, value);
+}
+
+// See TinyLFU.h
+void TinyLFU::MultiGet(const std::vector<std::string> &keys, std::vector<ValueView> &values) {
+    for (auto &key : keys) {
+        _sketch.Increment(hash_key(key));
+    }
+    _main->MultiGet(keys, values);
+
+    std::unique_lock<std::mutex> lock(_lock, std::defer_lock);
+    for (size_t i = 0; i < keys.size(); i++) {
+        if (values[i].data() != nullptr) {
+            continue;
+        }
+        if (!lock.owns_lock()) {
+            lock.lock();
+        }
+        if (!_window.GetView(keys[i], values[i])) {
+            _main->GetView(keys[i], values[i]);
+        }
+    }
+}
+
+// See TinyLFU.h
+void TinyLFU::MultiGetWithInfo(const std::vector<std::string> &keys, std::vector<ValueView> &values,
+                               std::vector<ValueInfo> &infos) {
+    for (auto &key : keys) {
+        _sketch.Increment(hash_key(key));
+    }
+    _main->MultiGetWithInfo(keys, values, infos);
+
+    std::vector<std::string> missed;
+    std::vector<size_t> positions;
+    for (size_t i = 0; i < keys.size(); i++) {
+        if (values[i].data() == nullptr) {
+            missed.push_back(keys[i]);
+            positions.push_back(i);
+        }
+    }
+    if (missed.empty()) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_lock);
+    std::vector<ValueView> found;
+    std::vector<ValueInfo> found_infos;
+    _window.MultiGetWithInfo(missed, found, found_infos);
+
+    // Keys missed by the window could be admitted into main cache since the first look
+    std::vector<std::string> again;
+    std::vector<size_t> again_positions;
+    for (size_t j = 0; j < missed.size(); j++) {
+        if (found[j].data() == nullptr) {
+            again.push_back(missed[j]);
+            again_positions.push_back(positions[j]);
+        } else {
+            values[positions[j]] = std::move(found[j]);
+            infos[positions[j]] = found_infos[j];
+        }
+    }
+    if (again.empty()) {
+        return;
+    }
+    _main->MultiGetWithInfo(again, found, found_infos);
+    for (size_t j = 0; j < again.size(); j++) {
+        values[again_positions[j]] = std::move(found[j]);
+        infos[again_positions[j]] = found_infos[j];
+    }
+}
+
+// See TinyLFU.h
+bool TinyLFU::PutWithTTL(const std::string &key, const std::string &value, uint32_t ttl, uint32_t flags) {
+    std::lock_guard<std::mutex> lock(_lock);
+    _sketch.Increment(hash_key(key));
+    if (update(key, value, ttl, flags)) {
+        return true;
+    }
+    return insert(key, value, ttl, flags);
+}
+
+// See TinyLFU.h
+bool TinyLFU::PutIfAbsentWithTTL(const std::string &key, const std::string &value, uint32_t ttl,
+                                 uint32_t flags) {
+    std::lock_guard<std::mutex> lock(_lock);
+    _sketch.Increment(hash_key(key));
+    std::string current;
+    if (_window.Get(key, current) || _main->Get(key, current)) {
+        return false;
+    }
+    return insert(key, value, ttl, flags);
+}
+
+// See TinyLFU.h
+bool TinyLFU::SetWithTTL(const std::string &key, const std::string &value, uint32_t ttl, uint32_t flags) {
+    std::lock_guard<std::mutex> lock(_lock);
+    _sketch.Increment(hash_key(key));
+    return update(key, value, ttl, flags);
+}
+
+// See TinyLFU.h
+CasResult TinyLFU::CompareAndSwap(const std::string &key, const std::string &value, uint32_t ttl, uint32_t flags,
+                                  uint64_t cas) {
+    std::lock_guard<std::mutex> lock(_lock);
+    _sketch.Increment(hash_key(key));
+    CasResult result = _main->CompareAndSwap(key, value, ttl, flags, cas);
+    if (result != CasResult::NotFound) {
+        return result;
+    }
+    if (key.size() + value.size() <= _window_size) {
+        return _window.CompareAndSwap(key, value, ttl, flags, cas);
+    }
+
+    // Value outgrew the window, it has to go into main cache right away if version matches
+    std::vector<ValueView> current;
+    std::vector<ValueInfo> infos;
+    _window.MultiGetWithInfo({key}, current, infos);
+    if (current[0].data() == nullptr) {
+        return CasResult::NotFound;
+    }
+    if (infos[0].cas != cas) {
+        return CasResult::Exists;
+    }
+    current.clear();
+    return (_window.Delete(key) && admit(key, value, ttl, flags)) ? CasResult::Stored : CasResult::NotStored;
+}
+
+// See TinyLFU.h
+bool TinyLFU::Append(const std::string &key, const std::string &data) {
+    std::lock_guard<std::mutex> lock(_lock);
+    return concat(key, data, true);
+}
+
+// See TinyLFU.h
+bool TinyLFU::Prepend(const std::string &key, const std::string &data) {
+    std::lock_guard<std::mutex> lock(_lock);
+    return concat(key, data, false);
+}
+
+// See TinyLFU.h
+DeltaResult TinyLFU::Increment(const std::string &key, uint64_t delta, uint64_t &result) {
+    std::lock_guard<std::mutex> lock(_lock);
+    _sketch.Increment(hash_key(key));
+    DeltaResult found = _main->Increment(key, delta, result);
+    return (found != DeltaResult::NotFound) ? found : _window.Increment(key, delta, result);
+}
+
+// See TinyLFU.h
+DeltaResult TinyLFU::Decrement(const std::string &key, uint64_t delta, uint64_t &result) {
+    std::lock_guard<std::mutex> lock(_lock);
+    _sketch.Increment(hash_key(key));
+    DeltaResult found = _main->Decrement(key, delta, result);
+    return (found != DeltaResult::NotFound) ? found : _window.Decrement(key, delta, result);
+}
+
+// See TinyLFU.h
+void TinyLFU::Stats(std::map<std::string, std::string> &stats) {
+    std::lock_guard<std::mutex> lock(_lock);
+    _main->Stats(stats);
+
+    std::map<std::string, std::string> window;
+    _window.Stats(window);
+    stats["tinylfu_window_items"] = window["curr_items"];
+    stats["tinylfu_admitted"] = std::to_string(_admitted);
+    stats["tinylfu_rejected"] = std::to_string(_rejected);
+}
+
+} // namespace Backend
+} // namespace Afina
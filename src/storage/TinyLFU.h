@@ -0,0 +1,139 @@
+#ifndef AFINA_STORAGE_TINY_LFU_H
+#define AFINA_STORAGE_TINY_LFU_H
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <afina/Storage.h>
+
+#include "FrequencySketch.h"
+#include "SimpleLRU.h"
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # W-TinyLFU admission filter
+ * Wraps any storage (main cache) and decides whether new key is worth a place there. New keys land
+ * in a small LRU window first. Key pushed out of the window is admitted into main cache only if its
+ * estimated frequency is higher than the frequency of the item main cache would evict for it,
+ * otherwise it is dropped. Frequencies are tracked by FrequencySketch over every access, including
+ * accesses to keys that aren't resident.
+ *
+ * So one-time keys of a scan pass through the window and never flush popular items out of the main
+ * cache, while the window still lets bursts of new keys get hits right away.
+ *
+ * Main cache must report eviction victims (see Storage::EvictionCandidate), otherwise every key is
+ * admitted. Sketch is lock free and reads look up main cache without any lock of the filter, so readers
+ * scale as well as main cache does. Writes, window and admission are serialized by a single mutex: key
+ * moves between window and main cache under it only, so read that misses main cache takes it to look
+ * into the window and then into main cache once again. Main cache must be thread safe if the filter is
+ * used from several threads, and is expected to be accessed through the filter only.
+ */
+class TinyLFU : public Afina::Storage {
+public:
+    /**
+     * @param main storage to filter admissions to
+     * @param window_size number of bytes in the window, few percent of the main cache is enough,
+     *                    default is sized for storages with default budget
+     * @param expected_items number of keys frequency sketch is sized for
+     */
+    TinyLFU(std::shared_ptr<Afina::Storage> main, size_t window_size = 128, size_t expected_items = 1024)
+        : _main(main), _window_size(window_size), _window(window_size), _sketch(expected_items), _admitted(0),
+          _rejected(0) {}
+    ~TinyLFU() {}
+
+    // Implements Afina::Storage interface
+    void Start() override { _main->Start(); }
+
+    // Implements Afina::Storage interface
+    void Stop() override { _main->Stop(); }
+
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Delete(const std::string &key) override;
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool GetView(const std::string &key, ValueView &value) override;
+
+    // Implements Afina::Storage interface, misses of main cache are done under lock taken once
+    void MultiGet(const std::vector<std::string> &keys, std::vector<ValueView> &values) override;
+
+    // Implements Afina::Storage interface, misses of main cache are done under lock taken once
+    void MultiGetWithInfo(const std::vector<std::string> &keys, std::vector<ValueView> &values,
+                          std::vector<ValueInfo> &infos) override;
+
+    // Implements Afina::Storage interface
+    bool PutWithTTL(const std::string &key, const std::string &value, uint32_t ttl, uint32_t flags) override;
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsentWithTTL(const std::string &key, const std::string &value, uint32_t ttl,
+                            uint32_t flags) override;
+
+    // Implements Afina::Storage interface
+    bool SetWithTTL(const std::string &key, const std::string &value, uint32_t ttl, uint32_t flags) override;
+
+    // Implements Afina::Storage interface
+    CasResult CompareAndSwap(const std::string &key, const std::string &value, uint32_t ttl, uint32_t flags,
+                             uint64_t cas) override;
+
+    // Implements Afina::Storage interface
+    bool Append(const std::string &key, const std::string &data) override;
+
+    // Implements Afina::Storage interface
+    bool Prepend(const std::string &key, const std::string &data) override;
+
+    // Implements Afina::Storage interface
+    DeltaResult Increment(const std::string &key, uint64_t delta, uint64_t &result) override;
+
+    // Implements Afina::Storage interface
+    DeltaResult Decrement(const std::string &key, uint64_t delta, uint64_t &result) override;
+
+    // Implements Afina::Storage interface, adds admission counters to the main cache statistics
+    void Stats(std::map<std::string, std::string> &stats) override;
+
+private:
+    // Stores new value for the key that is resident either in window or main cache, returns false
+    // if key isn't found
+    bool update(const std::string &key, const std::string &value, uint32_t ttl, uint32_t flags);
+    // Places new key into the window, keys pushed out of it go through admission
+    bool insert(const std::string &key, const std::string &value, uint32_t ttl, uint32_t flags);
+    // Moves pair into the main cache if it is more popular than the main cache victim
+    bool admit(const std::string &key, const std::string &value, uint32_t ttl, uint32_t flags);
+    // Adds data to the value of the key resident either in window or main cache
+    bool concat(const std::string &key, const std::string &data, bool append);
+
+    // Guards window and admission counters
+    std::mutex _lock;
+
+    std::shared_ptr<Afina::Storage> _main;
+
+    const size_t _window_size;
+    SimpleLRU _window;
+
+    FrequencySketch _sketch;
+
+    // Admission decisions made
+    uint64_t _admitted;
+    uint64_t _rejected;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_TINY_LFU_H
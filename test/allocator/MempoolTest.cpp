@@ -0,0 +1,184 @@
+#include "gtest/gtest.h"
+#include <atomic>
+#include <cstring>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include <afina/allocator/Arena.h>
+#include <afina/allocator/Error.h>
+#include <afina/allocator/Mempool.h>
+#include <afina/allocator/SlabCache.h>
+
+using namespace std;
+using namespace Afina::Allocator;
+
+// Eight whole slabs after alignment
+static vector<char> area(9 * Arena::kSlabSize);
+
+TEST(MempoolTest, ArenaTakePut) {
+    Arena arena(area.data(), area.size());
+    EXPECT_EQ(8, arena.slabs());
+
+    set<void *> slabs;
+    while (void *slab = arena.take()) {
+        EXPECT_EQ(slab, Arena::slab_of(static_cast<char *>(slab) + 100));
+        EXPECT_GE(static_cast<char *>(slab), area.data());
+        EXPECT_LE(static_cast<char *>(slab) + Arena::kSlabSize, area.data() + area.size());
+        slabs.insert(slab);
+    }
+    EXPECT_EQ(8, slabs.size());
+    EXPECT_EQ(8, arena.used());
+
+    arena.put(*slabs.begin());
+    EXPECT_EQ(*slabs.begin(), arena.take());
+    EXPECT_EQ(nullptr, arena.take());
+    for (void *slab : slabs) {
+        arena.put(slab);
+    }
+    EXPECT_EQ(0, arena.used());
+}
+
+TEST(MempoolTest, AllocFree) {
+    Arena arena(area.data(), area.size());
+    SlabCache cache(arena, 1);
+    Mempool pool(cache, 100);
+    EXPECT_EQ(112, pool.object_size());
+
+    vector<char *> objects;
+    for (int i = 0; i < 1000; i++) {
+        char *p = static_cast<char *>(pool.alloc());
+        EXPECT_EQ(0, reinterpret_cast<uintptr_t>(p) % 16);
+        std::memset(p, i % 127, 100);
+        objects.push_back(p);
+    }
+    EXPECT_EQ(1000, pool.used());
+    EXPECT_EQ(2, pool.slabs());
+    EXPECT_EQ(set<char *>(objects.begin(), objects.end()).size(), objects.size());
+    for (int i = 0; i < 1000; i++) {
+        EXPECT_EQ(i % 127, objects[i][99]);
+    }
+
+    // Empty slabs go to the cache first, then back to the arena
+    for (char *p : objects) {
+        pool.free(p);
+    }
+    EXPECT_EQ(0, pool.used());
+    EXPECT_EQ(0, pool.slabs());
+    EXPECT_EQ(1, cache.cached());
+    EXPECT_EQ(1, arena.used());
+}
+
+TEST(MempoolTest, LiveSlabsStayOnDestruction) {
+    Arena arena(area.data(), area.size());
+    SlabCache cache(arena, 1);
+
+    char *live;
+    {
+        Mempool pool(cache, 64);
+        live = static_cast<char *>(pool.alloc());
+        std::memset(live, 'l', 64);
+    }
+    EXPECT_EQ(0, cache.cached());
+
+    Mempool other(cache, 64);
+    for (int i = 0; i < 100; i++) {
+        EXPECT_NE(Arena::slab_of(live), Arena::slab_of(other.alloc()));
+    }
+    EXPECT_EQ('l', live[63]);
+}
+
+TEST(MempoolTest, NoMemory) {
+    Arena arena(area.data(), area.size());
+    SlabCache cache(arena);
+    EXPECT_THROW(Mempool(cache, Arena::kSlabSize), AllocError);
+
+    Mempool pool(cache, Arena::kSlabSize / 2);
+    vector<void *> objects;
+    for (int i = 0; i < 8; i++) {
+        objects.push_back(pool.alloc());
+    }
+    EXPECT_EQ(nullptr, pool.try_alloc());
+    EXPECT_THROW(pool.alloc(), AllocError);
+
+    pool.free(objects.back());
+    EXPECT_NE(nullptr, pool.try_alloc());
+}
+
+TEST(MempoolTest, RemoteFree) {
+    Arena arena(area.data(), area.size());
+    SlabCache cache1(arena), cache2(arena);
+    Mempool owner(cache1, 64), other(cache2, 64);
+
+    // Two full slabs, so that the next allocation has nothing at hand
+    size_t per_slab = (Arena::kSlabSize - 64) / 64;
+    vector<void *> objects;
+    for (size_t i = 0; i < 2 * per_slab; i++) {
+        objects.push_back(owner.alloc());
+    }
+    EXPECT_EQ(2, owner.slabs());
+
+    // Foreign objects are not freed until owner needs them
+    std::thread t([&] {
+        for (void *p : objects) {
+            other.free(p);
+        }
+    });
+    t.join();
+    EXPECT_EQ(2 * per_slab, owner.used());
+    EXPECT_EQ(0, other.used());
+
+    void *p = owner.alloc();
+    EXPECT_EQ(1, owner.used());
+    EXPECT_EQ(1, owner.slabs());
+    owner.free(p);
+}
+
+TEST(MempoolTest, ConcurrentRemoteFree) {
+    static vector<char> big(65 * Arena::kSlabSize);
+    Arena arena(big.data(), big.size());
+
+    // Every thread frees objects of its neighbour along with its own ones
+    const int n_threads = 4;
+    const int rounds = 20000;
+    vector<std::atomic<void *>> mailbox(n_threads);
+    for (auto &m : mailbox) {
+        m = nullptr;
+    }
+    std::atomic<int> broken(0);
+
+    vector<std::thread> threads;
+    for (int t = 0; t < n_threads; t++) {
+        threads.emplace_back([&, t] {
+            SlabCache cache(arena);
+            Mempool pool(cache, 32);
+            for (int r = 0; r < rounds; r++) {
+                int *p = static_cast<int *>(pool.alloc());
+                p[0] = t;
+                p[1] = r;
+                p = static_cast<int *>(mailbox[t].exchange(p));
+                pool.free(p);
+
+                int *q = static_cast<int *>(mailbox[(t + 1) % n_threads].exchange(nullptr));
+                if (q != nullptr) {
+                    if (q[0] != (t + 1) % n_threads) {
+                        broken++;
+                    }
+                    pool.free(q);
+                }
+            }
+
+            // Wait for neighbours to stop taking objects of this pool before it is gone
+            pool.free(mailbox[t].exchange(nullptr));
+            while (pool.used() > 0) {
+                pool.collect();
+                std::this_thread::yield();
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+    EXPECT_EQ(0, broken.load());
+    EXPECT_EQ(0, arena.used());
+}
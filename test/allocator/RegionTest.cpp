@@ -0,0 +1,65 @@
+#include "gtest/gtest.h"
+#include <cstdint>
+#include <cstring>
+
+#include <afina/allocator/Region.h>
+
+using namespace Afina::Allocator;
+
+static bool patternOk(const Region &region) {
+    const unsigned char *p = static_cast<const unsigned char *>(region.data());
+    for (size_t i = 0; i < region.size(); i += 4096) {
+        if (p[i] != (i / 4096) % 251) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void writePattern(Region &region) {
+    unsigned char *p = static_cast<unsigned char *>(region.data());
+    for (size_t i = 0; i < region.size(); i += 4096) {
+        p[i] = (i / 4096) % 251;
+    }
+}
+
+TEST(RegionTest, RegularPages) {
+    Region region(10000);
+    EXPECT_EQ(HugePages::None, region.huge_pages());
+    EXPECT_GE(region.size(), 10000);
+    EXPECT_EQ(0, region.size() % 4096);
+
+    writePattern(region);
+    EXPECT_TRUE(patternOk(region));
+}
+
+TEST(RegionTest, HugePagesFallBack) {
+    // Whatever the machine has, region is usable and huge page aligned unless it got regular pages
+    for (HugePages kind : {HugePages::Transparent, HugePages::Explicit}) {
+        Region region(3 * Region::kHugePageSize + 1, kind);
+        EXPECT_GE(region.size(), 3 * Region::kHugePageSize + 1);
+        if (region.huge_pages() != HugePages::None) {
+            EXPECT_EQ(0, reinterpret_cast<uintptr_t>(region.data()) % Region::kHugePageSize);
+            EXPECT_EQ(0, region.size() % Region::kHugePageSize);
+        }
+        writePattern(region);
+        EXPECT_TRUE(patternOk(region));
+    }
+}
+
+TEST(RegionTest, PrefaultKeepsContent) {
+    Region region(9 * Region::kHugePageSize, HugePages::Transparent);
+    writePattern(region);
+
+    region.prefault(4);
+    EXPECT_TRUE(patternOk(region));
+    region.prefault(1);
+    EXPECT_TRUE(patternOk(region));
+
+    // Untouched region comes back zeroed
+    Region fresh(5 * Region::kHugePageSize);
+    fresh.prefault(3);
+    const char *p = static_cast<const char *>(fresh.data());
+    EXPECT_EQ(0, p[0]);
+    EXPECT_EQ(0, p[fresh.size() - 1]);
+}
@@ -1,6 +1,10 @@
 #include "gtest/gtest.h"
+#include <atomic>
+#include <chrono>
+#include <cstring>
 #include <iostream>
 #include <set>
+#include <thread>
 #include <vector>
 
 #include <afina/allocator/Error.h>
@@ -322,3 +326,186 @@ TEST(SimpleTest, ReallocGrow) {
     a.free(p);
     a.free(p2);
 }
+
+TEST(SimpleTest, DefragIncremental) {
+    Simple a(buf, sizeof(buf));
+
+    vector<Pointer> ptrs;
+    int size = 135;
+
+    ASSERT_TRUE(fillUp(a, size, ptrs));
+    vector<Pointer> alive;
+    for (size_t i = 0; i < ptrs.size(); i++) {
+        if (i % 2 == 0) {
+            a.free(ptrs[i]);
+        } else {
+            alive.push_back(ptrs[i]);
+        }
+    }
+
+    // Every step moves at most a few blocks, pointers stay valid between steps
+    int steps = 0;
+    while (!a.defrag(4 * size, std::chrono::microseconds::max())) {
+        steps++;
+        for (Pointer &p : alive) {
+            ASSERT_TRUE(isDataOk(p, size));
+        }
+    }
+    EXPECT_GT(steps, 10);
+
+    Pointer newPtr = a.alloc(sizeof(buf) / 3);
+    writeTo(newPtr, sizeof(buf) / 3);
+
+    for (Pointer &p : alive) {
+        EXPECT_TRUE(isDataOk(p, size));
+        a.free(p);
+    }
+    a.free(newPtr);
+}
+
+TEST(SimpleTest, DefragTimeBudget) {
+    Simple a(buf, sizeof(buf));
+
+    int size = 135;
+    Pointer p1 = a.alloc(size);
+    Pointer p2 = a.alloc(size);
+    Pointer p3 = a.alloc(size);
+    Pointer p4 = a.alloc(size);
+    writeTo(p3, size);
+    writeTo(p4, size);
+    a.free(p1);
+
+    // No time at all still moves one block
+    EXPECT_FALSE(a.defrag(sizeof(buf), std::chrono::microseconds(0)));
+    EXPECT_FALSE(a.defrag(sizeof(buf), std::chrono::microseconds(0)));
+    EXPECT_TRUE(a.defrag(sizeof(buf), std::chrono::microseconds(0)));
+    EXPECT_TRUE(a.defrag(sizeof(buf), std::chrono::microseconds(0)));
+
+    EXPECT_TRUE(isDataOk(p3, size));
+    EXPECT_TRUE(isDataOk(p4, size));
+    a.free(p2);
+    a.free(p3);
+    a.free(p4);
+}
+
+TEST(SimpleTest, StaleHandle) {
+    Simple a(buf, sizeof(buf));
+
+    int size = 100;
+    Pointer p1 = a.alloc(size);
+    Pointer copy = p1;
+    a.free(p1);
+    EXPECT_EQ(p1.get(), nullptr);
+    EXPECT_EQ(copy.get(), nullptr);
+    EXPECT_THROW(a.free(copy), AllocError);
+
+    // Slot is reused by the next block, old handle still sees nothing
+    Pointer p2 = a.alloc(size);
+    writeTo(p2, size);
+    EXPECT_EQ(copy.get(), nullptr);
+
+    char out[100];
+    EXPECT_FALSE(copy.read(out, size));
+    EXPECT_TRUE(p2.read(out, size));
+    EXPECT_THROW(a.free(copy), AllocError);
+    EXPECT_TRUE(isDataOk(p2, size));
+    a.free(p2);
+}
+
+TEST(SimpleTest, ConcurrentRead) {
+    Simple a(buf, sizeof(buf));
+
+    int size = 200;
+    vector<Pointer> ptrs;
+    for (int i = 0; i < 100; i++) {
+        ptrs.push_back(a.alloc(size));
+        writeTo(ptrs.back(), size);
+    }
+    Pointer watched = ptrs.back();
+
+    std::atomic<bool> stop(false);
+    std::atomic<int> reads(0), broken(0);
+    std::thread reader([&] {
+        char out[200];
+        while (!stop.load()) {
+            if (!watched.read(out, size)) {
+                broken++;
+                continue;
+            }
+            for (int i = 0; i < size; i++) {
+                if (out[i] != i % 31) {
+                    broken++;
+                    break;
+                }
+            }
+            reads++;
+        }
+    });
+
+    // Holes below the watched block make every compaction step move it
+    for (int round = 0; round < 20; round++) {
+        for (size_t i = 0; i + 1 < ptrs.size(); i += 2) {
+            a.free(ptrs[i]);
+        }
+        while (!a.defrag(size, std::chrono::microseconds(0))) {
+            std::this_thread::yield();
+        }
+        for (size_t i = 0; i + 1 < ptrs.size(); i += 2) {
+            ptrs[i] = a.alloc(size);
+            writeTo(ptrs[i], size);
+        }
+    }
+    while (reads.load() == 0) {
+        std::this_thread::yield();
+    }
+    stop = true;
+    reader.join();
+
+    EXPECT_EQ(broken.load(), 0);
+    EXPECT_TRUE(isDataOk(watched, size));
+    for (Pointer &p : ptrs) {
+        a.free(p);
+    }
+}
+
+TEST(SimpleTest, ConcurrentReadOfFreedBlock) {
+    Simple a(buf, sizeof(buf));
+
+    // Every live block is filled with 'L', memory of the freed one is reused at once by a block filled with 'F'
+    const int size = 200, rounds = 1000;
+    vector<Pointer> handles(rounds);
+    std::atomic<int> current(-1);
+    std::atomic<bool> stop(false);
+    std::atomic<int> broken(0);
+    std::thread reader([&] {
+        char out[200];
+        while (!stop.load()) {
+            int i = current.load();
+            if (i < 0 || !handles[i].read(out, size)) {
+                continue;
+            }
+            for (int j = 0; j < size; j++) {
+                if (out[j] != 'L') {
+                    broken++;
+                    break;
+                }
+            }
+        }
+    });
+
+    for (int i = 0; i < rounds; i++) {
+        handles[i] = a.alloc(size);
+        memset(handles[i].get(), 'L', size);
+        current.store(i);
+        std::this_thread::yield();
+
+        Pointer live = handles[i];
+        a.free(live);
+        Pointer foreign = a.alloc(size);
+        memset(foreign.get(), 'F', size);
+        a.free(foreign);
+    }
+    stop = true;
+    reader.join();
+    EXPECT_EQ(broken.load(), 0);
+}
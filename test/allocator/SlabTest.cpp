@@ -0,0 +1,130 @@
+#include "gtest/gtest.h"
+#include <cstring>
+#include <set>
+#include <vector>
+
+#include <afina/allocator/Error.h>
+#include <afina/allocator/Slab.h>
+
+using namespace std;
+using namespace Afina::Allocator;
+
+// Four whole pages after alignment
+static vector<char> region(5 * Slab::kPageSize);
+
+TEST(SlabTest, AllocInRange) {
+    Slab a(region.data(), region.size());
+    EXPECT_EQ(4, a.pages());
+    EXPECT_EQ(4, a.free_pages());
+
+    size_t size = 500;
+    char *v = static_cast<char *>(a.alloc(size));
+    EXPECT_GE(v, region.data());
+    EXPECT_LE(v + size, region.data() + region.size());
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(v) % 16);
+    std::memset(v, 'x', size);
+
+    size_t cls = a.class_of(size);
+    EXPECT_GE(a.chunk_size(cls), size);
+    EXPECT_EQ(1, a.class_pages(cls));
+    EXPECT_EQ(1, a.class_used(cls));
+    EXPECT_EQ(3, a.free_pages());
+
+    // Empty page goes back to the pool
+    Slab::free(v);
+    EXPECT_EQ(0, a.class_pages(cls));
+    EXPECT_EQ(4, a.free_pages());
+}
+
+TEST(SlabTest, ClassesGrowGeometrically) {
+    Slab a(region.data(), region.size(), 1.25);
+
+    EXPECT_EQ(Slab::kMinChunk, a.chunk_size(0));
+    for (size_t cls = 1; cls < a.classes(); cls++) {
+        EXPECT_EQ(0, a.chunk_size(cls) % 16);
+        EXPECT_GT(a.chunk_size(cls), a.chunk_size(cls - 1));
+        if (cls + 1 < a.classes()) {
+            EXPECT_LE(a.chunk_size(cls), a.chunk_size(cls - 1) * 1.25 + 16);
+        }
+    }
+
+    EXPECT_EQ(0, a.class_of(1));
+    EXPECT_EQ(1, a.class_of(Slab::kMinChunk + 1));
+    EXPECT_EQ(a.classes() - 1, a.class_of(a.chunk_size(a.classes() - 1)));
+    EXPECT_EQ(a.classes(), a.class_of(Slab::kPageSize));
+}
+
+TEST(SlabTest, ChunksAreReused) {
+    Slab a(region.data(), region.size());
+
+    std::set<void *> chunks;
+    for (int i = 0; i < 100; i++) {
+        chunks.insert(a.alloc(100));
+    }
+    EXPECT_EQ(100, chunks.size());
+    EXPECT_EQ(100, a.class_used(a.class_of(100)));
+
+    void *p = *chunks.begin();
+    Slab::free(p);
+    EXPECT_EQ(p, a.alloc(100));
+
+    for (void *chunk : chunks) {
+        Slab::free(chunk);
+    }
+    EXPECT_EQ(4, a.free_pages());
+}
+
+TEST(SlabTest, NoMemory) {
+    Slab a(region.data(), region.size());
+    size_t largest = a.chunk_size(a.classes() - 1);
+
+    std::vector<void *> chunks;
+    for (int i = 0; i < 4; i++) {
+        EXPECT_TRUE(a.available(largest));
+        chunks.push_back(a.alloc(largest));
+    }
+    EXPECT_FALSE(a.available(largest));
+    EXPECT_FALSE(a.available(1));
+    EXPECT_EQ(nullptr, a.try_alloc(1));
+    EXPECT_THROW(a.alloc(1), AllocError);
+    EXPECT_EQ(nullptr, a.try_alloc(largest + 1));
+
+    Slab::free(chunks.back());
+    EXPECT_TRUE(a.available(1));
+    EXPECT_NE(nullptr, a.try_alloc(1));
+}
+
+TEST(SlabTest, PartialPagesFirst) {
+    Slab a(region.data(), region.size());
+
+    // Page is freed as a whole only, class keeps filling its partial page
+    void *first = a.alloc(100);
+    void *second = a.alloc(100);
+    Slab::free(first);
+    void *third = a.alloc(100);
+    EXPECT_EQ(first, third);
+    EXPECT_EQ(1, a.class_pages(a.class_of(100)));
+
+    Slab::free(second);
+    Slab::free(third);
+    EXPECT_EQ(4, a.free_pages());
+}
+
+TEST(SlabTest, AssignedPageStaysWithClass) {
+    Slab a(region.data(), region.size());
+    size_t small = a.class_of(100), large = a.class_of(10000);
+
+    EXPECT_TRUE(a.assign(large));
+    EXPECT_EQ(1, a.class_pages(large));
+    EXPECT_EQ(3, a.free_pages());
+
+    // Other classes take the remaining free pages only
+    std::vector<void *> chunks;
+    for (size_t i = 0; i < 3; i++) {
+        chunks.push_back(a.alloc(a.chunk_size(a.classes() - 1)));
+    }
+    EXPECT_EQ(nullptr, a.try_alloc(100));
+    EXPECT_FALSE(a.assign(small));
+    EXPECT_NE(nullptr, a.try_alloc(10000));
+    EXPECT_EQ(1, a.class_pages(large));
+}
@@ -0,0 +1,113 @@
+#include "gtest/gtest.h"
+#include <map>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <afina/allocator/Error.h>
+#include <afina/allocator/Simple.h>
+#include <afina/allocator/StdAllocator.h>
+
+using namespace Afina::Allocator;
+
+template <typename T> using Vector = std::vector<T, StdAllocator<T>>;
+using Map = std::map<int, int, std::less<int>, StdAllocator<std::pair<const int, int>>>;
+using String = std::basic_string<char, std::char_traits<char>, StdAllocator<char>>;
+
+static bool inArea(const void *p, const char *area, size_t size) {
+    const char *c = static_cast<const char *>(p);
+    return c >= area && c < area + size;
+}
+
+TEST(StdAllocatorTest, Vector) {
+    static char area[65536];
+    Simple arena(area, sizeof(area));
+
+    Vector<int> v{StdAllocator<int>(arena)};
+    for (int i = 0; i < 1000; i++) {
+        v.push_back(i);
+    }
+    EXPECT_TRUE(inArea(v.data(), area, sizeof(area)));
+    for (int i = 0; i < 1000; i++) {
+        EXPECT_EQ(v[i], i);
+    }
+
+    v.clear();
+    v.shrink_to_fit();
+    // Everything is returned, so the whole area could be taken again
+    Vector<char> big{StdAllocator<char>(arena)};
+    big.resize(sizeof(area) / 2);
+    EXPECT_TRUE(inArea(big.data(), area, sizeof(area)));
+}
+
+TEST(StdAllocatorTest, MapAndString) {
+    static char area[65536];
+    Simple arena(area, sizeof(area));
+
+    Map m{std::less<int>(), StdAllocator<std::pair<const int, int>>(arena)};
+    for (int i = 0; i < 500; i++) {
+        m[i] = i * i;
+    }
+    EXPECT_TRUE(inArea(&*m.find(250), area, sizeof(area)));
+    for (int i = 0; i < 500; i += 2) {
+        m.erase(i);
+    }
+    EXPECT_EQ(m.size(), 250);
+    EXPECT_EQ(m[251], 251 * 251);
+
+    String s("a string long enough to leave small string buffer", StdAllocator<char>(arena));
+    s += s;
+    EXPECT_TRUE(inArea(s.data(), area, sizeof(area)));
+    EXPECT_EQ(s.size(), 2 * 49);
+}
+
+TEST(StdAllocatorTest, Equality) {
+    static char area1[4096], area2[4096];
+    Simple arena1(area1, sizeof(area1));
+    Simple arena2(area2, sizeof(area2));
+
+    StdAllocator<int> a(arena1);
+    StdAllocator<double> rebound(a);
+    StdAllocator<int>::rebind<char>::other other(arena1);
+    EXPECT_TRUE(a == rebound);
+    EXPECT_TRUE(a == other);
+    EXPECT_TRUE(a != StdAllocator<int>(arena2));
+    EXPECT_FALSE(a == StdAllocator<int>(arena2));
+}
+
+TEST(StdAllocatorTest, Propagation) {
+    static char area1[65536], area2[65536];
+    Simple arena1(area1, sizeof(area1));
+    Simple arena2(area2, sizeof(area2));
+
+    Vector<int> v1(100, 1, StdAllocator<int>(arena1));
+    Vector<int> v2(100, 2, StdAllocator<int>(arena2));
+
+    // Allocator goes along with contents, so memory is returned to the arena it came from
+    v1.swap(v2);
+    EXPECT_TRUE(inArea(v1.data(), area2, sizeof(area2)));
+    EXPECT_TRUE(v1.get_allocator().arena() == &arena2);
+
+    v1 = v2;
+    EXPECT_TRUE(v1.get_allocator().arena() == &arena1);
+    EXPECT_TRUE(inArea(v1.data(), area1, sizeof(area1)));
+
+    Vector<int> v3{StdAllocator<int>(arena2)};
+    v3 = std::move(v1);
+    EXPECT_TRUE(v3.get_allocator().arena() == &arena1);
+    EXPECT_EQ(v3[0], 1);
+}
+
+TEST(StdAllocatorTest, NoMemory) {
+    static char area[4096];
+    Simple arena(area, sizeof(area));
+
+    Vector<char> v{StdAllocator<char>(arena)};
+    EXPECT_THROW(v.reserve(2 * sizeof(area)), std::bad_alloc);
+    EXPECT_THROW(StdAllocator<int>(arena).allocate(size_t(-1) / 2), std::bad_alloc);
+
+    v.reserve(100);
+    int local;
+    EXPECT_THROW(StdAllocator<int>(arena).deallocate(&local, 1), AllocError);
+}
@@ -0,0 +1,213 @@
+#include "gtest/gtest.h"
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <afina/concurrency/Epoch.h>
+
+using namespace Afina::Concurrency;
+using namespace std;
+
+static std::atomic<size_t> freed(0);
+
+static void count_free(void *) { freed++; }
+
+// Collects until nothing is left or it stops making progress
+static void drain(EpochDomain &domain) {
+    for (int i = 0; i < 4 && domain.pending() > 0; i++) {
+        domain.collect();
+    }
+}
+
+TEST(EpochTest, RetiredObjectIsFreed) {
+    EpochDomain domain;
+    freed = 0;
+
+    int objects[10];
+    for (auto &o : objects) {
+        domain.retire(&o, count_free);
+    }
+    EXPECT_EQ(10, domain.pending());
+    EXPECT_EQ(0, freed);
+
+    domain.flush();
+    drain(domain);
+    EXPECT_EQ(0, domain.pending());
+    EXPECT_EQ(10, freed);
+    EXPECT_LE(2, domain.epoch());
+}
+
+TEST(EpochTest, PinsNest) {
+    EpochDomain domain;
+    EXPECT_FALSE(domain.pinned());
+    {
+        EpochGuard outer(domain);
+        {
+            EpochGuard inner(domain);
+            EXPECT_TRUE(domain.pinned());
+        }
+        EXPECT_TRUE(domain.pinned());
+    }
+    EXPECT_FALSE(domain.pinned());
+}
+
+TEST(EpochTest, PinnedThreadHoldsObjects) {
+    EpochDomain domain;
+    freed = 0;
+
+    std::atomic<int> stage(0);
+    std::thread reader([&]() {
+        EpochGuard guard(domain);
+        stage = 1;
+        while (stage.load() != 2) {
+            std::this_thread::yield();
+        }
+    });
+    while (stage.load() != 1) {
+        std::this_thread::yield();
+    }
+
+    int object;
+    domain.retire(&object, count_free);
+    domain.flush();
+    for (int i = 0; i < 10; i++) {
+        domain.collect();
+    }
+    EXPECT_EQ(0, freed);
+
+    stage = 2;
+    reader.join();
+    drain(domain);
+    EXPECT_EQ(1, freed);
+}
+
+TEST(EpochTest, ExitedThreadHandsObjectsOver) {
+    EpochDomain domain;
+    freed = 0;
+
+    int object;
+    std::thread([&]() { domain.retire(&object, count_free); }).join();
+    drain(domain);
+    EXPECT_EQ(1, freed);
+}
+
+TEST(EpochTest, TooManyThreads) {
+    EpochDomain domain(1);
+    EpochGuard guard(domain);
+    std::thread([&]() { EXPECT_THROW(domain.pin(), std::runtime_error); }).join();
+
+    // Slot is given back once its thread exits
+    EpochDomain other(1);
+    std::thread([&]() { EpochGuard guard(other); }).join();
+    std::thread([&]() { EpochGuard guard(other); }).join();
+}
+
+TEST(EpochTest, GarbageIsBounded) {
+    const size_t max_garbage = 256;
+    EpochDomain domain(16, max_garbage);
+    freed = 0;
+
+    // Stalled reader holds the epoch, writer retiring outside of guard has to wait for it
+    std::atomic<bool> stalled(true), pinned(false);
+    std::thread reader([&]() {
+        EpochGuard guard(domain);
+        pinned = true;
+        while (stalled.load()) {
+            std::this_thread::yield();
+        }
+    });
+    while (!pinned.load()) {
+        std::this_thread::yield();
+    }
+
+    const size_t n = 10 * max_garbage;
+    std::atomic<size_t> retired(0);
+    std::vector<int> objects(n);
+    std::thread writer([&]() {
+        for (auto &o : objects) {
+            domain.retire(&o, count_free);
+            retired++;
+        }
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_GT(n, retired.load());
+    EXPECT_GE(max_garbage + EpochDomain::kBagSize, domain.pending());
+
+    stalled = false;
+    reader.join();
+    writer.join();
+    drain(domain);
+    EXPECT_EQ(n, freed);
+}
+
+namespace {
+
+// Deleter breaks the invariant, so reader of a freed node is likely to notice even without sanitizer
+struct Node {
+    uint64_t value;
+    uint64_t check;
+};
+
+} // namespace
+
+TEST(EpochTest, ReaderWriterTorture) {
+    // Run under ThreadSanitizer to catch reads of freed nodes, see README.md
+    const size_t n_readers = 4, n_writers = 2, n_updates = 20000;
+    static std::atomic<size_t> deleted(0);
+    deleted = 0;
+
+    std::atomic<Node *> shared(new Node{0, ~uint64_t(0)});
+    std::atomic<bool> done(false);
+    {
+        EpochDomain domain;
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < n_readers; t++) {
+            threads.emplace_back([&, t]() {
+                size_t reads = 0;
+                while (!done.load(std::memory_order_relaxed) || reads < 1000) {
+                    EpochGuard guard(domain);
+                    Node *node = shared.load(std::memory_order_acquire);
+                    ASSERT_EQ(~node->value, node->check);
+                    if (reads++ % 16 == t) {
+                        // Nested pin doesn't change anything
+                        EpochGuard nested(domain);
+                        Node *again = shared.load(std::memory_order_acquire);
+                        ASSERT_EQ(~again->value, again->check);
+                        ASSERT_EQ(~node->value, node->check);
+                    }
+                }
+            });
+        }
+
+        std::vector<std::thread> writers;
+        for (size_t t = 0; t < n_writers; t++) {
+            writers.emplace_back([&, t]() {
+                for (size_t i = 0; i < n_updates; i++) {
+                    uint64_t value = t * n_updates + i;
+                    Node *old = shared.exchange(new Node{value, ~value}, std::memory_order_acq_rel);
+                    domain.retire(old, [](void *p) {
+                        Node *node = static_cast<Node *>(p);
+                        node->check = node->value;
+                        delete node;
+                        deleted++;
+                    });
+                }
+            });
+        }
+        for (auto &t : writers) {
+            t.join();
+        }
+        done = true;
+        for (auto &t : threads) {
+            t.join();
+        }
+
+        drain(domain);
+        EXPECT_EQ(0, domain.pending());
+    }
+    EXPECT_EQ(n_writers * n_updates, deleted.load());
+    delete shared.load();
+}
@@ -0,0 +1,160 @@
+#include "gtest/gtest.h"
+#include <string>
+#include <vector>
+
+#include <afina/ValueView.h>
+#include <afina/execute/Cas.h>
+#include <afina/execute/Decr.h>
+#include <afina/execute/Get.h>
+#include <afina/execute/Incr.h>
+#include <afina/execute/Set.h>
+
+#include "storage/SimpleLRU.h"
+
+using namespace Afina;
+using namespace std;
+
+// Verify vectored response matches the plain one byte to byte
+TEST(GetTest, VectoredResponse) {
+    Backend::SimpleLRU storage;
+    storage.Put("foo", "fooval");
+    storage.Put("bar", "barval1");
+
+    Execute::Get get({"foo", "none", "bar"});
+
+    std::string plain;
+    get.Execute(storage, "", plain);
+    EXPECT_EQ("VALUE foo 0 6\r\nfooval\r\nVALUE bar 0 7\r\nbarval1\r\nEND", plain);
+
+    std::vector<ValueView> buffers;
+    get.ExecuteVectored(storage, "", buffers);
+    ASSERT_EQ(5, buffers.size());
+
+    // Values are sent right from storage, even once they are replaced there
+    storage.Put("foo", "FOOVAL");
+    std::string vectored;
+    for (auto &buffer : buffers) {
+        vectored.append(buffer.data(), buffer.size());
+    }
+    EXPECT_EQ(plain, vectored);
+}
+
+TEST(GetTest, Miss) {
+    Backend::SimpleLRU storage;
+    Execute::Get get({"foo"});
+
+    std::vector<ValueView> buffers;
+    get.ExecuteVectored(storage, "", buffers);
+    ASSERT_EQ(1, buffers.size());
+    EXPECT_EQ("END", buffers[0].str());
+}
+
+TEST(GetTest, GetsAndCas) {
+    Backend::SimpleLRU storage;
+    storage.Put("foo", "fooval");
+
+    std::vector<ValueView> values;
+    std::vector<ValueInfo> infos;
+    storage.MultiGetWithInfo({"foo"}, values, infos);
+    std::string cas = std::to_string(infos[0].cas);
+
+    std::string out;
+    Execute::Get({"foo", "bar"}, true).Execute(storage, "", out);
+    EXPECT_EQ("VALUE foo 0 6 " + cas + "\r\nfooval\r\nEND", out);
+
+    Execute::Cas(std::string("foo"), 0, 0, infos[0].cas + 1).Execute(storage, "newval", out);
+    EXPECT_EQ("EXISTS", out);
+    Execute::Cas(std::string("foo"), 0, 0, infos[0].cas).Execute(storage, "newval", out);
+    EXPECT_EQ("STORED", out);
+    Execute::Cas(std::string("foo"), 0, 0, infos[0].cas).Execute(storage, "other", out);
+    EXPECT_EQ("EXISTS", out);
+    Execute::Cas(std::string("bar"), 0, 0, infos[0].cas).Execute(storage, "other", out);
+    EXPECT_EQ("NOT_FOUND", out);
+
+    std::string value;
+    EXPECT_TRUE(storage.Get("foo", value));
+    EXPECT_EQ("newval", value);
+}
+
+TEST(GetTest, Counter) {
+    Backend::SimpleLRU storage;
+    storage.Put("foo", "41");
+    storage.Put("bar", "x");
+
+    std::string out;
+    Execute::Incr("foo", 1).Execute(storage, "", out);
+    EXPECT_EQ("42", out);
+    Execute::Decr("foo", 50).Execute(storage, "", out);
+    EXPECT_EQ("0", out);
+    Execute::Incr("bar", 1).Execute(storage, "", out);
+    EXPECT_EQ("CLIENT_ERROR cannot increment or decrement non-numeric value", out);
+    Execute::Decr("none", 1).Execute(storage, "", out);
+    EXPECT_EQ("NOT_FOUND", out);
+
+    Execute::Get({"foo"}).Execute(storage, "", out);
+    EXPECT_EQ("VALUE foo 0 1\r\n0\r\nEND", out);
+}
+
+TEST(GetTest, Flags) {
+    Backend::SimpleLRU storage;
+
+    std::string out;
+    Execute::Set(std::string("foo"), 12345, 0).Execute(storage, "fooval", out);
+    EXPECT_EQ("STORED", out);
+    Execute::Get({"foo"}).Execute(storage, "", out);
+    EXPECT_EQ("VALUE foo 12345 6\r\nfooval\r\nEND", out);
+}
+
+// Response line is taken from the item, it must follow every change of the value
+TEST(GetTest, CachedHeader) {
+    Backend::SimpleLRU storage;
+    EXPECT_TRUE(storage.PutWithTTL("foo", "fooval", 0, 7));
+
+    std::vector<ValueView> values;
+    std::vector<ValueInfo> infos;
+    storage.MultiGetWithInfo({"foo"}, values, infos);
+    ASSERT_NE(nullptr, infos[0].header);
+    EXPECT_EQ(" 7 6\r\n", std::string(infos[0].header, infos[0].header_size));
+    values.clear();
+
+    std::string out;
+    EXPECT_TRUE(storage.Append("foo", "0123456789"));
+    Execute::Get({"foo"}).Execute(storage, "", out);
+    EXPECT_EQ("VALUE foo 7 16\r\nfooval0123456789\r\nEND", out);
+
+    EXPECT_TRUE(storage.SetWithTTL("foo", "bar", 0, 8));
+    Execute::Get({"foo"}).Execute(storage, "", out);
+    EXPECT_EQ("VALUE foo 8 3\r\nbar\r\nEND", out);
+
+    uint64_t result;
+    EXPECT_TRUE(storage.SetWithTTL("foo", "41", 0, 9));
+    EXPECT_EQ(DeltaResult::Stored, storage.Increment("foo", 100, result));
+    Execute::Get({"foo"}).Execute(storage, "", out);
+    EXPECT_EQ("VALUE foo 9 3\r\n141\r\nEND", out);
+}
+
+// Value kept in chunks is sent piece by piece
+TEST(GetTest, ChunkedValue) {
+    Backend::SimpleLRU storage(1 << 20);
+    storage.Put("foo", "x");
+    std::string expected = "x";
+    for (int i = 0; i < 1000; i++) {
+        storage.Append("foo", "0123456789");
+        expected += "0123456789";
+    }
+
+    Execute::Get get({"foo"});
+    std::string plain;
+    get.Execute(storage, "", plain);
+    EXPECT_EQ("VALUE foo 0 " + std::to_string(expected.size()) + "\r\n" + expected + "\r\nEND", plain);
+
+    std::vector<ValueView> buffers;
+    get.ExecuteVectored(storage, "", buffers);
+    EXPECT_LT(3, buffers.size());
+    std::string vectored;
+    for (auto &buffer : buffers) {
+        EXPECT_EQ(nullptr, buffer.next());
+        vectored.append(buffer.data(), buffer.size());
+    }
+    EXPECT_EQ(plain, vectored);
+}
@@ -4,7 +4,12 @@
 #include <string>
 
 #include <afina/execute/Add.h>
+#include <afina/execute/Cas.h>
+#include <afina/execute/Decr.h>
 #include <afina/execute/Get.h>
+#include <afina/execute/Incr.h>
+#include <afina/execute/Prepend.h>
+#include <afina/execute/Replace.h>
 #include <afina/execute/Set.h>
 #include <afina/execute/Stats.h>
 
@@ -58,6 +63,115 @@ TEST(MemcachedParserTest, SimpleAdd) {
     ASSERT_EQ(-1, tmp->expire());
 }
 
+// Verify multi digit expire time
+// Verify replace and prepend commands are built
+TEST(MemcachedParserTest, ReplacePrepend) {
+    Protocol::Parser parser;
+
+    size_t consumed = 0;
+    ASSERT_TRUE(parser.Parse("replace foo 1 2 3\r\nbar\r\n", consumed));
+    ASSERT_EQ("replace", parser.Name());
+
+    size_t value_size;
+    std::unique_ptr<Execute::Command> cmd = parser.Build(value_size);
+    ASSERT_FALSE(cmd == nullptr);
+    ASSERT_EQ(3, value_size);
+    ASSERT_TRUE(dynamic_cast<Execute::Replace *>(cmd.get()) != nullptr);
+
+    parser.Reset();
+    ASSERT_TRUE(parser.Parse("prepend foo 0 0 3\r\nbar\r\n", consumed));
+    ASSERT_EQ("prepend", parser.Name());
+
+    cmd = parser.Build(value_size);
+    ASSERT_FALSE(cmd == nullptr);
+    ASSERT_EQ(3, value_size);
+    ASSERT_TRUE(dynamic_cast<Execute::Prepend *>(cmd.get()) != nullptr);
+}
+
+// Verify cas unique is parsed out of cas command
+TEST(MemcachedParserTest, Cas) {
+    Protocol::Parser parser;
+
+    size_t consumed = 0;
+    ASSERT_TRUE(parser.Parse("cas foo 1 2 3 18446744073709551615\r\nbar\r\n", consumed));
+    ASSERT_EQ("cas", parser.Name());
+
+    size_t value_size;
+    std::unique_ptr<Execute::Command> cmd = parser.Build(value_size);
+    ASSERT_FALSE(cmd == nullptr);
+    ASSERT_EQ(3, value_size);
+
+    Execute::Cas *tmp = dynamic_cast<Execute::Cas *>(cmd.get());
+    ASSERT_TRUE(tmp != nullptr);
+    ASSERT_EQ("foo", tmp->key());
+    ASSERT_EQ(UINT64_MAX, tmp->cas());
+
+    parser.Reset();
+    ASSERT_THROW(parser.Parse("cas foo 1 2 3 18446744073709551616\r\n", consumed), std::runtime_error);
+
+    parser.Reset();
+    ASSERT_TRUE(parser.Parse("gets foo bar\r\n", consumed));
+    cmd = parser.Build(value_size);
+    Execute::Get *gets = dynamic_cast<Execute::Get *>(cmd.get());
+    ASSERT_TRUE(gets != nullptr);
+    ASSERT_TRUE(gets->cas());
+    ASSERT_EQ(2, gets->keys().size());
+}
+
+// Verify counter commands have no data block
+TEST(MemcachedParserTest, IncrDecr) {
+    Protocol::Parser parser;
+
+    size_t consumed = 0;
+    ASSERT_TRUE(parser.Parse("incr foo 18446744073709551615\r\n", consumed));
+    ASSERT_EQ(31, consumed);
+    ASSERT_EQ("incr", parser.Name());
+
+    size_t value_size;
+    std::unique_ptr<Execute::Command> cmd = parser.Build(value_size);
+    ASSERT_EQ(0, value_size);
+    Execute::Incr *incr = dynamic_cast<Execute::Incr *>(cmd.get());
+    ASSERT_TRUE(incr != nullptr);
+    ASSERT_EQ("foo", incr->key());
+    ASSERT_EQ(UINT64_MAX, incr->delta());
+
+    parser.Reset();
+    ASSERT_TRUE(parser.Parse("decr bar 7\r\n", consumed));
+    cmd = parser.Build(value_size);
+    Execute::Decr *decr = dynamic_cast<Execute::Decr *>(cmd.get());
+    ASSERT_TRUE(decr != nullptr);
+    ASSERT_EQ("bar", decr->key());
+    ASSERT_EQ(7, decr->delta());
+
+    parser.Reset();
+    ASSERT_THROW(parser.Parse("incr foo 18446744073709551616\r\n", consumed), std::runtime_error);
+}
+
+TEST(MemcachedParserTest, ExpireTime) {
+    Protocol::Parser parser;
+
+    size_t consumed = 0;
+    bool cmd_avail = parser.Parse("set foo 0 3600 6\r\nfooval\r\n", consumed);
+    ASSERT_TRUE(cmd_avail);
+
+    size_t value_size;
+    std::unique_ptr<Execute::Command> cmd = parser.Build(value_size);
+    ASSERT_FALSE(cmd == nullptr);
+
+    Execute::Set *tmp = reinterpret_cast<Execute::Set *>(cmd.get());
+    ASSERT_EQ(3600, tmp->expire());
+
+    parser.Reset();
+    cmd_avail = parser.Parse("set foo 0 -25 6\r\nfooval\r\n", consumed);
+    ASSERT_TRUE(cmd_avail);
+    cmd = parser.Build(value_size);
+    tmp = reinterpret_cast<Execute::Set *>(cmd.get());
+    ASSERT_EQ(-25, tmp->expire());
+
+    parser.Reset();
+    ASSERT_THROW(parser.Parse("set foo 0 99999999999 6\r\n", consumed), std::runtime_error);
+}
+
 // Verify simple get command passed in a single string
 TEST(MemcachedParserTest, SimpleGet) {
     Protocol::Parser parser;
@@ -0,0 +1,128 @@
+#include "gtest/gtest.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "storage/ClockLRU.h"
+#include "storage/SimpleLRU.h"
+#include "storage/StripedLRU.h"
+#include "storage/ThreadSafeClockLRU.h"
+#include "storage/ThreadSafeSimpleLRU.h"
+#include "storage/TinyLFU.h"
+
+using namespace Afina;
+using namespace Afina::Backend;
+using namespace std;
+
+template <typename T> class CasTest : public ::testing::Test {};
+
+typedef ::testing::Types<SimpleLRU, SimpleLFU, ThreadSafeSimplLRU, StripedLRU, ClockLRU, ThreadSafeClockLRU>
+    CasStorages;
+TYPED_TEST_CASE(CasTest, CasStorages);
+
+static uint64_t version(Storage &storage, const std::string &key) {
+    std::vector<ValueView> values;
+    std::vector<ValueInfo> infos;
+    storage.MultiGetWithInfo({key}, values, infos);
+    EXPECT_NE(nullptr, values[0].data()) << key;
+    return infos[0].cas;
+}
+
+TYPED_TEST(CasTest, EveryWriteChangesVersion) {
+    TypeParam storage;
+
+    EXPECT_TRUE(storage.Put("KEY1", "val1"));
+    EXPECT_TRUE(storage.Put("KEY2", "val2"));
+    uint64_t v1 = version(storage, "KEY1");
+    EXPECT_NE(v1, version(storage, "KEY2"));
+
+    // Reads don't change version
+    std::string value;
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_EQ(v1, version(storage, "KEY1"));
+
+    // Same size value is written in place, yet version changes
+    EXPECT_TRUE(storage.Put("KEY1", "VAL1"));
+    uint64_t v2 = version(storage, "KEY1");
+    EXPECT_NE(v1, v2);
+
+    EXPECT_TRUE(storage.Append("KEY1", "a"));
+    uint64_t v3 = version(storage, "KEY1");
+    EXPECT_NE(v2, v3);
+
+    EXPECT_TRUE(storage.Set("KEY1", "val1"));
+    EXPECT_NE(v3, version(storage, "KEY1"));
+}
+
+TYPED_TEST(CasTest, CompareAndSwap) {
+    TypeParam storage;
+
+    EXPECT_EQ(CasResult::NotFound, storage.CompareAndSwap("KEY1", "val", 0, 0, 1));
+
+    EXPECT_TRUE(storage.Put("KEY1", "val1"));
+    uint64_t v1 = version(storage, "KEY1");
+    EXPECT_EQ(CasResult::Exists, storage.CompareAndSwap("KEY1", "val", 0, 0, v1 + 1));
+    EXPECT_EQ(CasResult::Stored, storage.CompareAndSwap("KEY1", "val2", 0, 0, v1));
+
+    // Second writer with the same version loses
+    EXPECT_EQ(CasResult::Exists, storage.CompareAndSwap("KEY1", "val3", 0, 0, v1));
+
+    std::string value;
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_EQ("val2", value);
+
+    uint64_t v2 = version(storage, "KEY1");
+    EXPECT_EQ(CasResult::NotStored, storage.CompareAndSwap("KEY1", std::string(2048, 'x'), 0, 0, v2));
+    EXPECT_TRUE(storage.Delete("KEY1"));
+    EXPECT_EQ(CasResult::NotFound, storage.CompareAndSwap("KEY1", "val", 0, 0, v1));
+}
+
+static uint32_t flags(Storage &storage, const std::string &key) {
+    std::vector<ValueView> values;
+    std::vector<ValueInfo> infos;
+    storage.MultiGetWithInfo({key}, values, infos);
+    EXPECT_NE(nullptr, values[0].data()) << key;
+    return infos[0].flags;
+}
+
+TYPED_TEST(CasTest, FlagsFollowValue) {
+    TypeParam storage;
+
+    EXPECT_TRUE(storage.PutWithTTL("KEY1", "val1", 0, 0xdeadbeef));
+    EXPECT_TRUE(storage.PutIfAbsentWithTTL("KEY2", "1", 0, 7));
+    EXPECT_EQ(0xdeadbeef, flags(storage, "KEY1"));
+    EXPECT_EQ(7, flags(storage, "KEY2"));
+
+    // Modifications keep flags of the item
+    EXPECT_TRUE(storage.Append("KEY1", std::string(64, 'x')));
+    EXPECT_EQ(0xdeadbeef, flags(storage, "KEY1"));
+    uint64_t result;
+    EXPECT_EQ(DeltaResult::Stored, storage.Increment("KEY2", 1, result));
+    EXPECT_EQ(7, flags(storage, "KEY2"));
+
+    // Writes of a whole value bring their own
+    EXPECT_TRUE(storage.SetWithTTL("KEY1", "val2", 0, 42));
+    EXPECT_EQ(42, flags(storage, "KEY1"));
+    EXPECT_EQ(CasResult::Stored, storage.CompareAndSwap("KEY1", "val3", 0, 5, version(storage, "KEY1")));
+    EXPECT_EQ(5, flags(storage, "KEY1"));
+    EXPECT_TRUE(storage.Put("KEY1", "val4"));
+    EXPECT_EQ(0, flags(storage, "KEY1"));
+}
+
+TEST(CasTest, TinyLFU) {
+    TinyLFU storage(std::make_shared<SimpleSLRU>(1024), 16);
+
+    EXPECT_TRUE(storage.Put("KEY1", "val1"));
+    uint64_t v1 = version(storage, "KEY1");
+    EXPECT_EQ(CasResult::Exists, storage.CompareAndSwap("KEY1", "val2", 0, 0, v1 + 1));
+    EXPECT_EQ(CasResult::Stored, storage.CompareAndSwap("KEY1", "val2", 0, 0, v1));
+
+    // Value outgrows the window
+    uint64_t v2 = version(storage, "KEY1");
+    EXPECT_EQ(CasResult::Stored, storage.CompareAndSwap("KEY1", std::string(32, 'x'), 0, 0, v2));
+
+    std::string value;
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_EQ(std::string(32, 'x'), value);
+    EXPECT_EQ(CasResult::Exists, storage.CompareAndSwap("KEY1", "val3", 0, 0, v2));
+}
@@ -0,0 +1,96 @@
+#include "gtest/gtest.h"
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "storage/ClockLRU.h"
+#include "storage/ThreadSafeClockLRU.h"
+
+using namespace Afina::Backend;
+using namespace std;
+
+TEST(ClockLRUTest, PutGetDelete) {
+    ClockLRU storage;
+
+    EXPECT_TRUE(storage.Put("KEY1", "val1"));
+    EXPECT_TRUE(storage.Put("KEY2", "val2"));
+    EXPECT_FALSE(storage.PutIfAbsent("KEY1", "val3"));
+    EXPECT_TRUE(storage.Set("KEY2", "value4"));
+    EXPECT_FALSE(storage.Set("KEY3", "val5"));
+
+    std::string value;
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_EQ("val1", value);
+    EXPECT_TRUE(storage.Get("KEY2", value));
+    EXPECT_EQ("value4", value);
+
+    EXPECT_TRUE(storage.Delete("KEY1"));
+    EXPECT_FALSE(storage.Get("KEY1", value));
+    EXPECT_TRUE(storage.Delete("KEY2"));
+    EXPECT_FALSE(storage.Delete("KEY2"));
+
+    EXPECT_TRUE(storage.Put("KEY1", "val1"));
+    EXPECT_TRUE(storage.Get("KEY1", value));
+}
+
+TEST(ClockLRUTest, SecondChance) {
+    ClockLRU storage(24);
+
+    EXPECT_TRUE(storage.Put("KEY1", "val1"));
+    EXPECT_TRUE(storage.Put("KEY2", "val2"));
+    EXPECT_TRUE(storage.Put("KEY3", "val3"));
+
+    // KEY1 is referenced and survives, KEY2 is the first one without reference bit
+    std::string value;
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_TRUE(storage.Put("KEY4", "val4"));
+
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_FALSE(storage.Get("KEY2", value));
+    EXPECT_TRUE(storage.Get("KEY3", value));
+    EXPECT_TRUE(storage.Get("KEY4", value));
+}
+
+TEST(ClockLRUTest, SetResizeEvicts) {
+    ClockLRU storage(32);
+
+    EXPECT_TRUE(storage.Put("KEY1", "val1"));
+    EXPECT_TRUE(storage.Put("KEY2", "val2"));
+    EXPECT_TRUE(storage.Put("KEY3", "val3"));
+    EXPECT_TRUE(storage.Set("KEY1", "long value 11"));
+
+    std::string value;
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_EQ("long value 11", value);
+    EXPECT_FALSE(storage.Get("KEY2", value));
+    EXPECT_TRUE(storage.Get("KEY3", value));
+}
+
+TEST(ClockLRUTest, ConcurrentReaders) {
+    const size_t n_keys = 1000;
+    ThreadSafeClockLRU storage(n_keys * 16);
+    for (size_t i = 0; i < n_keys; i++) {
+        storage.Put("key" + std::to_string(i), std::to_string(i));
+    }
+
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < 4; t++) {
+        threads.emplace_back([&storage]() {
+            std::string value;
+            for (size_t i = 0; i < n_keys; i++) {
+                std::string key = "key" + std::to_string(i);
+                if (storage.Get(key, value)) {
+                    EXPECT_EQ(std::to_string(i), value);
+                }
+            }
+        });
+    }
+    threads.emplace_back([&storage]() {
+        for (size_t i = 0; i < n_keys; i++) {
+            storage.Put("new" + std::to_string(i), std::to_string(i));
+        }
+    });
+    for (auto &t : threads) {
+        t.join();
+    }
+}
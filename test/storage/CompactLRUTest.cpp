@@ -0,0 +1,161 @@
+#include "gtest/gtest.h"
+#include <map>
+#include <string>
+#include <vector>
+
+#include "storage/CompactLRU.h"
+
+using namespace Afina;
+using namespace Afina::Backend;
+using namespace std;
+
+// Cache of a single slab page
+static const size_t kOnePage = Allocator::Slab::kPageSize;
+
+static uint32_t fake_now = 0;
+static uint32_t fake_clock() { return fake_now; }
+
+static std::string make_key(size_t i) {
+    std::string key = "key" + std::to_string(i);
+    return key + std::string(12 - key.size(), '_');
+}
+
+TEST(CompactLRUTest, PutGetDelete) {
+    CompactLRU storage;
+
+    EXPECT_TRUE(storage.Put("KEY1", "val1"));
+    EXPECT_TRUE(storage.Put("KEY2", "val2"));
+    EXPECT_FALSE(storage.PutIfAbsent("KEY1", "val3"));
+    EXPECT_TRUE(storage.Set("KEY2", "value4"));
+    EXPECT_FALSE(storage.Set("KEY3", "val5"));
+
+    std::string value;
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_EQ("val1", value);
+    EXPECT_TRUE(storage.Get("KEY2", value));
+    EXPECT_EQ("value4", value);
+
+    EXPECT_TRUE(storage.Delete("KEY1"));
+    EXPECT_FALSE(storage.Get("KEY1", value));
+    EXPECT_TRUE(storage.Delete("KEY2"));
+    EXPECT_FALSE(storage.Delete("KEY2"));
+
+    std::map<std::string, std::string> stats;
+    storage.Stats(stats);
+    EXPECT_EQ("0", stats["curr_items"]);
+    EXPECT_EQ("0", stats["bytes"]);
+    EXPECT_EQ(stats["slab_pages"], stats["slab_free_pages"]);
+}
+
+TEST(CompactLRUTest, ManyItemsGrowIndex) {
+    CompactLRU storage;
+
+    // Long values take more than one byte of varint size
+    const size_t n = 20000;
+    for (size_t i = 0; i < n; i++) {
+        EXPECT_TRUE(storage.PutWithTTL(make_key(i), std::string(i % 300, 'a' + i % 26), 0, uint32_t(i)));
+    }
+
+    std::map<std::string, std::string> stats;
+    storage.Stats(stats);
+    EXPECT_EQ(std::to_string(n), stats["curr_items"]);
+    EXPECT_EQ("0", stats["evictions"]);
+    EXPECT_LE(n, std::stoul(stats["hash_buckets"]));
+
+    std::vector<std::string> keys;
+    for (size_t i = 0; i < n; i += 7) {
+        keys.push_back(make_key(i));
+    }
+    keys.push_back("missing");
+    std::vector<ValueView> values;
+    std::vector<ValueInfo> infos;
+    storage.MultiGetWithInfo(keys, values, infos);
+    for (size_t j = 0; j + 1 < keys.size(); j++) {
+        size_t i = 7 * j;
+        ASSERT_NE(nullptr, values[j].data());
+        EXPECT_EQ(std::string(i % 300, 'a' + i % 26), std::string(values[j].data(), values[j].size()));
+        EXPECT_EQ(i, infos[j].flags);
+    }
+    EXPECT_EQ(nullptr, values.back().data());
+}
+
+TEST(CompactLRUTest, EvictsLeastRecentlyUsedOfClass) {
+    CompactLRU storage(kOnePage);
+
+    // Page fills up with items of the same class, the first ones go once it is full
+    const std::string value(40, 'v');
+    size_t n = 0;
+    std::map<std::string, std::string> stats;
+    for (; n < 100000; n++) {
+        EXPECT_TRUE(storage.Put(make_key(n), value));
+        storage.Stats(stats);
+        if (stats["evictions"] != "0") {
+            break;
+        }
+    }
+    ASSERT_LT(n, 100000);
+
+    // Touched item survives the next eviction, the oldest untouched one doesn't
+    std::string out;
+    EXPECT_FALSE(storage.Get(make_key(0), out));
+    EXPECT_TRUE(storage.Get(make_key(1), out));
+    EXPECT_TRUE(storage.Put(make_key(n + 1), value));
+    EXPECT_TRUE(storage.Get(make_key(1), out));
+    EXPECT_FALSE(storage.Get(make_key(2), out));
+    EXPECT_TRUE(storage.Get(make_key(3), out));
+    EXPECT_TRUE(storage.Get(make_key(n), out));
+}
+
+TEST(CompactLRUTest, StarvedClassTakesPage) {
+    CompactLRU storage(kOnePage);
+
+    const std::string small(16, 's'), large(2000, 'l');
+    for (size_t i = 0; i < 30000; i++) {
+        EXPECT_TRUE(storage.Put(make_key(i), small));
+    }
+    EXPECT_TRUE(storage.Put("large", large));
+
+    std::string value;
+    EXPECT_TRUE(storage.Get("large", value));
+    EXPECT_EQ(large, value);
+}
+
+TEST(CompactLRUTest, FailedAppendKeepsValue) {
+    CompactLRU storage(4 * kOnePage);
+
+    // Value grows past the largest chunk
+    const std::string value(kOnePage - 1000, 'v');
+    EXPECT_TRUE(storage.Put("KEY", value));
+    EXPECT_FALSE(storage.Append("KEY", std::string(2000, 'a')));
+    EXPECT_FALSE(storage.Prepend("KEY", std::string(2000, 'p')));
+
+    std::string out;
+    EXPECT_TRUE(storage.Get("KEY", out));
+    EXPECT_EQ(value, out);
+}
+
+TEST(CompactLRUTest, Expiration) {
+    fake_now = 1;
+    CompactLRU storage(kOnePage, 1.25, fake_clock);
+
+    EXPECT_TRUE(storage.PutWithTTL("KEY1", "val1", 10, 7));
+    EXPECT_TRUE(storage.Put("KEY2", "val2"));
+
+    // Appends and counters keep deadline and flags
+    EXPECT_TRUE(storage.Append("KEY1", "_tail"));
+    std::vector<ValueView> values;
+    std::vector<ValueInfo> infos;
+    storage.MultiGetWithInfo({"KEY1"}, values, infos);
+    EXPECT_EQ("val1_tail", std::string(values[0].data(), values[0].size()));
+    EXPECT_EQ(7, infos[0].flags);
+
+    std::string value;
+    fake_now = 11;
+    EXPECT_FALSE(storage.Get("KEY1", value));
+    EXPECT_FALSE(storage.Append("KEY1", "x"));
+    EXPECT_TRUE(storage.Get("KEY2", value));
+
+    std::map<std::string, std::string> stats;
+    storage.Stats(stats);
+    EXPECT_EQ("1", stats["curr_items"]);
+}
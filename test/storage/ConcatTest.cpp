@@ -0,0 +1,168 @@
+#include "gtest/gtest.h"
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "storage/ClockLRU.h"
+#include "storage/SimpleLRU.h"
+#include "storage/StripedLRU.h"
+#include "storage/ThreadSafeClockLRU.h"
+#include "storage/ThreadSafeSimpleLRU.h"
+#include "storage/TinyLFU.h"
+
+using namespace Afina;
+using namespace Afina::Backend;
+using namespace std;
+
+template <typename T> class ConcatTest : public ::testing::Test {};
+
+typedef ::testing::Types<SimpleLRU, SimpleARC, ThreadSafeSimplLRU, StripedLRU, ClockLRU, ThreadSafeClockLRU>
+    ConcatStorages;
+TYPED_TEST_CASE(ConcatTest, ConcatStorages);
+
+TYPED_TEST(ConcatTest, AppendPrepend) {
+    TypeParam storage;
+
+    EXPECT_FALSE(storage.Append("KEY1", "tail"));
+    EXPECT_FALSE(storage.Prepend("KEY1", "head"));
+
+    std::string value;
+    EXPECT_FALSE(storage.Get("KEY1", value));
+
+    EXPECT_TRUE(storage.Put("KEY1", "val"));
+    EXPECT_TRUE(storage.Append("KEY1", "_tail"));
+    EXPECT_TRUE(storage.Prepend("KEY1", "head_"));
+    EXPECT_TRUE(storage.Append("KEY1", ""));
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_EQ("head_val_tail", value);
+}
+
+TYPED_TEST(ConcatTest, ManySmallPieces) {
+    TypeParam storage(4096);
+
+    std::string expected = "x";
+    EXPECT_TRUE(storage.Put("KEY1", expected));
+    for (int i = 0; i < 100; i++) {
+        std::string piece = to_string(i);
+        if (i % 2 == 0) {
+            EXPECT_TRUE(storage.Append("KEY1", piece));
+            expected = expected + piece;
+        } else {
+            EXPECT_TRUE(storage.Prepend("KEY1", piece));
+            expected = piece + expected;
+        }
+    }
+
+    std::string value;
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_EQ(expected, value);
+
+    // Value shrinks back, maybe in place
+    EXPECT_TRUE(storage.Set("KEY1", "short"));
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_EQ("short", value);
+}
+
+TYPED_TEST(ConcatTest, ViewIsNotChanged) {
+    TypeParam storage;
+
+    EXPECT_TRUE(storage.Put("KEY1", "val"));
+    ValueView view;
+    EXPECT_TRUE(storage.GetView("KEY1", view));
+    EXPECT_TRUE(storage.Append("KEY1", "1"));
+    EXPECT_TRUE(storage.Prepend("KEY1", "2"));
+
+    EXPECT_EQ("val", view.str());
+    std::string value;
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_EQ("2val1", value);
+}
+
+TYPED_TEST(ConcatTest, ChunkedValue) {
+    TypeParam storage(1 << 20);
+
+    EXPECT_TRUE(storage.PutWithTTL("KEY1", "head", 0, 3));
+    std::string expected = "head", early_expected;
+    ValueView early;
+    for (int i = 0; i < 2000; i++) {
+        std::string piece = "piece" + to_string(i) + ";";
+        EXPECT_TRUE(storage.Append("KEY1", piece));
+        expected += piece;
+        if (i == 1000) {
+            EXPECT_TRUE(storage.GetView("KEY1", early));
+            early_expected = expected;
+        }
+    }
+    EXPECT_TRUE(storage.Prepend("KEY1", std::string(5000, 'p')));
+    expected = std::string(5000, 'p') + expected;
+
+    std::string value;
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_EQ(expected, value);
+
+    // Value is seen through a chain of views, the earlier one doesn't see later changes
+    ValueView view;
+    EXPECT_TRUE(storage.GetView("KEY1", view));
+    EXPECT_NE(nullptr, view.next());
+    EXPECT_EQ(expected.size(), view.total_size());
+    EXPECT_EQ(expected, view.str());
+    EXPECT_EQ(early_expected, early.str());
+
+    std::vector<ValueView> values;
+    std::vector<ValueInfo> infos;
+    storage.MultiGetWithInfo({"KEY1"}, values, infos);
+    EXPECT_EQ(expected, values[0].str());
+    EXPECT_EQ(3, infos[0].flags);
+
+    std::map<std::string, std::string> stats;
+    storage.Stats(stats);
+    EXPECT_EQ(to_string(4 + expected.size()), stats["bytes"]);
+
+    // Value becomes contiguous again once replaced
+    EXPECT_TRUE(storage.Set("KEY1", "short"));
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_EQ("short", value);
+    storage.Stats(stats);
+    EXPECT_EQ("9", stats["bytes"]);
+    EXPECT_EQ(early_expected, early.str());
+}
+
+TEST(ConcatTest, GrowthEvicts) {
+    SimpleLRU storage(32);
+
+    EXPECT_TRUE(storage.Put("KEY1", "val1"));
+    EXPECT_TRUE(storage.Put("KEY2", "val2"));
+    EXPECT_TRUE(storage.Put("KEY3", "val3"));
+
+    // Doesn't fit at all: nothing changes
+    EXPECT_FALSE(storage.Append("KEY3", std::string(32, 'x')));
+
+    // Key itself survives eviction it causes
+    EXPECT_TRUE(storage.Append("KEY3", std::string(17, 'x')));
+
+    std::string value;
+    EXPECT_FALSE(storage.Get("KEY1", value));
+    EXPECT_FALSE(storage.Get("KEY2", value));
+    EXPECT_TRUE(storage.Get("KEY3", value));
+    EXPECT_EQ("val3" + std::string(17, 'x'), value);
+
+    std::map<std::string, std::string> stats;
+    storage.Stats(stats);
+    EXPECT_EQ("25", stats["bytes"]);
+}
+
+TEST(ConcatTest, TinyLFUWindowOverflow) {
+    TinyLFU storage(std::make_shared<SimpleSLRU>(1024), 16);
+
+    EXPECT_TRUE(storage.Put("KEY1", "val"));
+    EXPECT_TRUE(storage.Append("KEY1", "1"));
+
+    // Value outgrows the window, main cache has room for it
+    EXPECT_TRUE(storage.Append("KEY1", std::string(32, 'x')));
+    EXPECT_TRUE(storage.Prepend("KEY1", "2"));
+
+    std::string value;
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_EQ("2val1" + std::string(32, 'x'), value);
+}
@@ -0,0 +1,122 @@
+#include "gtest/gtest.h"
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "storage/ClockLRU.h"
+#include "storage/CompactLRU.h"
+#include "storage/CuckooClock.h"
+#include "storage/SimpleLRU.h"
+#include "storage/SlabLRU.h"
+#include "storage/StripedLRU.h"
+#include "storage/ThreadSafeClockLRU.h"
+#include "storage/ThreadSafeSimpleLRU.h"
+#include "storage/ThreadSafeSlabLRU.h"
+#include "storage/TinyLFU.h"
+
+using namespace Afina;
+using namespace Afina::Backend;
+using namespace std;
+
+template <typename T> class CounterTest : public ::testing::Test {};
+
+typedef ::testing::Types<SimpleLRU, SimpleSLRU, ThreadSafeSimplLRU, StripedLRU, ClockLRU, ThreadSafeClockLRU,
+                         SlabLRU, ThreadSafeSlabLRU, CompactLRU, CuckooClock>
+    CounterStorages;
+TYPED_TEST_CASE(CounterTest, CounterStorages);
+
+TYPED_TEST(CounterTest, IncrementDecrement) {
+    TypeParam storage;
+
+    uint64_t result = 0;
+    EXPECT_EQ(DeltaResult::NotFound, storage.Increment("KEY1", 1, result));
+
+    EXPECT_TRUE(storage.Put("KEY1", "val1"));
+    EXPECT_EQ(DeltaResult::NonNumeric, storage.Increment("KEY1", 1, result));
+    EXPECT_TRUE(storage.Put("KEY1", "-1"));
+    EXPECT_EQ(DeltaResult::NonNumeric, storage.Decrement("KEY1", 1, result));
+    EXPECT_TRUE(storage.Put("KEY1", "18446744073709551616"));
+    EXPECT_EQ(DeltaResult::NonNumeric, storage.Increment("KEY1", 1, result));
+
+    EXPECT_TRUE(storage.Put("KEY1", "10"));
+    EXPECT_EQ(DeltaResult::Stored, storage.Increment("KEY1", 5, result));
+    EXPECT_EQ(15, result);
+    EXPECT_EQ(DeltaResult::Stored, storage.Decrement("KEY1", 20, result));
+    EXPECT_EQ(0, result);
+    EXPECT_EQ(DeltaResult::Stored, storage.Decrement("KEY1", 1, result));
+    EXPECT_EQ(0, result);
+    EXPECT_EQ(DeltaResult::Stored, storage.Increment("KEY1", UINT64_MAX, result));
+    EXPECT_EQ(UINT64_MAX, result);
+    EXPECT_EQ(DeltaResult::Stored, storage.Increment("KEY1", 2, result));
+    EXPECT_EQ(1, result);
+
+    // Readers see decimal text whatever the form counter is kept in
+    std::string value;
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_EQ("1", value);
+    std::vector<ValueView> views;
+    storage.MultiGet({"KEY1"}, views);
+    EXPECT_EQ("1", views[0].str());
+}
+
+TYPED_TEST(CounterTest, BackToText) {
+    TypeParam storage;
+
+    uint64_t result = 0;
+    EXPECT_TRUE(storage.Put("KEY1", "99"));
+
+    // View of the text value stays as is
+    ValueView view;
+    EXPECT_TRUE(storage.GetView("KEY1", view));
+    EXPECT_EQ(DeltaResult::Stored, storage.Increment("KEY1", 1, result));
+    EXPECT_EQ(DeltaResult::Stored, storage.Increment("KEY1", 1, result));
+    EXPECT_EQ("99", view.str());
+
+    EXPECT_TRUE(storage.Append("KEY1", "0"));
+    EXPECT_TRUE(storage.Prepend("KEY1", "1"));
+    std::string value;
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_EQ("11010", value);
+    EXPECT_EQ(DeltaResult::Stored, storage.Decrement("KEY1", 10, result));
+    EXPECT_EQ(11000, result);
+
+    EXPECT_TRUE(storage.Set("KEY1", "abc"));
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_EQ("abc", value);
+    EXPECT_EQ(DeltaResult::NonNumeric, storage.Increment("KEY1", 1, result));
+}
+
+TEST(CounterTest, Accounting) {
+    SimpleLRU storage(32);
+
+    uint64_t result = 0;
+    EXPECT_TRUE(storage.Put("KEY1", "1"));
+    EXPECT_TRUE(storage.Put("KEY2", std::string(20, 'x')));
+
+    // Binary counter takes 8 bytes, so there is no room for KEY2 anymore
+    EXPECT_EQ(DeltaResult::Stored, storage.Increment("KEY1", 1, result));
+    std::string value;
+    EXPECT_FALSE(storage.Get("KEY2", value));
+
+    std::map<std::string, std::string> stats;
+    storage.Stats(stats);
+    EXPECT_EQ("12", stats["bytes"]);
+
+    SimpleLRU tiny(8);
+    EXPECT_TRUE(tiny.Put("KEY1", "1"));
+    EXPECT_EQ(DeltaResult::NotStored, tiny.Increment("KEY1", 1, result));
+}
+
+TEST(CounterTest, TinyLFU) {
+    TinyLFU storage(std::make_shared<SimpleSLRU>(1024), 16);
+
+    uint64_t result = 0;
+    EXPECT_TRUE(storage.Put("KEY1", "1"));
+    EXPECT_EQ(DeltaResult::Stored, storage.Increment("KEY1", 41, result));
+    EXPECT_EQ(42, result);
+
+    std::string value;
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_EQ("42", value);
+}
@@ -0,0 +1,228 @@
+#include "gtest/gtest.h"
+#include <atomic>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "storage/CuckooClock.h"
+
+using namespace Afina;
+using namespace Afina::Backend;
+using namespace std;
+
+// Cache of a single slab page
+static const size_t kOnePage = Allocator::Slab::kPageSize;
+
+static uint32_t fake_now = 0;
+static uint32_t fake_clock() { return fake_now; }
+
+static std::string make_key(size_t i) {
+    std::string key = "key" + std::to_string(i);
+    return key + std::string(12 - key.size(), '_');
+}
+
+TEST(CuckooClockTest, PutGetDelete) {
+    CuckooClock storage;
+
+    EXPECT_TRUE(storage.Put("KEY1", "val1"));
+    EXPECT_TRUE(storage.Put("KEY2", "val2"));
+    EXPECT_FALSE(storage.PutIfAbsent("KEY1", "val3"));
+    EXPECT_TRUE(storage.Set("KEY2", "value4"));
+    EXPECT_FALSE(storage.Set("KEY3", "val5"));
+
+    std::string value;
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_EQ("val1", value);
+    EXPECT_TRUE(storage.Get("KEY2", value));
+    EXPECT_EQ("value4", value);
+
+    EXPECT_TRUE(storage.Delete("KEY1"));
+    EXPECT_FALSE(storage.Get("KEY1", value));
+    EXPECT_TRUE(storage.Delete("KEY2"));
+    EXPECT_FALSE(storage.Delete("KEY2"));
+
+    std::map<std::string, std::string> stats;
+    storage.Stats(stats);
+    EXPECT_EQ("0", stats["curr_items"]);
+    EXPECT_EQ("0", stats["bytes"]);
+    EXPECT_EQ(stats["slab_pages"], stats["slab_free_pages"]);
+}
+
+TEST(CuckooClockTest, CrowdedTableDisplaces) {
+    CuckooClock storage(kOnePage);
+
+    // Table has a slot per smallest chunk, items of the smallest class fill 95% of it
+    std::map<std::string, std::string> stats;
+    storage.Stats(stats);
+    const size_t n = std::stoul(stats["hash_buckets"]) * 4 * 95 / 100;
+    for (size_t i = 0; i < n; i++) {
+        EXPECT_TRUE(storage.PutWithTTL(make_key(i), std::to_string(i), 0, uint32_t(i)));
+    }
+
+    storage.Stats(stats);
+    EXPECT_LT(0, std::stoul(stats["cuckoo_displacements"]));
+    size_t found = 0;
+    std::string value;
+    for (size_t i = 0; i < n; i++) {
+        if (storage.Get(make_key(i), value)) {
+            EXPECT_EQ(std::to_string(i), value);
+            found++;
+        }
+    }
+    EXPECT_EQ(std::stoul(stats["curr_items"]), found);
+    EXPECT_EQ(n, found + std::stoul(stats["evictions"]));
+    EXPECT_LT(n * 9 / 10, found);
+}
+
+TEST(CuckooClockTest, ReferencedItemSurvives) {
+    CuckooClock storage(kOnePage);
+
+    // Hot key is read between every put, so CLOCK always finds its bit set
+    const std::string value(100, 'v');
+    EXPECT_TRUE(storage.Put("hot", value));
+    std::string out;
+    size_t n = 0;
+    std::map<std::string, std::string> stats;
+    for (; n < 100000; n++) {
+        EXPECT_TRUE(storage.Get("hot", out));
+        EXPECT_TRUE(storage.Put(make_key(n), value));
+        storage.Stats(stats);
+        if (std::stoul(stats["evictions"]) > 2 * kOnePage / 128) {
+            break;
+        }
+    }
+
+    EXPECT_TRUE(storage.Get("hot", out));
+    EXPECT_EQ(value, out);
+    EXPECT_TRUE(storage.Get(make_key(n), out));
+    EXPECT_FALSE(storage.Get(make_key(0), out));
+}
+
+TEST(CuckooClockTest, StarvedClassTakesPage) {
+    CuckooClock storage(kOnePage);
+
+    // The only page goes to small items, then large one needs it
+    for (size_t i = 0; i < 1000; i++) {
+        EXPECT_TRUE(storage.Put(make_key(i), "small"));
+    }
+    EXPECT_TRUE(storage.Put("large", std::string(200000, 'x')));
+
+    std::string value;
+    EXPECT_TRUE(storage.Get("large", value));
+    EXPECT_EQ(200000, value.size());
+    EXPECT_FALSE(storage.Put("huge", std::string(2 * kOnePage, 'x')));
+}
+
+TEST(CuckooClockTest, StarvedClassEmptiesOnePage) {
+    CuckooClock storage(16 * kOnePage);
+
+    std::map<std::string, std::string> stats;
+    for (size_t i = 0; i < 400000; i++) {
+        EXPECT_TRUE(storage.Put(make_key(i), std::string(40, 'v')));
+    }
+    storage.Stats(stats);
+    const size_t before = std::stoul(stats["curr_items"]);
+    EXPECT_LT(0, std::stoul(stats["evictions"]));
+
+    // Large item takes a single page of small ones
+    EXPECT_TRUE(storage.Put("large", std::string(3000, 'l')));
+    storage.Stats(stats);
+    EXPECT_LT(before * 7 / 8, std::stoul(stats["curr_items"]));
+
+    std::string value;
+    EXPECT_TRUE(storage.Get("large", value));
+    EXPECT_TRUE(storage.Get(make_key(399999), value));
+}
+
+TEST(CuckooClockTest, Expiration) {
+    fake_now = 100;
+    CuckooClock storage(kOnePage, 1.25, fake_clock);
+
+    EXPECT_TRUE(storage.PutWithTTL("KEY1", "val1", 10, 0));
+    EXPECT_TRUE(storage.Put("KEY2", "val2"));
+    EXPECT_TRUE(storage.Append("KEY1", "+"));
+
+    std::string value;
+    fake_now = 109;
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_EQ("val1+", value);
+
+    fake_now = 110;
+    EXPECT_FALSE(storage.Get("KEY1", value));
+    EXPECT_TRUE(storage.PutIfAbsent("KEY1", "val3"));
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_EQ("val3", value);
+    EXPECT_TRUE(storage.Get("KEY2", value));
+}
+
+TEST(CuckooClockTest, CompareAndSwap) {
+    CuckooClock storage;
+
+    EXPECT_EQ(CasResult::NotFound, storage.CompareAndSwap("KEY1", "val", 0, 0, 1));
+    EXPECT_TRUE(storage.PutWithTTL("KEY1", "val1", 0, 3));
+
+    std::vector<ValueView> values;
+    std::vector<ValueInfo> infos;
+    storage.MultiGetWithInfo({"KEY1"}, values, infos);
+    EXPECT_EQ(3, infos[0].flags);
+    uint64_t cas = infos[0].cas;
+
+    EXPECT_EQ(CasResult::Exists, storage.CompareAndSwap("KEY1", "val2", 0, 0, cas + 1));
+    EXPECT_EQ(CasResult::Stored, storage.CompareAndSwap("KEY1", "val2", 0, 5, cas));
+    EXPECT_EQ(CasResult::Exists, storage.CompareAndSwap("KEY1", "val3", 0, 0, cas));
+
+    storage.MultiGetWithInfo({"KEY1"}, values, infos);
+    EXPECT_EQ("val2", values[0].str());
+    EXPECT_EQ(5, infos[0].flags);
+    EXPECT_NE(cas, infos[0].cas);
+}
+
+TEST(CuckooClockTest, ReadersSeeWholeValues) {
+    const size_t n_readers = 4, n_keys = 2000;
+    CuckooClock storage(8 * kOnePage);
+
+    // Value is the key repeated, its length changes on every write, so torn read is easy to spot
+    auto make_value = [](const std::string &key, size_t round) {
+        std::string value;
+        for (size_t i = 0; i <= round % 5; i++) {
+            value += key;
+        }
+        return value;
+    };
+
+    std::atomic<bool> done(false);
+    std::vector<std::thread> readers;
+    for (size_t t = 0; t < n_readers; t++) {
+        readers.emplace_back([&, t]() {
+            std::string value;
+            size_t i = t;
+            while (!done.load()) {
+                std::string key = make_key(i++ % n_keys);
+                if (!storage.Get(key, value)) {
+                    continue;
+                }
+                ASSERT_EQ(0, value.size() % key.size()) << key;
+                for (size_t j = 0; j < value.size(); j += key.size()) {
+                    ASSERT_EQ(key, value.substr(j, key.size()));
+                }
+            }
+        });
+    }
+
+    // Writer keeps moving keys around and reusing memory of old values
+    for (size_t round = 0; round < 10; round++) {
+        for (size_t i = 0; i < n_keys; i++) {
+            std::string key = make_key(i);
+            if ((i + round) % 7 == 0) {
+                storage.Delete(key);
+            } else {
+                storage.Put(key, make_value(key, round + i));
+            }
+        }
+    }
+    done.store(true);
+    for (auto &t : readers) {
+        t.join();
+    }
+}
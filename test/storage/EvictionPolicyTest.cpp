@@ -0,0 +1,143 @@
+#include "gtest/gtest.h"
+#include <map>
+#include <string>
+
+#include "storage/SimpleLRU.h"
+
+using namespace Afina::Backend;
+using namespace std;
+
+template <typename T> class EvictionPolicyTest : public ::testing::Test {};
+
+typedef ::testing::Types<SimpleLRU, SimpleSLRU, SimpleARC, SimpleLFU> AllStorages;
+TYPED_TEST_CASE(EvictionPolicyTest, AllStorages);
+
+static std::string make_key(size_t i) {
+    std::string result = "k" + std::to_string(i);
+    result.resize(4, '_');
+    return result;
+}
+
+TYPED_TEST(EvictionPolicyTest, PutGetDelete) {
+    TypeParam storage;
+
+    EXPECT_TRUE(storage.Put("KEY1", "val1"));
+    EXPECT_TRUE(storage.Put("KEY2", "val2"));
+    EXPECT_FALSE(storage.PutIfAbsent("KEY1", "val3"));
+    EXPECT_TRUE(storage.Set("KEY2", "value4"));
+    EXPECT_FALSE(storage.Set("KEY3", "val5"));
+
+    std::string value;
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_EQ("val1", value);
+    EXPECT_TRUE(storage.Get("KEY2", value));
+    EXPECT_EQ("value4", value);
+
+    EXPECT_TRUE(storage.Delete("KEY1"));
+    EXPECT_FALSE(storage.Get("KEY1", value));
+    EXPECT_FALSE(storage.Delete("KEY1"));
+}
+
+TYPED_TEST(EvictionPolicyTest, StaysWithinBudget) {
+    TypeParam storage(20 * 8);
+
+    std::string value;
+    for (size_t i = 0; i < 1000; i++) {
+        EXPECT_TRUE(storage.Put(make_key(i % 50), "val_"));
+        storage.Get(make_key((i * 7) % 50), value);
+        if (i % 3 == 0) {
+            EXPECT_TRUE(storage.Set(make_key(i % 50), std::string(i % 20, 'x')));
+        }
+    }
+
+    // The last put key is always there
+    EXPECT_TRUE(storage.Get(make_key(999 % 50), value));
+
+    size_t found = 0;
+    for (size_t i = 0; i < 50; i++) {
+        found += storage.Get(make_key(i), value) ? 1 : 0;
+    }
+    EXPECT_LE(found, 20);
+}
+
+template <typename T> class ScanResistanceTest : public ::testing::Test {};
+
+typedef ::testing::Types<SimpleSLRU, SimpleARC, SimpleLFU> ScanResistantStorages;
+TYPED_TEST_CASE(ScanResistanceTest, ScanResistantStorages);
+
+TYPED_TEST(ScanResistanceTest, ScanKeepsHotKeys) {
+    TypeParam storage(20 * 8);
+
+    std::string value;
+    for (size_t round = 0; round < 3; round++) {
+        for (size_t i = 0; i < 5; i++) {
+            if (!storage.Get(make_key(i), value)) {
+                storage.Put(make_key(i), "hot_");
+            }
+        }
+    }
+
+    // One pass over many cold keys
+    for (size_t i = 100; i < 200; i++) {
+        storage.Put(make_key(i), "cold");
+    }
+
+    for (size_t i = 0; i < 5; i++) {
+        EXPECT_TRUE(storage.Get(make_key(i), value));
+    }
+}
+
+template <typename T> class SegmentBytesTest : public ::testing::Test {};
+
+typedef ::testing::Types<SimpleSLRU, SimpleARC> SegmentedStorages;
+TYPED_TEST_CASE(SegmentBytesTest, SegmentedStorages);
+
+// Bytes of resident items as counted by policy segments
+static size_t segment_bytes(Afina::Storage &storage) {
+    std::map<std::string, std::string> stats;
+    storage.Stats(stats);
+    size_t result = 0;
+    for (const char *name : {"slru_probation_bytes", "slru_protected_bytes", "arc_t1_bytes", "arc_t2_bytes"}) {
+        if (stats.count(name)) {
+            result += std::stoull(stats[name]);
+        }
+    }
+    return result;
+}
+
+static size_t cache_bytes(Afina::Storage &storage) {
+    std::map<std::string, std::string> stats;
+    storage.Stats(stats);
+    return std::stoull(stats["bytes"]);
+}
+
+TYPED_TEST(SegmentBytesTest, TracksInPlaceResize) {
+    TypeParam storage(1000);
+
+    std::string value;
+    EXPECT_TRUE(storage.Put("a", "val"));
+    EXPECT_TRUE(storage.Get("a", value));
+    EXPECT_EQ(cache_bytes(storage), segment_bytes(storage));
+
+    EXPECT_TRUE(storage.Append("a", std::string(50, 'x')));
+    EXPECT_TRUE(storage.Append("a", std::string(5, 'y')));
+    EXPECT_EQ(1 + 3 + 50 + 5, segment_bytes(storage));
+    EXPECT_EQ(cache_bytes(storage), segment_bytes(storage));
+
+    // Shorter value fits into the same block
+    EXPECT_TRUE(storage.Set("a", "short"));
+    EXPECT_EQ(1 + 5, segment_bytes(storage));
+    EXPECT_EQ(cache_bytes(storage), segment_bytes(storage));
+
+    // Counter is stored as 8 byte binary value
+    uint64_t result = 0;
+    EXPECT_TRUE(storage.Set("a", "41"));
+    EXPECT_EQ(Afina::DeltaResult::Stored, storage.Increment("a", 1, result));
+    EXPECT_EQ(42, result);
+    EXPECT_EQ(1 + 8, segment_bytes(storage));
+    EXPECT_EQ(cache_bytes(storage), segment_bytes(storage));
+
+    EXPECT_TRUE(storage.Delete("a"));
+    EXPECT_EQ(0, segment_bytes(storage));
+    EXPECT_EQ(0, cache_bytes(storage));
+}
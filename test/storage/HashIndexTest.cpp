@@ -0,0 +1,91 @@
+#include "gtest/gtest.h"
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "storage/HashIndex.h"
+
+using namespace Afina::Backend;
+using namespace std;
+
+namespace {
+
+struct Node {
+    std::string key;
+};
+
+struct NodeTraits {
+    static bool equals(const Node *node, const char *key, size_t size) {
+        return node->key.size() == size && std::memcmp(node->key.data(), key, size) == 0;
+    }
+};
+
+using Index = HashIndex<Node, NodeTraits>;
+
+} // namespace
+
+TEST(HashIndexTest, InsertFindErase) {
+    Index index;
+    Node a{"a"}, b{"b"};
+
+    EXPECT_EQ(nullptr, index.find(hash_key(a.key), a.key));
+    index.insert(hash_key(a.key), &a);
+    index.insert(hash_key(b.key), &b);
+    EXPECT_EQ(&a, index.find(hash_key(a.key), a.key));
+    EXPECT_EQ(&b, index.find(hash_key(b.key), b.key));
+    EXPECT_EQ(2, index.size());
+
+    EXPECT_TRUE(index.erase(hash_key(a.key), &a));
+    EXPECT_FALSE(index.erase(hash_key(a.key), &a));
+    EXPECT_EQ(nullptr, index.find(hash_key(a.key), a.key));
+    EXPECT_EQ(&b, index.find(hash_key(b.key), b.key));
+    EXPECT_EQ(1, index.size());
+}
+
+TEST(HashIndexTest, Replace) {
+    Index index;
+    Node a{"a"}, a2{"a"};
+
+    index.insert(hash_key(a.key), &a);
+    EXPECT_TRUE(index.replace(hash_key(a.key), &a, &a2));
+    EXPECT_EQ(&a2, index.find(hash_key(a.key), a.key));
+    EXPECT_FALSE(index.replace(hash_key(a.key), &a, &a2));
+}
+
+// All keys get one of two adjacent hashes, so they form a single cluster and backward shift
+// deletion gets exercised
+TEST(HashIndexTest, EraseInsideCluster) {
+    Index index;
+    std::vector<Node> nodes(10);
+    for (size_t i = 0; i < nodes.size(); i++) {
+        nodes[i].key = "key" + std::to_string(i);
+        index.insert(i < 5 ? 3 : 4, &nodes[i]);
+    }
+
+    EXPECT_TRUE(index.erase(3, &nodes[0]));
+    EXPECT_TRUE(index.erase(4, &nodes[6]));
+    for (size_t i = 0; i < nodes.size(); i++) {
+        Node *expected = (i == 0 || i == 6) ? nullptr : &nodes[i];
+        EXPECT_EQ(expected, index.find(i < 5 ? 3 : 4, nodes[i].key));
+    }
+}
+
+TEST(HashIndexTest, GrowAndShrink) {
+    Index index;
+    const size_t n = 100000;
+    std::vector<Node> nodes(n);
+    for (size_t i = 0; i < n; i++) {
+        nodes[i].key = "key" + std::to_string(i);
+        index.insert(hash_key(nodes[i].key), &nodes[i]);
+    }
+    EXPECT_EQ(n, index.size());
+
+    for (size_t i = 0; i < n; i += 2) {
+        EXPECT_TRUE(index.erase(hash_key(nodes[i].key), &nodes[i]));
+    }
+    for (size_t i = 0; i < n; i++) {
+        Node *expected = (i % 2 == 0) ? nullptr : &nodes[i];
+        EXPECT_EQ(expected, index.find(hash_key(nodes[i].key), nodes[i].key));
+    }
+    EXPECT_EQ(n / 2, index.size());
+}
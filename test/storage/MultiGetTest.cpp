@@ -0,0 +1,69 @@
+#include "gtest/gtest.h"
+#include <string>
+#include <vector>
+
+#include "storage/ClockLRU.h"
+#include "storage/CompactLRU.h"
+#include "storage/CuckooClock.h"
+#include "storage/SimpleLRU.h"
+#include "storage/SlabLRU.h"
+#include "storage/StripedLRU.h"
+#include "storage/ThreadSafeClockLRU.h"
+#include "storage/ThreadSafeSimpleLRU.h"
+#include "storage/ThreadSafeSlabLRU.h"
+
+using namespace Afina;
+using namespace Afina::Backend;
+using namespace std;
+
+template <typename T> class MultiGetTest : public ::testing::Test {};
+
+typedef ::testing::Types<SimpleLRU, ThreadSafeSimplLRU, StripedLRU, ClockLRU, ThreadSafeClockLRU, SlabLRU,
+                         ThreadSafeSlabLRU, CompactLRU, CuckooClock>
+    BatchStorages;
+TYPED_TEST_CASE(MultiGetTest, BatchStorages);
+
+TYPED_TEST(MultiGetTest, HitsAndMisses) {
+    TypeParam storage;
+
+    std::vector<std::string> keys, values;
+    for (int i = 0; i < 40; i++) {
+        keys.push_back("KEY" + to_string(i));
+        values.push_back("val" + to_string(i));
+    }
+    values[7].clear();
+    EXPECT_TRUE(storage.MultiPut(keys, values));
+
+    // Every 3rd key is absent, one key is asked twice
+    std::vector<std::string> request;
+    for (int i = 0; i < 60; i++) {
+        request.push_back((i % 3 == 2) ? "NONE" + to_string(i) : "KEY" + to_string(i % 40));
+    }
+    request.push_back("KEY0");
+
+    std::vector<ValueView> found;
+    storage.MultiGet(request, found);
+    ASSERT_EQ(request.size(), found.size());
+    for (size_t i = 0; i < request.size(); i++) {
+        std::string value;
+        if (storage.Get(request[i], value)) {
+            ASSERT_NE(nullptr, found[i].data()) << request[i];
+            EXPECT_EQ(value, found[i].str());
+        } else {
+            EXPECT_EQ(nullptr, found[i].data()) << request[i];
+        }
+    }
+    EXPECT_NE(nullptr, found[7].data());
+    EXPECT_EQ(0, found[7].size());
+    EXPECT_EQ("val0", found.back().str());
+}
+
+TEST(MultiGetTest, OversizedPut) {
+    SimpleLRU storage(16);
+    EXPECT_FALSE(storage.MultiPut({"KEY1", "KEY2"}, {"val1", std::string(20, 'x')}));
+
+    std::vector<ValueView> found;
+    storage.MultiGet({"KEY1", "KEY2"}, found);
+    EXPECT_EQ("val1", found[0].str());
+    EXPECT_EQ(nullptr, found[1].data());
+}
@@ -0,0 +1,314 @@
+#include "gtest/gtest.h"
+#include <chrono>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "storage/SlabLRU.h"
+#include "storage/ThreadSafeSlabLRU.h"
+
+using namespace Afina;
+using namespace Afina::Backend;
+using namespace std;
+
+// Cache of a single slab page
+static const size_t kOnePage = Allocator::Slab::kPageSize;
+
+static std::string make_key(size_t i) {
+    std::string key = "key" + std::to_string(i);
+    return key + std::string(12 - key.size(), '_');
+}
+
+TEST(SlabLRUTest, PutGetDelete) {
+    SlabLRU storage;
+
+    EXPECT_TRUE(storage.Put("KEY1", "val1"));
+    EXPECT_TRUE(storage.Put("KEY2", "val2"));
+    EXPECT_FALSE(storage.PutIfAbsent("KEY1", "val3"));
+    EXPECT_TRUE(storage.Set("KEY2", "value4"));
+    EXPECT_FALSE(storage.Set("KEY3", "val5"));
+
+    std::string value;
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_EQ("val1", value);
+    EXPECT_TRUE(storage.Get("KEY2", value));
+    EXPECT_EQ("value4", value);
+
+    EXPECT_TRUE(storage.Delete("KEY1"));
+    EXPECT_FALSE(storage.Get("KEY1", value));
+    EXPECT_TRUE(storage.Delete("KEY2"));
+    EXPECT_FALSE(storage.Delete("KEY2"));
+
+    std::map<std::string, std::string> stats;
+    storage.Stats(stats);
+    EXPECT_EQ("0", stats["curr_items"]);
+    EXPECT_EQ("0", stats["bytes"]);
+    EXPECT_EQ(stats["slab_pages"], stats["slab_free_pages"]);
+}
+
+TEST(SlabLRUTest, EvictsLeastRecentlyUsedOfClass) {
+    SlabLRU storage(kOnePage);
+
+    const size_t n_keys = 20000;
+    const std::string value(32, 'v');
+    std::string got;
+    for (size_t i = 0; i < n_keys; i++) {
+        EXPECT_TRUE(storage.Put(make_key(i), value));
+        if (i % 100 == 0) {
+            EXPECT_TRUE(storage.Get(make_key(0), got));
+        }
+    }
+
+    std::map<std::string, std::string> stats;
+    storage.Stats(stats);
+    size_t items = std::stoul(stats["curr_items"]);
+    EXPECT_LT(items, n_keys);
+    EXPECT_EQ(n_keys - items, std::stoul(stats["evictions"]));
+    EXPECT_EQ("0", stats["slab_free_pages"]);
+
+    EXPECT_TRUE(storage.Get(make_key(0), got));
+    EXPECT_FALSE(storage.Get(make_key(1), got));
+    EXPECT_TRUE(storage.Get(make_key(n_keys - 1), got));
+
+    // Victim is reported within the class of the new value only
+    std::string victim;
+    EXPECT_TRUE(storage.EvictionCandidate("new_key", value, victim));
+    EXPECT_NE(make_key(0), victim);
+    EXPECT_FALSE(storage.EvictionCandidate("new_key", std::string(1000, 'v'), victim));
+}
+
+TEST(SlabLRUTest, StarvedClassTakesPage) {
+    SlabLRU storage(kOnePage);
+
+    // Small items take the only page, large value has nothing to evict in its class
+    EXPECT_TRUE(storage.Put("KEY1", "val1"));
+    EXPECT_TRUE(storage.Put("KEY2", "val2"));
+    EXPECT_TRUE(storage.Put("KEY3", std::string(1000, 'v')));
+
+    std::string value;
+    EXPECT_FALSE(storage.Get("KEY1", value));
+    EXPECT_TRUE(storage.Get("KEY3", value));
+    EXPECT_EQ(std::string(1000, 'v'), value);
+
+    std::map<std::string, std::string> stats;
+    storage.Stats(stats);
+    EXPECT_EQ("1", stats["slab_pages_moved"]);
+    EXPECT_EQ("2", stats["slab_move_evictions"]);
+
+    // Value doesn't fit into the largest class, failed update doesn't leave stale value behind
+    EXPECT_FALSE(storage.Put("KEY4", std::string(2 * kOnePage, 'v')));
+    EXPECT_FALSE(storage.Set("KEY3", std::string(kOnePage - 64, 'v')));
+    EXPECT_FALSE(storage.Get("KEY3", value));
+}
+
+// Number of pages of every class that has them
+static std::map<std::string, size_t> class_pages(Afina::Storage &storage) {
+    std::map<std::string, std::string> stats;
+    storage.Stats(stats);
+    std::map<std::string, size_t> pages;
+    for (auto &stat : stats) {
+        if (stat.first.compare(0, 11, "slab_class_") == 0) {
+            pages[stat.first] = std::stoul(stat.second);
+        }
+    }
+    return pages;
+}
+
+TEST(SlabLRUTest, RebalanceMovesColdPages) {
+    SlabLRU storage(3 * kOnePage);
+    const std::string small(32, 's'), large(1000, 'l');
+
+    size_t n_small = 0, n_large = 0;
+    std::map<std::string, std::string> stats;
+    do {
+        EXPECT_TRUE(storage.Put(make_key(n_small++), small));
+        storage.Stats(stats);
+    } while (stats["evictions"] == "0");
+    EXPECT_FALSE(storage.Rebalance());
+
+    // First large value takes page right away, others evict within their class
+    for (size_t i = 0; i < 3000; i++) {
+        EXPECT_TRUE(storage.Put(make_key(n_small + n_large++), large));
+    }
+    storage.Stats(stats);
+    EXPECT_EQ("1", stats["slab_pages_moved"]);
+
+    // Small items are idle, so one more of their pages goes to large ones
+    std::map<std::string, size_t> pages_before = class_pages(storage);
+    EXPECT_TRUE(storage.Rebalance());
+    storage.Stats(stats);
+    EXPECT_EQ("2", stats["slab_pages_moved"]);
+    EXPECT_EQ("0", stats["slab_free_pages"]);
+    std::map<std::string, size_t> pages_after = class_pages(storage);
+    EXPECT_EQ(2, pages_after.size());
+    size_t grown = 0;
+    for (auto &cls : pages_after) {
+        grown += (cls.second == pages_before[cls.first] + 1) ? 1 : 0;
+    }
+    EXPECT_EQ(1, grown);
+
+    // Nothing happened since, nothing to move
+    EXPECT_FALSE(storage.Rebalance());
+
+    // Page stays with large items even if small ones come first
+    std::string value;
+    EXPECT_FALSE(storage.Get(make_key(0), value));
+    EXPECT_TRUE(storage.Put(make_key(0), small));
+    EXPECT_EQ(pages_after, class_pages(storage));
+    EXPECT_TRUE(storage.Put(make_key(n_small + n_large), large));
+    EXPECT_TRUE(storage.Get(make_key(n_small + n_large), value));
+    storage.Stats(stats);
+    EXPECT_EQ("2", stats["slab_pages_moved"]);
+
+    // Small items of the last page are still there
+    size_t small_left = 0;
+    for (size_t i = 0; i < n_small; i++) {
+        small_left += storage.Get(make_key(i), value) ? 1 : 0;
+    }
+    EXPECT_GT(small_left, 0);
+    EXPECT_LT(small_left, n_small / 2);
+}
+
+TEST(SlabLRUTest, PinnedPageIsNotCountedAsMoved) {
+    SlabLRU storage(3 * kOnePage);
+    const std::string small(32, 's'), large(1000, 'l');
+
+    size_t n_small = 0, n_large = 0;
+    std::map<std::string, std::string> stats;
+    do {
+        EXPECT_TRUE(storage.Put(make_key(n_small++), small));
+        storage.Stats(stats);
+    } while (stats["evictions"] == "0");
+    EXPECT_FALSE(storage.Rebalance());
+    for (size_t i = 0; i < 3000; i++) {
+        EXPECT_TRUE(storage.Put(make_key(n_small + n_large++), large));
+    }
+    storage.Stats(stats);
+    EXPECT_EQ("1", stats["slab_pages_moved"]);
+    std::string move_evictions = stats["slab_move_evictions"];
+
+    // Views of small items keep their page even once the items are evicted, so the page can't move
+    std::vector<ValueView> views(n_small);
+    for (size_t i = 0; i < n_small; i++) {
+        storage.GetView(make_key(i), views[i]);
+    }
+    for (size_t i = 0; i < 3000; i++) {
+        EXPECT_TRUE(storage.Put(make_key(n_small + n_large++), large));
+    }
+    EXPECT_FALSE(storage.Rebalance());
+    storage.Stats(stats);
+    EXPECT_EQ("1", stats["slab_pages_moved"]);
+    EXPECT_NE(move_evictions, stats["slab_move_evictions"]);
+
+    // Page goes back to the pool with the last view
+    views.clear();
+    storage.Stats(stats);
+    EXPECT_EQ("1", stats["slab_free_pages"]);
+}
+
+TEST(SlabLRUTest, BackgroundRebalancer) {
+    ThreadSafeSlabLRU storage(3 * kOnePage, 1.25, steady_seconds, std::chrono::milliseconds(10));
+    storage.Start();
+
+    const std::string small(32, 's'), large(1000, 'l');
+    for (size_t i = 0; i < 30000; i++) {
+        EXPECT_TRUE(storage.Put(make_key(i), small));
+    }
+
+    // Large values keep evicting until rebalancer gives them one more page of idle small items
+    std::map<std::string, std::string> stats;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    for (size_t i = 0; std::chrono::steady_clock::now() < deadline; i++) {
+        EXPECT_TRUE(storage.Put(make_key(30000 + i % 5000), large));
+        storage.Stats(stats);
+        if (stats["slab_pages_moved"] != "0" && stats["slab_pages_moved"] != "1") {
+            break;
+        }
+    }
+    storage.Stop();
+    EXPECT_EQ("2", stats["slab_pages_moved"]);
+}
+
+TEST(SlabLRUTest, ValueMovesBetweenClasses) {
+    SlabLRU storage;
+
+    EXPECT_TRUE(storage.PutWithTTL("KEY1", "val", 0, 7));
+    std::string expected = "val";
+    for (int i = 0; i < 200; i++) {
+        std::string piece = "piece" + to_string(i);
+        EXPECT_TRUE(storage.Append("KEY1", piece));
+        expected += piece;
+    }
+    EXPECT_TRUE(storage.Prepend("KEY1", "head"));
+    expected = "head" + expected;
+
+    std::vector<ValueView> values;
+    std::vector<ValueInfo> infos;
+    storage.MultiGetWithInfo({"KEY1"}, values, infos);
+    EXPECT_EQ(expected, values[0].str());
+    EXPECT_EQ(7, infos[0].flags);
+    EXPECT_NE(nullptr, infos[0].header);
+
+    std::map<std::string, std::string> stats;
+    storage.Stats(stats);
+    EXPECT_EQ(to_string(4 + expected.size()), stats["bytes"]);
+
+    // View keeps its chunk, the value shrinks into the smaller class
+    EXPECT_TRUE(storage.Set("KEY1", "short"));
+    std::string value;
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_EQ("short", value);
+    EXPECT_EQ(expected, values[0].str());
+
+    uint64_t number;
+    EXPECT_TRUE(storage.Set("KEY1", "41"));
+    EXPECT_EQ(DeltaResult::Stored, storage.Increment("KEY1", 1, number));
+    EXPECT_EQ(42, number);
+    storage.Stats(stats);
+    EXPECT_EQ(to_string(4 + sizeof(uint64_t)), stats["bytes"]);
+}
+
+TEST(SlabLRUTest, ConcurrentWriters) {
+    const size_t n_keys = 1000;
+    ThreadSafeSlabLRU storage(kOnePage);
+
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < 4; t++) {
+        threads.emplace_back([&storage, t]() {
+            std::string value;
+            for (size_t i = 0; i < n_keys; i++) {
+                std::string key = make_key(t * n_keys + i);
+                EXPECT_TRUE(storage.Put(key, std::to_string(i)));
+                EXPECT_TRUE(storage.Get(key, value));
+                EXPECT_EQ(std::to_string(i), value);
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    std::map<std::string, std::string> stats;
+    storage.Stats(stats);
+    EXPECT_EQ(to_string(4 * n_keys), stats["curr_items"]);
+}
+
+TEST(SlabLRUTest, StartPrefaultsRegion) {
+    SlabLRU storage(4 * kOnePage, 1.25, steady_seconds, Allocator::HugePages::Transparent);
+    EXPECT_TRUE(storage.Put("KEY1", "val1"));
+
+    std::map<std::string, std::string> stats;
+    storage.Stats(stats);
+    EXPECT_EQ(0, stats.count("prefault_ms"));
+
+    // Prefaulting keeps what is already stored
+    storage.Start();
+    storage.Stats(stats);
+    EXPECT_EQ(1, stats.count("prefault_ms"));
+    EXPECT_TRUE(stats["huge_pages"] == "transparent" || stats["huge_pages"] == "none");
+
+    std::string value;
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_EQ("val1", value);
+}
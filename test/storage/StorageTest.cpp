@@ -195,3 +195,55 @@ TEST(StorageTest, MaxTest) {
         EXPECT_FALSE(storage.Get(key, res));
     }
 }
+
+TEST(StorageTest, SetResizeEvicts) {
+    SimpleLRU storage(32);
+
+    EXPECT_TRUE(storage.Put("KEY1", "val1"));
+    EXPECT_TRUE(storage.Put("KEY2", "val2"));
+    EXPECT_TRUE(storage.Put("KEY3", "val3"));
+
+    // Value grows, so least recently used KEY2 has to go away
+    EXPECT_TRUE(storage.Set("KEY1", "long value 11"));
+
+    std::string value;
+    EXPECT_FALSE(storage.Get("KEY2", value));
+    EXPECT_TRUE(storage.Get("KEY3", value));
+    EXPECT_TRUE(value == "val3");
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_TRUE(value == "long value 11");
+
+    // Value shrinks, nothing evicted
+    EXPECT_TRUE(storage.Set("KEY1", "v"));
+    EXPECT_TRUE(storage.Put("KEY4", "val4"));
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_TRUE(value == "v");
+    EXPECT_TRUE(storage.Get("KEY3", value));
+}
+
+TEST(StorageTest, ViewOutlivesItem) {
+    SimpleLRU storage(32);
+
+    EXPECT_TRUE(storage.Put("KEY1", "val1"));
+    EXPECT_TRUE(storage.Put("KEY2", "val2"));
+
+    Afina::ValueView first, second, missing;
+    EXPECT_TRUE(storage.GetView("KEY1", first));
+    EXPECT_TRUE(storage.GetView("KEY2", second));
+    EXPECT_FALSE(storage.GetView("KEY3", missing));
+    EXPECT_EQ("val1", first.str());
+
+    // Same size value would be copied in place if there were no view
+    EXPECT_TRUE(storage.Set("KEY1", "VAL1"));
+    EXPECT_TRUE(storage.Delete("KEY2"));
+    for (int i = 0; i < 10; i++) {
+        EXPECT_TRUE(storage.Put("KEY" + std::to_string(i + 10), "value"));
+    }
+
+    EXPECT_EQ("val1", first.str());
+    EXPECT_EQ("val2", second.str());
+
+    Afina::ValueView moved(std::move(first));
+    EXPECT_EQ(nullptr, first.data());
+    EXPECT_EQ("val1", moved.str());
+}
@@ -0,0 +1,61 @@
+#include "gtest/gtest.h"
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "storage/StripedLRU.h"
+
+using namespace Afina::Backend;
+using namespace std;
+
+TEST(StripedLRUTest, PutGetDelete) {
+    StripedLRU storage(1024, 4);
+
+    EXPECT_TRUE(storage.Put("KEY1", "val1"));
+    EXPECT_TRUE(storage.Put("KEY2", "val2"));
+    EXPECT_FALSE(storage.PutIfAbsent("KEY1", "val3"));
+    EXPECT_TRUE(storage.Set("KEY2", "val4"));
+    EXPECT_FALSE(storage.Set("KEY3", "val5"));
+
+    std::string value;
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_EQ("val1", value);
+    EXPECT_TRUE(storage.Get("KEY2", value));
+    EXPECT_EQ("val4", value);
+
+    EXPECT_TRUE(storage.Delete("KEY1"));
+    EXPECT_FALSE(storage.Get("KEY1", value));
+    EXPECT_FALSE(storage.Delete("KEY1"));
+}
+
+TEST(StripedLRUTest, ShardBudget) {
+    // Each shard holds at most 64 bytes, so an item that fits into whole cache but not into a shard
+    // must be rejected
+    StripedLRU storage(256, 4);
+    EXPECT_FALSE(storage.Put("KEY", std::string(100, 'x')));
+    EXPECT_TRUE(storage.Put("KEY", std::string(32, 'x')));
+}
+
+TEST(StripedLRUTest, ConcurrentAccess) {
+    const size_t n_threads = 8, n_keys = 1000;
+    StripedLRU storage(n_threads * n_keys * 64, 16);
+
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < n_threads; t++) {
+        threads.emplace_back([&storage, t]() {
+            for (size_t i = 0; i < n_keys; i++) {
+                std::string key = "key" + std::to_string(t) + "_" + std::to_string(i);
+                storage.Put(key, key);
+            }
+            std::string value;
+            for (size_t i = 0; i < n_keys; i++) {
+                std::string key = "key" + std::to_string(t) + "_" + std::to_string(i);
+                EXPECT_TRUE(storage.Get(key, value));
+                EXPECT_EQ(key, value);
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+}
@@ -0,0 +1,183 @@
+#include "gtest/gtest.h"
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "storage/ClockLRU.h"
+#include "storage/SimpleLRU.h"
+#include "storage/StripedLRU.h"
+#include "storage/TimingWheel.h"
+#include "storage/TinyLFU.h"
+
+using namespace Afina::Backend;
+using namespace std;
+
+namespace {
+
+// Manually driven clock for the tests below
+uint32_t fake_now = 1;
+uint32_t fake_clock() { return fake_now; }
+
+Item *make_item(const std::string &key, uint32_t expire) {
+    Item *item = Item::create(hash_key(key), key, "value", 0);
+    item->expire = expire;
+    return item;
+}
+
+} // namespace
+
+TEST(TimingWheelTest, ExpiresInOrder) {
+    TimingWheel wheel(100);
+    std::vector<Item *> items = {make_item("a", 101), make_item("b", 150), make_item("c", 100 + 5000),
+                                 make_item("d", 100 + 300000)};
+    for (Item *item : items) {
+        wheel.Schedule(item);
+    }
+    EXPECT_EQ(4, wheel.size());
+
+    std::map<std::string, uint32_t> expired;
+    auto collect = [&](Item *item) { expired[std::string(item->key(), item->key_size)] = wheel.now(); };
+
+    wheel.Advance(100, collect);
+    EXPECT_TRUE(expired.empty());
+
+    wheel.Advance(101, collect);
+    EXPECT_EQ(1, expired.size());
+    EXPECT_EQ(101, expired["a"]);
+
+    wheel.Advance(100 + 400000, collect);
+    EXPECT_EQ(4, expired.size());
+    EXPECT_EQ(150, expired["b"]);
+    EXPECT_EQ(100 + 5000, expired["c"]);
+    EXPECT_EQ(100 + 300000, expired["d"]);
+    EXPECT_EQ(0, wheel.size());
+
+    for (Item *item : items) {
+        Item::release(item);
+    }
+}
+
+TEST(TimingWheelTest, CancelAndPastDeadlines) {
+    TimingWheel wheel(1000);
+    Item *cancelled = make_item("a", 1010);
+    Item *past = make_item("b", 10);
+    Item *far = make_item("c", 1000 + 200 * 24 * 3600);
+    wheel.Schedule(cancelled);
+    wheel.Schedule(past);
+    wheel.Schedule(far);
+    wheel.Cancel(cancelled);
+
+    std::vector<std::string> expired;
+    auto collect = [&](Item *item) { expired.emplace_back(item->key(), item->key_size); };
+
+    // Deadline in the past is reported on the next tick
+    wheel.Advance(1001, collect);
+    ASSERT_EQ(1, expired.size());
+    EXPECT_EQ("b", expired[0]);
+
+    wheel.Advance(1000 + 100 * 24 * 3600, collect);
+    EXPECT_EQ(1, expired.size());
+
+    // Deadline beyond wheel range still fires exactly on time
+    wheel.Advance(1000 + 200 * 24 * 3600 - 1, collect);
+    EXPECT_EQ(1, expired.size());
+    wheel.Advance(1000 + 200 * 24 * 3600, collect);
+    EXPECT_EQ(2, expired.size());
+
+    Item::release(cancelled);
+    Item::release(past);
+    Item::release(far);
+}
+
+template <typename T> class ExpirationTest : public ::testing::Test {};
+
+typedef ::testing::Types<SimpleLRU, SimpleARC, ClockLRU> ExpiringStorages;
+TYPED_TEST_CASE(ExpirationTest, ExpiringStorages);
+
+TYPED_TEST(ExpirationTest, GetAfterDeadline) {
+    fake_now = 1;
+    TypeParam storage(1024, fake_clock);
+
+    EXPECT_TRUE(storage.PutWithTTL("KEY1", "val1", 10, 0));
+    EXPECT_TRUE(storage.Put("KEY2", "val2"));
+    EXPECT_TRUE(storage.PutIfAbsentWithTTL("KEY3", "val3", 20, 0));
+
+    std::string value;
+    fake_now = 10;
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_EQ("val1", value);
+
+    fake_now = 11;
+    EXPECT_FALSE(storage.Get("KEY1", value));
+    EXPECT_FALSE(storage.SetWithTTL("KEY1", "val4", 10, 0));
+    EXPECT_TRUE(storage.PutIfAbsent("KEY1", "val5"));
+
+    // Update without TTL makes item permanent
+    EXPECT_TRUE(storage.Set("KEY3", "val6"));
+
+    fake_now = 1000000;
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_EQ("val5", value);
+    EXPECT_TRUE(storage.Get("KEY2", value));
+    EXPECT_TRUE(storage.Get("KEY3", value));
+    EXPECT_EQ("val6", value);
+}
+
+TYPED_TEST(ExpirationTest, ReclaimsMemory) {
+    fake_now = 1;
+    TypeParam storage(1024, fake_clock);
+
+    for (int i = 0; i < 50; i++) {
+        EXPECT_TRUE(storage.PutWithTTL("KEY" + to_string(i), "val" + to_string(i), 5 + i % 3, 0));
+    }
+    EXPECT_TRUE(storage.Put("LIVE", "value"));
+
+    // Expired items are freed by the next write without being looked up
+    fake_now = 100;
+    EXPECT_TRUE(storage.Put("OTHER", "value"));
+    std::map<std::string, std::string> stats;
+    storage.Stats(stats);
+    EXPECT_EQ("2", stats["curr_items"]);
+    EXPECT_EQ("19", stats["bytes"]);
+}
+
+TEST(ExpirationTest, ExpiredDoesNotEvictLive) {
+    fake_now = 1;
+    SimpleLRU storage(100, fake_clock);
+
+    // 10 bytes each: session items fill 9/10 of the cache
+    for (int i = 0; i < 9; i++) {
+        EXPECT_TRUE(storage.PutWithTTL("SESSION" + to_string(i), "val", 60, 0));
+    }
+    EXPECT_TRUE(storage.Put("PERMANENT", "v"));
+
+    fake_now = 120;
+    for (int i = 0; i < 9; i++) {
+        EXPECT_TRUE(storage.Put("NEWKEY" + to_string(i) + "XX", "a"));
+    }
+
+    std::string value;
+    EXPECT_TRUE(storage.Get("PERMANENT", value));
+}
+
+TEST(ExpirationTest, Decorators) {
+    fake_now = 1;
+    TinyLFU filtered(make_shared<SimpleLRU>(1024, fake_clock), 64);
+    StripedLRU striped(1024, 4);
+
+    EXPECT_TRUE(filtered.PutWithTTL("KEY1", "val1", 10, 0));
+    EXPECT_TRUE(striped.PutWithTTL("KEY1", "val1", 10, 0));
+
+    // Push key out of the window, TTL moves into main cache with it
+    for (int i = 0; i < 10; i++) {
+        EXPECT_TRUE(filtered.Put("KEY" + to_string(i + 2), "val"));
+    }
+
+    std::string value;
+    fake_now = 5;
+    EXPECT_TRUE(filtered.Get("KEY1", value));
+    fake_now = 11;
+    EXPECT_FALSE(filtered.Get("KEY1", value));
+    EXPECT_TRUE(striped.Get("KEY1", value));
+}
@@ -0,0 +1,169 @@
+#include "gtest/gtest.h"
+#include <atomic>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "storage/FrequencySketch.h"
+#include "storage/HashIndex.h"
+#include "storage/SimpleLRU.h"
+#include "storage/ThreadSafeSimpleLRU.h"
+#include "storage/TinyLFU.h"
+
+using namespace Afina;
+using namespace Afina::Backend;
+using namespace std;
+
+TEST(FrequencySketchTest, CountAndReset) {
+    FrequencySketch sketch(1024);
+    uint64_t hot = hash_key("hot"), cold = hash_key("cold");
+
+    EXPECT_EQ(0, sketch.Frequency(hot));
+    for (int i = 0; i < 10; i++) {
+        sketch.Increment(hot);
+    }
+    sketch.Increment(cold);
+    EXPECT_EQ(10, sketch.Frequency(hot));
+    EXPECT_EQ(1, sketch.Frequency(cold));
+
+    // Counters saturate at 15
+    for (int i = 0; i < 10; i++) {
+        sketch.Increment(hot);
+    }
+    EXPECT_EQ(15, sketch.Frequency(hot));
+
+    sketch.Reset();
+    EXPECT_EQ(7, sketch.Frequency(hot));
+    EXPECT_EQ(0, sketch.Frequency(cold));
+}
+
+TEST(FrequencySketchTest, Aging) {
+    FrequencySketch sketch(16);
+    uint64_t old = hash_key("old");
+    for (int i = 0; i < 15; i++) {
+        sketch.Increment(old);
+    }
+
+    // Plenty of other increments make sketch forget about the old key
+    for (int i = 0; i < 10000; i++) {
+        sketch.Increment(hash_key("key" + to_string(i % 64)));
+    }
+    EXPECT_LT(sketch.Frequency(old), 15);
+}
+
+TEST(TinyLFUTest, PutGetDelete) {
+    TinyLFU storage(make_shared<SimpleLRU>(1024), 64);
+
+    EXPECT_TRUE(storage.Put("KEY1", "val1"));
+    EXPECT_TRUE(storage.Put("KEY2", "val2"));
+    EXPECT_FALSE(storage.PutIfAbsent("KEY1", "val3"));
+    EXPECT_TRUE(storage.Set("KEY2", "value4"));
+    EXPECT_FALSE(storage.Set("KEY3", "val5"));
+
+    std::string value;
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_EQ("val1", value);
+    EXPECT_TRUE(storage.Get("KEY2", value));
+    EXPECT_EQ("value4", value);
+
+    // Value larger than the window goes to main cache directly
+    std::string big(100, 'x');
+    EXPECT_TRUE(storage.Put("KEY1", big));
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_EQ(big, value);
+
+    EXPECT_TRUE(storage.Delete("KEY1"));
+    EXPECT_FALSE(storage.Get("KEY1", value));
+    EXPECT_TRUE(storage.Delete("KEY2"));
+    EXPECT_FALSE(storage.Delete("KEY2"));
+}
+
+TEST(TinyLFUTest, WindowSpillsIntoMain) {
+    auto main = make_shared<SimpleLRU>(1024);
+    TinyLFU storage(main, 32);
+
+    // Main cache has room, so everything pushed out of the window is admitted
+    for (int i = 0; i < 20; i++) {
+        EXPECT_TRUE(storage.Put("KEY" + to_string(i), "val" + to_string(i)));
+    }
+
+    std::string value;
+    for (int i = 0; i < 20; i++) {
+        EXPECT_TRUE(storage.Get("KEY" + to_string(i), value));
+        EXPECT_EQ("val" + to_string(i), value);
+    }
+    EXPECT_TRUE(main->Get("KEY0", value));
+
+    std::map<std::string, std::string> stats;
+    storage.Stats(stats);
+    EXPECT_EQ("0", stats["tinylfu_rejected"]);
+    EXPECT_NE("0", stats["tinylfu_admitted"]);
+}
+
+TEST(TinyLFUTest, ScanResistance) {
+    // 10 bytes per item: main holds 20 items, window holds 2
+    auto main = make_shared<SimpleLRU>(200);
+    TinyLFU storage(main, 20);
+
+    auto key = [](const char *prefix, int i) {
+        char buf[8];
+        snprintf(buf, sizeof(buf), "%s%03d", prefix, i);
+        return std::string(buf);
+    };
+
+    std::string value;
+    for (int round = 0; round < 5; round++) {
+        for (int i = 0; i < 15; i++) {
+            if (!storage.Get(key("h", i), value)) {
+                storage.Put(key("h", i), "val1");
+            }
+        }
+    }
+
+    for (int i = 0; i < 500; i++) {
+        storage.Put(key("s", i), "val2");
+    }
+
+    for (int i = 0; i < 15; i++) {
+        EXPECT_TRUE(storage.Get(key("h", i), value)) << key("h", i);
+    }
+
+    std::map<std::string, std::string> stats;
+    storage.Stats(stats);
+    EXPECT_NE("0", stats["tinylfu_rejected"]);
+}
+
+TEST(TinyLFUTest, ReadersDontMissKeyMovingIntoMain) {
+    // Main cache has room for everything, so key pushed out of the window is always admitted
+    auto main = make_shared<ThreadSafeSimplLRU>(1 << 20);
+    TinyLFU storage(main, 64);
+    EXPECT_TRUE(storage.Put("KEY", "value"));
+
+    std::atomic<bool> done(false);
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; t++) {
+        readers.emplace_back([&]() {
+            std::string value;
+            std::vector<ValueView> values;
+            std::vector<ValueInfo> infos;
+            while (!done.load()) {
+                ASSERT_TRUE(storage.Get("KEY", value));
+                storage.MultiGetWithInfo({"KEY", "none"}, values, infos);
+                ASSERT_EQ("value", values[0].str());
+                ASSERT_EQ(nullptr, values[1].data());
+            }
+        });
+    }
+
+    for (int i = 0; i < 2000; i++) {
+        EXPECT_TRUE(storage.Put("KEY" + to_string(i), "val"));
+    }
+    done = true;
+    for (auto &t : readers) {
+        t.join();
+    }
+    std::string value;
+    EXPECT_TRUE(main->Get("KEY", value));
+}